@@ -149,6 +149,11 @@ namespace TrenchBroom {
     
     static Func2<GLint, GLuint, const GLchar*>& _glGetUniformLocation = glGetUniformLocation;
     
+    static Func2<void, GLsizei, GLuint*>& _glGenQueries = glGenQueries;
+    static Func2<void, GLenum, GLuint>& _glBeginQuery = glBeginQuery;
+    static Func1<void, GLenum>& _glEndQuery = glEndQuery;
+    static Func3<void, GLuint, GLenum, GLuint*>& _glGetQueryObjectuiv = glGetQueryObjectuiv;
+    
 #ifdef __APPLE__
     static Func2<void, GLenum, GLint>& _glFinishObjectAPPLE = glFinishObjectAPPLE;
 #endif
@@ -222,7 +227,9 @@ namespace TrenchBroom {
         _glTexCoordPointer.bindFunc(&::glTexCoordPointer);
         
         _glDrawArrays.bindFunc(&::glDrawArrays);
-        _glMultiDrawArrays.bindFunc(glMultiDrawArrays);
+        // glMultiDrawArrays is optional, the vertex arrays fall back to one glDrawArrays call per range without it
+        if (glMultiDrawArrays != nullptr)
+            _glMultiDrawArrays.bindFunc(glMultiDrawArrays);
         _glDrawElements.bindFunc(&::glDrawElements);
         _glDrawRangeElements.bindFunc(glDrawRangeElements);
         _glMultiDrawElements.bindFunc(glMultiDrawElements);
@@ -281,6 +288,14 @@ namespace TrenchBroom {
         
         _glGetUniformLocation.bindFunc(glGetUniformLocation);
         
+        // timer queries are optional and only used by the render profiler
+        if (GLEW_VERSION_3_3 || GLEW_ARB_timer_query) {
+            _glGenQueries.bindFunc(glGenQueries);
+            _glBeginQuery.bindFunc(glBeginQuery);
+            _glEndQuery.bindFunc(glEndQuery);
+            _glGetQueryObjectuiv.bindFunc(glGetQueryObjectuiv);
+        }
+        
 #ifdef __APPLE__
         _glFinishObjectAPPLE.bindFunc(glFinishObjectAPPLE);
 #endif
@@ -0,0 +1,48 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "ByteBuffer.h"
+#include "Color.h"
+#include "Assets/Palette.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        TEST(PaletteBenchmark, indexedToRgb) {
+            unsigned char* data = new unsigned char[768];
+            for (size_t i = 0; i < 768; ++i)
+                data[i] = static_cast<unsigned char>((i * 7) % 256);
+            const Palette palette(768, data);
+
+            const size_t pixelCount = 1024 * 1024;
+            Buffer<unsigned char> indexedImage(pixelCount);
+            for (size_t i = 0; i < pixelCount; ++i)
+                indexedImage[i] = static_cast<unsigned char>((i * 13) % 256);
+
+            Buffer<unsigned char> rgbImage(3 * pixelCount);
+            Color averageColor;
+            Benchmark::measure(20, [&]() {
+                palette.indexedToRgb(indexedImage, pixelCount, rgbImage, averageColor);
+            });
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkUtils.h"
+
+namespace TrenchBroom {
+    namespace Benchmark {
+        static String formatMs(const double ms) {
+            StringStream str;
+            str.precision(6);
+            str << std::fixed << ms;
+            return str.str();
+        }
+
+        void recordResult(const Result& result) {
+            const ::testing::TestInfo* testInfo = ::testing::UnitTest::GetInstance()->current_test_info();
+            const String name = String(testInfo->test_case_name()) + "." + testInfo->name();
+
+            ::testing::Test::RecordProperty("iterations", static_cast<int>(result.iterations));
+            ::testing::Test::RecordProperty("total_ms", formatMs(result.totalMs));
+            ::testing::Test::RecordProperty("min_ms", formatMs(result.minMs));
+            ::testing::Test::RecordProperty("mean_ms", formatMs(result.meanMs));
+
+            std::cout << "BENCHMARK\t" << name << "\t" << result.iterations << "\t" << formatMs(result.totalMs) << "\t" << formatMs(result.minMs) << "\t" << formatMs(result.meanMs) << std::endl;
+        }
+
+        static void writeFace(StringStream& str, const long x1, const long y1, const long z1, const long x2, const long y2, const long z2, const long x3, const long y3, const long z3) {
+            str << "( " << x1 << " " << y1 << " " << z1 << " ) ";
+            str << "( " << x2 << " " << y2 << " " << z2 << " ) ";
+            str << "( " << x3 << " " << y3 << " " << z3 << " ) ";
+            str << "benchmark 0 0 0 1 1\n";
+        }
+
+        static void writeCuboid(StringStream& str, const size_t index) {
+            static const long Spacing = 128;
+            static const long Size = 64;
+            static const long GridSize = 64;
+            static const long Offset = -Spacing * GridSize / 2;
+
+            const long i = static_cast<long>(index);
+            const long x0 = Offset + Spacing * (i % GridSize);
+            const long y0 = Offset + Spacing * ((i / GridSize) % GridSize);
+            const long z0 = Offset + Spacing * (i / (GridSize * GridSize));
+            const long x1 = x0 + Size;
+            const long y1 = y0 + Size;
+            const long z1 = z0 + Size;
+
+            str << "{\n";
+            writeFace(str, x0, y0, z0, x0, y0 + 1, z0, x0, y0, z0 + 1);
+            writeFace(str, x1, y1, z1, x1, y1, z1 + 1, x1, y1 + 1, z1);
+            writeFace(str, x0, y0, z0, x0, y0, z0 + 1, x0 + 1, y0, z0);
+            writeFace(str, x1, y1, z1, x1 + 1, y1, z1, x1, y1, z1 + 1);
+            writeFace(str, x1, y1, z1, x1, y1 + 1, z1, x1 + 1, y1, z1);
+            writeFace(str, x0, y0, z0, x0 + 1, y0, z0, x0, y0 + 1, z0);
+            str << "}\n";
+        }
+
+        String createSyntheticMap(const size_t entityCount, const size_t brushesPerEntity) {
+            StringStream str;
+            size_t brushIndex = 0;
+            for (size_t i = 0; i < entityCount; ++i) {
+                str << "{\n";
+                if (i == 0) {
+                    str << "\"classname\" \"worldspawn\"\n";
+                } else {
+                    str << "\"classname\" \"func_detail\"\n";
+                    str << "\"targetname\" \"detail" << i << "\"\n";
+                }
+                for (size_t j = 0; j < brushesPerEntity; ++j)
+                    writeCuboid(str, brushIndex++);
+                str << "}\n";
+            }
+            return str.str();
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_BenchmarkUtils_h
+#define TrenchBroom_BenchmarkUtils_h
+
+#include "StringUtils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+
+namespace TrenchBroom {
+    namespace Benchmark {
+        struct Result {
+            size_t iterations;
+            double totalMs;
+            double minMs;
+            double meanMs;
+        };
+
+        void recordResult(const Result& result);
+
+        /**
+         * Runs the given function once to warm up and then the given number of times while measuring it. The
+         * result is recorded as properties of the current test, so that it is included in the report written when
+         * passing --gtest_output=xml:<file>. It is also printed to stdout as a tab separated line starting with
+         * BENCHMARK, followed by the test name, the number of iterations and the total, minimum and mean time in
+         * milliseconds.
+         */
+        template <typename F>
+        Result measure(const size_t iterations, F func) {
+            typedef std::chrono::high_resolution_clock Clock;
+
+            func();
+
+            Result result;
+            result.iterations = iterations;
+            result.totalMs = 0.0;
+            result.minMs = std::numeric_limits<double>::max();
+
+            for (size_t i = 0; i < iterations; ++i) {
+                const Clock::time_point start = Clock::now();
+                func();
+                const Clock::time_point end = Clock::now();
+
+                const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+                result.totalMs += ms;
+                result.minMs = std::min(result.minMs, ms);
+            }
+
+            result.meanMs = result.totalMs / static_cast<double>(iterations);
+            recordResult(result);
+            return result;
+        }
+
+        /**
+         * Returns the source of a map in the standard format that contains the given number of entities, each of
+         * which contains the given number of brushes. The brushes are cuboids laid out on a regular grid so that
+         * they do not overlap.
+         */
+        String createSyntheticMap(size_t entityCount, size_t brushesPerEntity);
+    }
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "IO/NodeWriter.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(NodeWriterBenchmark, writeSyntheticMap) {
+            const String data = Benchmark::createSyntheticMap(50, 100);
+            const BBox3 worldBounds(8192.0);
+            SimpleParserStatus status(nullptr);
+
+            WorldReader reader(data, nullptr);
+            Model::World* world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+
+            size_t length = 0;
+            Benchmark::measure(10, [&]() {
+                StringStream str;
+                NodeWriter writer(world, str);
+                writer.writeMap();
+                length = str.str().size();
+            });
+            ASSERT_GT(length, data.size() / 2);
+
+            delete world;
+        }
+    }
+}
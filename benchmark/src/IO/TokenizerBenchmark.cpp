@@ -0,0 +1,41 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "IO/StandardMapParser.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(TokenizerBenchmark, tokenizeSyntheticMap) {
+            const String data = Benchmark::createSyntheticMap(50, 100);
+
+            size_t tokenCount = 0;
+            Benchmark::measure(10, [&]() {
+                QuakeMapTokenizer tokenizer(data);
+                tokenCount = 0;
+                while (tokenizer.nextToken().type() != QuakeMapToken::Eof)
+                    ++tokenCount;
+            });
+            ASSERT_GT(tokenCount, 5000u * 6u * 9u);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "IO/DiskIO.h"
+#include "IO/MappedFile.h"
+#include "IO/Path.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        static size_t readWorld(const char* begin, const char* end) {
+            const BBox3 worldBounds(8192.0);
+            SimpleParserStatus status(nullptr);
+
+            WorldReader reader(begin, end, nullptr);
+            Model::World* world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            const size_t childCount = world->defaultLayer()->childCount();
+            delete world;
+            return childCount;
+        }
+
+        TEST(WorldReaderBenchmark, readSyntheticMap) {
+            const String data = Benchmark::createSyntheticMap(50, 100);
+
+            size_t childCount = 0;
+            Benchmark::measure(5, [&]() {
+                childCount = readWorld(data.c_str(), data.c_str() + data.size());
+            });
+            ASSERT_EQ(100u + 49u, childCount);
+        }
+
+        TEST(WorldReaderBenchmark, readBundledMaps) {
+            const Path basePath = Disk::getCurrentWorkingDir() + Path("data");
+            const Path::List mapPaths = Disk::findItemsRecursively(basePath, [] (const Path& path, bool directory) {
+                return !directory && StringUtils::caseInsensitiveEqual(path.extension(), "map");
+            });
+            ASSERT_FALSE(mapPaths.empty());
+
+            std::vector<MappedFile::Ptr> files;
+            for (const Path& path : mapPaths)
+                files.push_back(Disk::openFile(path));
+
+            Benchmark::measure(100, [&]() {
+                for (MappedFile::Ptr file : files)
+                    readWorld(file->begin(), file->end());
+            });
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static const size_t BrushCount = 1000;
+
+        static BrushList createBrushes(const BrushBuilder& builder) {
+            BrushList result;
+            result.reserve(BrushCount);
+            for (size_t i = 0; i < BrushCount; ++i) {
+                const Vec3 min(static_cast<FloatType>(i % 32) * 128.0 - 2048.0, static_cast<FloatType>(i / 32) * 128.0 - 2048.0, 0.0);
+                result.push_back(builder.createCuboid(BBox3(min, min + Vec3(64.0, 64.0, 64.0 + static_cast<FloatType>(i % 7))), "texture"));
+            }
+            return result;
+        }
+
+        TEST(BrushBenchmark, createCuboids) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                BrushList brushes = createBrushes(builder);
+                VectorUtils::clearAndDelete(brushes);
+            });
+        }
+
+        TEST(BrushBenchmark, createFromPoints) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+
+            const Vec3::List points {
+                Vec3(-64.0, -32.0, -16.0), Vec3( 64.0, -32.0, -16.0), Vec3(-64.0,  32.0, -16.0), Vec3( 64.0,  32.0, -16.0),
+                Vec3(-48.0, -24.0,  16.0), Vec3( 48.0, -24.0,  16.0), Vec3(-48.0,  24.0,  16.0), Vec3( 48.0,  24.0,  16.0),
+                Vec3(  0.0,   0.0,  40.0), Vec3(  0.0,   0.0, -40.0), Vec3( 72.0,   0.0,   0.0), Vec3(-72.0,   0.0,   0.0)
+            };
+
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                for (size_t i = 0; i < BrushCount; ++i)
+                    delete builder.createBrush(points, "texture");
+            });
+        }
+
+        TEST(BrushBenchmark, rebuildGeometry) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            BrushList brushes = createBrushes(builder);
+
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                for (Brush* brush : brushes)
+                    brush->rebuildGeometry(worldBounds);
+            });
+
+            VectorUtils::clearAndDelete(brushes);
+        }
+
+        TEST(BrushBenchmark, moveVertices) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            BrushList brushes = createBrushes(builder);
+
+            // move the top vertices up and down again so that the brushes are the same after every iteration
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                for (Brush* brush : brushes) {
+                    const Vec3 vertex = brush->bounds().max;
+                    const Vec3::List newVertices = brush->moveVertices(worldBounds, Vec3::List(1, vertex), Vec3(0.0, 0.0, 16.0));
+                    brush->moveVertices(worldBounds, newVertices, Vec3(0.0, 0.0, -16.0));
+                }
+            });
+
+            VectorUtils::clearAndDelete(brushes);
+        }
+    }
+}
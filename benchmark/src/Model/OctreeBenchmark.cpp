@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Model/Octree.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        typedef Octree<FloatType, size_t> BenchmarkOctree;
+
+        static const size_t ObjectCount = 20000;
+
+        static std::vector<BBox3> createBounds(const FloatType offset) {
+            std::vector<BBox3> result;
+            result.reserve(ObjectCount);
+            for (size_t i = 0; i < ObjectCount; ++i) {
+                const Vec3 min(static_cast<FloatType>(i % 64) * 96.0 - 3072.0 + offset,
+                               static_cast<FloatType>((i / 64) % 64) * 96.0 - 3072.0,
+                               static_cast<FloatType>(i / 4096) * 96.0 - 3072.0);
+                const Vec3 size(static_cast<FloatType>(16 + i % 48), static_cast<FloatType>(16 + i % 32), 32.0);
+                result.push_back(BBox3(min, min + size));
+            }
+            return result;
+        }
+
+        static void addObjects(BenchmarkOctree& octree, const std::vector<BBox3>& bounds) {
+            for (size_t i = 0; i < bounds.size(); ++i)
+                octree.addObject(bounds[i], i);
+        }
+
+        TEST(OctreeBenchmark, insert) {
+            const std::vector<BBox3> bounds = createBounds(0.0);
+
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                BenchmarkOctree octree(BBox3(8192.0), 64.0);
+                addObjects(octree, bounds);
+            });
+        }
+
+        TEST(OctreeBenchmark, update) {
+            const std::vector<BBox3> bounds = createBounds(0.0);
+            const std::vector<BBox3> movedBounds = createBounds(40.0);
+
+            BenchmarkOctree octree(BBox3(8192.0), 64.0);
+            addObjects(octree, bounds);
+
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                for (size_t i = 0; i < ObjectCount; ++i)
+                    octree.updateObject(movedBounds[i], i);
+                for (size_t i = 0; i < ObjectCount; ++i)
+                    octree.updateObject(bounds[i], i);
+            });
+        }
+
+        TEST(OctreeBenchmark, queryRays) {
+            const std::vector<BBox3> bounds = createBounds(0.0);
+            BenchmarkOctree octree(BBox3(8192.0), 64.0);
+            addObjects(octree, bounds);
+
+            std::vector<Ray3> rays;
+            for (size_t i = 0; i < 1000; ++i) {
+                const FloatType f = static_cast<FloatType>(i);
+                rays.push_back(Ray3(Vec3(-4096.0, f * 6.0 - 3000.0, f * 5.0 - 2500.0), Vec3(1.0, 0.1, 0.05).normalized()));
+            }
+
+            size_t candidates = 0;
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                candidates = 0;
+                for (const Ray3& ray : rays)
+                    candidates += octree.findObjects(ray).size();
+            });
+            ASSERT_GT(candidates, 0u);
+        }
+
+        TEST(OctreeBenchmark, queryBounds) {
+            const std::vector<BBox3> bounds = createBounds(0.0);
+            BenchmarkOctree octree(BBox3(8192.0), 64.0);
+            addObjects(octree, bounds);
+
+            size_t candidates = 0;
+            TrenchBroom::Benchmark::measure(10, [&]() {
+                candidates = 0;
+                for (size_t i = 0; i < 1000; ++i)
+                    candidates += octree.findObjects(bounds[i * 20].expanded(128.0)).size();
+            });
+            ASSERT_GT(candidates, 0u);
+        }
+    }
+}
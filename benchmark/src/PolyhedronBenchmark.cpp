@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "MathUtils.h"
+#include "Polyhedron.h"
+#include "Polyhedron_DefaultPayload.h"
+
+#include <cmath>
+
+typedef Polyhedron<double, DefaultPolyhedronPayload, DefaultPolyhedronPayload> Polyhedron3d;
+
+// Returns points that are evenly distributed on a sphere with the given radius.
+static Vec3d::List spherePoints(const size_t count, const double radius) {
+    const double goldenAngle = Math::Cd::pi() * (3.0 - std::sqrt(5.0));
+
+    Vec3d::List result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const double z = 1.0 - 2.0 * (static_cast<double>(i) + 0.5) / static_cast<double>(count);
+        const double r = std::sqrt(1.0 - z * z);
+        const double angle = goldenAngle * static_cast<double>(i);
+        result.push_back(radius * Vec3d(r * std::cos(angle), r * std::sin(angle), z));
+    }
+    return result;
+}
+
+TEST(PolyhedronBenchmark, convexHull) {
+    const Vec3d::List points = spherePoints(64, 512.0);
+
+    size_t vertexCount = 0;
+    TrenchBroom::Benchmark::measure(20, [&]() {
+        const Polyhedron3d polyhedron(points);
+        vertexCount = polyhedron.vertexCount();
+    });
+    ASSERT_EQ(points.size(), vertexCount);
+}
+
+TEST(PolyhedronBenchmark, clip) {
+    const Polyhedron3d cube(BBox3d(512.0));
+    const Vec3d::List normals = spherePoints(64, 1.0);
+
+    size_t faceCount = 0;
+    TrenchBroom::Benchmark::measure(100, [&]() {
+        Polyhedron3d polyhedron(cube);
+        for (const Vec3d& normal : normals)
+            polyhedron.clip(Plane3d(500.0, normal));
+        faceCount = polyhedron.faceCount();
+    });
+    ASSERT_GT(faceCount, 6u);
+}
+
+// Clips like the clip benchmark, but repairs the polyhedron like a brush does when it builds its geometry. The
+// difference to the clip benchmark is the cost of the repairs.
+TEST(PolyhedronBenchmark, clipAndRepair) {
+    const Polyhedron3d cube(BBox3d(512.0));
+    const Vec3d::List normals = spherePoints(64, 1.0);
+
+    size_t faceCount = 0;
+    TrenchBroom::Benchmark::measure(100, [&]() {
+        Polyhedron3d polyhedron(cube);
+        for (const Vec3d& normal : normals) {
+            polyhedron.clip(Plane3d(500.0, normal));
+            polyhedron.healEdges();
+        }
+        polyhedron.correctVertexPositions();
+        polyhedron.healEdges();
+        faceCount = polyhedron.faceCount();
+    });
+    ASSERT_GT(faceCount, 6u);
+}
+
+TEST(PolyhedronBenchmark, subtract) {
+    const Polyhedron3d minuend(BBox3d(512.0));
+
+    std::vector<Polyhedron3d> subtrahends;
+    for (const Vec3d& center : spherePoints(16, 512.0))
+        subtrahends.push_back(Polyhedron3d(BBox3d(center - Vec3d(128.0, 128.0, 128.0), center + Vec3d(128.0, 128.0, 128.0))));
+
+    size_t fragmentCount = 0;
+    TrenchBroom::Benchmark::measure(20, [&]() {
+        fragmentCount = 0;
+        for (const Polyhedron3d& subtrahend : subtrahends)
+            fragmentCount += minuend.subtract(subtrahend).size();
+    });
+    ASSERT_GT(fragmentCount, 0u);
+}
+
+TEST(PolyhedronBenchmark, intersects) {
+    std::vector<Polyhedron3d> polyhedra;
+    for (const Vec3d& center : spherePoints(64, 512.0))
+        polyhedra.push_back(Polyhedron3d(BBox3d(center - Vec3d(96.0, 96.0, 96.0), center + Vec3d(96.0, 96.0, 96.0))));
+
+    size_t intersectionCount = 0;
+    TrenchBroom::Benchmark::measure(20, [&]() {
+        intersectionCount = 0;
+        for (const Polyhedron3d& lhs : polyhedra) {
+            for (const Polyhedron3d& rhs : polyhedra) {
+                if (lhs.intersects(rhs))
+                    ++intersectionCount;
+            }
+        }
+    });
+    ASSERT_GE(intersectionCount, polyhedra.size());
+}
+
+TEST(PolyhedronBenchmark, intersectsRoundPolyhedra) {
+    const Vec3d::List hullPoints = spherePoints(32, 128.0);
+
+    std::vector<Polyhedron3d> polyhedra;
+    for (const Vec3d& center : spherePoints(32, 512.0)) {
+        Vec3d::List points;
+        for (const Vec3d& point : hullPoints)
+            points.push_back(center + point);
+        polyhedra.push_back(Polyhedron3d(points));
+    }
+
+    size_t intersectionCount = 0;
+    TrenchBroom::Benchmark::measure(20, [&]() {
+        intersectionCount = 0;
+        for (const Polyhedron3d& lhs : polyhedra) {
+            for (const Polyhedron3d& rhs : polyhedra) {
+                if (lhs.intersects(rhs))
+                    ++intersectionCount;
+            }
+        }
+    });
+    ASSERT_GE(intersectionCount, polyhedra.size());
+}
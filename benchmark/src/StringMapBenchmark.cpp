@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "StringMap.h"
+#include "StringUtils.h"
+
+namespace TrenchBroom {
+    typedef StringMap<String, StringMultiMapValueContainer<String> > BenchmarkMultiMap;
+
+    static StringList createKeys() {
+        static const String Prefixes[] = { "light", "func_door", "func_wall", "trigger_once", "info_player", "monster_army", "weapon_rocket", "item_health" };
+
+        StringList result;
+        for (const String& prefix : Prefixes) {
+            for (size_t i = 0; i < 2000; ++i) {
+                StringStream str;
+                str << prefix << i;
+                result.push_back(str.str());
+            }
+        }
+        return result;
+    }
+
+    TEST(StringMapBenchmark, insert) {
+        const StringList keys = createKeys();
+
+        Benchmark::measure(10, [&]() {
+            BenchmarkMultiMap index;
+            for (const String& key : keys)
+                index.insert(key, key);
+        });
+    }
+
+    TEST(StringMapBenchmark, queryPrefixMatches) {
+        const StringList keys = createKeys();
+        BenchmarkMultiMap index;
+        for (const String& key : keys)
+            index.insert(key, key);
+
+        size_t matchCount = 0;
+        Benchmark::measure(10, [&]() {
+            matchCount = 0;
+            for (size_t i = 0; i < keys.size(); i += 16)
+                matchCount += index.queryPrefixMatches(keys[i].substr(0, keys[i].size() - 1)).size();
+        });
+        ASSERT_GT(matchCount, 0u);
+    }
+
+    TEST(StringMapBenchmark, queryNumberedMatches) {
+        const StringList keys = createKeys();
+        BenchmarkMultiMap index;
+        for (const String& key : keys)
+            index.insert(key, key);
+
+        size_t matchCount = 0;
+        Benchmark::measure(10, [&]() {
+            matchCount = 0;
+            matchCount += index.queryNumberedMatches("light").size();
+            matchCount += index.queryNumberedMatches("func_door").size();
+            matchCount += index.queryNumberedMatches("monster_army").size();
+        });
+        ASSERT_EQ(3u * 2000u, matchCount);
+    }
+}
@@ -0,0 +1,46 @@
+SET(BENCHMARK_SOURCE_DIR "${CMAKE_SOURCE_DIR}/benchmark/src")
+
+FILE(GLOB_RECURSE BENCHMARK_SOURCE
+    "${BENCHMARK_SOURCE_DIR}/*.h"
+    "${BENCHMARK_SOURCE_DIR}/*.cpp"
+)
+
+# The benchmarks don't use OpenGL either, so they share the stub with the tests
+SET(BENCHMARK_SOURCE ${BENCHMARK_SOURCE} "${CMAKE_SOURCE_DIR}/test/src/GLInit.cpp")
+
+ADD_EXECUTABLE(TrenchBroom-Benchmark ${BENCHMARK_SOURCE} $<TARGET_OBJECTS:common>)
+
+IF(COMPILER_IS_GNU AND TB_ENABLE_ASAN)
+    TARGET_LINK_LIBRARIES(TrenchBroom-Benchmark asan)
+ENDIF()
+
+ADD_TARGET_PROPERTY(TrenchBroom-Benchmark INCLUDE_DIRECTORIES "${BENCHMARK_SOURCE_DIR}")
+TARGET_LINK_LIBRARIES(TrenchBroom-Benchmark gtest gmock ${wxWidgets_LIBRARIES} ${FREETYPE_LIBRARIES} ${FREEIMAGE_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
+IF (COMPILER_IS_MSVC)
+    TARGET_LINK_LIBRARIES(TrenchBroom-Benchmark stackwalker)
+ENDIF()
+
+SET(BENCHMARK_RESOURCE_DEST_DIR "$<TARGET_FILE_DIR:TrenchBroom-Benchmark>")
+
+IF(WIN32)
+	SET(BENCHMARK_RESOURCE_DEST_DIR "${BENCHMARK_RESOURCE_DEST_DIR}/..")
+
+	# Copy some Windows-specific resources
+	ADD_CUSTOM_COMMAND(TARGET TrenchBroom-Benchmark POST_BUILD
+		COMMAND ${CMAKE_COMMAND} -E copy_directory "${LIB_BIN_DIR}/win32" "${BENCHMARK_RESOURCE_DEST_DIR}"
+	)
+ENDIF()
+
+# Copy the maps used by the benchmarks
+ADD_CUSTOM_COMMAND(TARGET TrenchBroom-Benchmark POST_BUILD
+	COMMAND ${CMAKE_COMMAND} -E copy_directory "${CMAKE_SOURCE_DIR}/test/data" "${BENCHMARK_RESOURCE_DEST_DIR}/data"
+)
+
+# Run the benchmarks and write the results to benchmark.xml, the timings are recorded as properties of each test case
+ADD_CUSTOM_TARGET(benchmark
+	COMMAND $<TARGET_FILE:TrenchBroom-Benchmark> --gtest_output=xml:${CMAKE_BINARY_DIR}/benchmark.xml
+	WORKING_DIRECTORY "${BENCHMARK_RESOURCE_DEST_DIR}"
+	DEPENDS TrenchBroom-Benchmark
+)
+
+SET_XCODE_ATTRIBUTES(TrenchBroom-Benchmark)
@@ -23,7 +23,7 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
-#include <stack>
+#include <mutex>
 #include <vector>
 
 // Undefine this to prevent false positives when looking for memory leaks.
@@ -90,12 +90,6 @@ private:
     };
     
     typedef std::vector<Chunk*> ChunkList;
-    typedef std::stack<T*> Pool;
-    
-    static Pool& pool() {
-        static Pool p;
-        return p;
-    }
     
     static ChunkList& fullChunks() {
         static ChunkList chunks;
@@ -107,21 +101,69 @@ private:
         return chunks;
     }
     
-    static ChunkList emptyChunks() {
+    static ChunkList& emptyChunks() {
         static ChunkList chunks;
         return chunks;
     }
-public:
-#ifdef TB_ENABLE_ALLOCATOR
-    void* operator new(size_t size) {
-        assert(size == sizeof(T));
+
+    // The chunks are shared by all threads, so access to them must be serialized.
+    static std::mutex& mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    /*
+     Every thread keeps its own pool of free blocks, so that polyhedra can be built and copied on worker threads
+     without locking the chunks for every allocation. An empty pool is refilled with several blocks at once, and the
+     blocks that are left in the pool of a thread are returned to the chunks when the thread exits.
+     */
+    class Pool {
+    private:
+        std::vector<T*> m_blocks;
+    public:
+        ~Pool() {
+            poolDestroyed() = true;
+            std::lock_guard<std::mutex> lock(mutex());
+            for (T* t : m_blocks)
+                deallocateBlock(t);
+        }
         
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
+        bool empty() const {
+            return m_blocks.empty();
+        }
+        
+        size_t size() const {
+            return m_blocks.size();
         }
         
+        void push(T* t) {
+            m_blocks.push_back(t);
+        }
+        
+        T* pop() {
+            assert(!m_blocks.empty());
+            T* t = m_blocks.back();
+            m_blocks.pop_back();
+            return t;
+        }
+    };
+    
+    static Pool& pool() {
+        static thread_local Pool p;
+        return p;
+    }
+    
+    // Blocks may be deleted after the pool of the current thread has been destroyed, e.g. by static destructors.
+    static bool& poolDestroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+    
+    static bool usePool() {
+        return PoolSize > 0 && !poolDestroyed();
+    }
+    
+    static T* allocateBlock() {
         Chunk* chunk = nullptr;
         if (mixedChunks().empty()) {
             if (!emptyChunks().empty()) {
@@ -140,19 +182,12 @@ public:
         
         if (chunk->full())
             fullChunks().push_back(chunk);
-            else
-                mixedChunks().push_back(chunk);
-                return block;
+        else
+            mixedChunks().push_back(chunk);
+        return block;
     }
     
-    void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
-        
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
-            return;
-        }
-        
+    static void deallocateBlock(T* t) {
         typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
         fullIt = fullChunks().rbegin();
         fullEnd = fullChunks().rend();
@@ -184,6 +219,7 @@ public:
         if (chunk->full()) {
             fullChunks().erase((fullIt + 1).base());
             mixedChunks().push_back(chunk);
+            mixedIt = mixedChunks().rbegin();
         }
         
         chunk->deallocate(t);
@@ -192,9 +228,43 @@ public:
             mixedChunks().erase((mixedIt + 1).base());
             if (emptyChunks().size() < 2)
                 emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
+            else
+                delete chunk;
+        }
+    }
+public:
+#ifdef TB_ENABLE_ALLOCATOR
+    void* operator new(size_t size) {
+        assert(size == sizeof(T));
+        
+        if (!usePool()) {
+            std::lock_guard<std::mutex> lock(mutex());
+            return allocateBlock();
+        }
+        
+        Pool& p = pool();
+        if (p.empty()) {
+            static const size_t RefillCount = (PoolSize + 1) / 2;
+            std::lock_guard<std::mutex> lock(mutex());
+            for (size_t i = 0; i < RefillCount; ++i)
+                p.push(allocateBlock());
+        }
+        return p.pop();
+    }
+    
+    void operator delete(void* block) {
+        T* t = reinterpret_cast<T*>(block);
+        
+        if (usePool()) {
+            Pool& p = pool();
+            if (p.size() < PoolSize) {
+                p.push(t);
+                return;
+            }
         }
+        
+        std::lock_guard<std::mutex> lock(mutex());
+        deallocateBlock(t);
     }
 #endif
 };
@@ -86,14 +86,17 @@ namespace TrenchBroom {
         };
 
         const FlagsAttributeDefinition* EntityDefinition::spawnflags() const {
+            loadAttributeDefinitions();
             return static_cast<FlagsAttributeDefinition*>(VectorUtils::findIf(m_attributeDefinitions, FindSpawnflagsDefinition()).get());
         }
         
         const AttributeDefinitionList& EntityDefinition::attributeDefinitions() const {
+            loadAttributeDefinitions();
             return m_attributeDefinitions;
         }
 
         const AttributeDefinition* EntityDefinition::attributeDefinition(const Model::AttributeName& attributeKey) const {
+            loadAttributeDefinitions();
             const auto it = std::find_if(std::begin(m_attributeDefinitions), std::end(m_attributeDefinitions),
                                          [attributeKey] (const AttributeDefinitionPtr& attributeDefinition) { return attributeDefinition->name() == attributeKey; });
             if (it == std::end(m_attributeDefinitions))
@@ -152,11 +155,34 @@ namespace TrenchBroom {
         m_usageCount(0),
         m_attributeDefinitions(attributeDefinitions) {}
 
+        EntityDefinition::EntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionLoader& attributeDefinitionLoader) :
+        m_index(0),
+        m_name(name),
+        m_color(color),
+        m_description(description),
+        m_usageCount(0),
+        m_attributeDefinitionLoader(attributeDefinitionLoader) {}
+
+        void EntityDefinition::loadAttributeDefinitions() const {
+            // the definitions can be requested from several threads at once
+            std::call_once(m_attributeDefinitionsLoaded, [this]() {
+                if (m_attributeDefinitionLoader) {
+                    m_attributeDefinitions = m_attributeDefinitionLoader();
+                    m_attributeDefinitionLoader = nullptr;
+                }
+            });
+        }
+
         PointEntityDefinition::PointEntityDefinition(const String& name, const Color& color, const BBox3& bounds, const String& description, const AttributeDefinitionList& attributeDefinitions, const ModelDefinition& modelDefinition) :
         EntityDefinition(name, color, description, attributeDefinitions),
         m_bounds(bounds),
         m_modelDefinition(modelDefinition) {}
         
+        PointEntityDefinition::PointEntityDefinition(const String& name, const Color& color, const BBox3& bounds, const String& description, const AttributeDefinitionLoader& attributeDefinitionLoader, const ModelDefinition& modelDefinition) :
+        EntityDefinition(name, color, description, attributeDefinitionLoader),
+        m_bounds(bounds),
+        m_modelDefinition(modelDefinition) {}
+        
         EntityDefinition::Type PointEntityDefinition::type() const {
             return Type_PointEntity;
         }
@@ -180,6 +206,9 @@ namespace TrenchBroom {
         BrushEntityDefinition::BrushEntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionList& attributeDefinitions) :
         EntityDefinition(name, color, description, attributeDefinitions) {}
         
+        BrushEntityDefinition::BrushEntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionLoader& attributeDefinitionLoader) :
+        EntityDefinition(name, color, description, attributeDefinitionLoader) {}
+        
         EntityDefinition::Type BrushEntityDefinition::type() const {
             return Type_BrushEntity;
         }
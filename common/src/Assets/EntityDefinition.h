@@ -28,6 +28,9 @@
 #include "Assets/AssetTypes.h"
 #include "Assets/ModelDefinition.h"
 
+#include <functional>
+#include <mutex>
+
 namespace TrenchBroom {
     namespace Assets {
         class AttributeDefinition;
@@ -35,6 +38,11 @@ namespace TrenchBroom {
         class FlagsAttributeOption;
         class ModelDefinition;
         
+        /**
+         * Creates the attribute definitions of an entity definition when they are first requested.
+         */
+        typedef std::function<AttributeDefinitionList()> AttributeDefinitionLoader;
+        
         class EntityDefinition {
         public:
             enum SortOrder {
@@ -52,7 +60,9 @@ namespace TrenchBroom {
             Color m_color;
             String m_description;
             size_t m_usageCount;
-            AttributeDefinitionList m_attributeDefinitions;
+            mutable AttributeDefinitionList m_attributeDefinitions;
+            mutable AttributeDefinitionLoader m_attributeDefinitionLoader;
+            mutable std::once_flag m_attributeDefinitionsLoaded;
         public:
             Notifier0 usageCountDidChangeNotifier;
         public:
@@ -82,6 +92,9 @@ namespace TrenchBroom {
             static EntityDefinitionList filterAndSort(const EntityDefinitionList& definitions, EntityDefinition::Type type, SortOrder prder = Name);
         protected:
             EntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionList& attributeDefinitions);
+            EntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionLoader& attributeDefinitionLoader);
+        private:
+            void loadAttributeDefinitions() const;
         };
         
         class PointEntityDefinition : public EntityDefinition {
@@ -90,6 +103,7 @@ namespace TrenchBroom {
             ModelDefinition m_modelDefinition;
         public:
             PointEntityDefinition(const String& name, const Color& color, const BBox3& bounds, const String& description, const AttributeDefinitionList& attributeDefinitions, const ModelDefinition& modelDefinition);
+            PointEntityDefinition(const String& name, const Color& color, const BBox3& bounds, const String& description, const AttributeDefinitionLoader& attributeDefinitionLoader, const ModelDefinition& modelDefinition);
             
             Type type() const;
             const BBox3& bounds() const;
@@ -101,6 +115,7 @@ namespace TrenchBroom {
         class BrushEntityDefinition : public EntityDefinition {
         public:
             BrushEntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionList& attributeDefinitions);
+            BrushEntityDefinition(const String& name, const Color& color, const String& description, const AttributeDefinitionLoader& attributeDefinitionLoader);
             Type type() const;
         };
     }
@@ -96,6 +96,10 @@ namespace TrenchBroom {
             m_expression = EL::SwitchOperator::create(cases, line, column);
         }
 
+        const EL::Expression& ModelDefinition::expression() const {
+            return m_expression;
+        }
+
         ModelSpecification ModelDefinition::modelSpecification(const Model::EntityAttributes& attributes) const {
             const Model::EntityAttributesVariableStore store(attributes);
             const EL::EvaluationContext context(store);
@@ -20,6 +20,7 @@
 #include "Texture.h"
 #include "Assets/ImageUtils.h"
 #include "Assets/TextureCollection.h"
+#include "Renderer/RenderProfiler.h"
 
 #include <cassert>
 
@@ -182,6 +183,7 @@ namespace TrenchBroom {
         void Texture::activate() const {
             assert(isPrepared());
             glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+            Renderer::RenderProfiler::instance().countTextureBind();
         }
         
         void Texture::deactivate() const {
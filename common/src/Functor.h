@@ -135,6 +135,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()() {
             ensure(m_func != nullptr, "func is null");
@@ -251,6 +255,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1) {
             ensure(m_func != nullptr, "func is null");
@@ -367,6 +375,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2) {
             ensure(m_func != nullptr, "func is null");
@@ -483,6 +495,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3) {
             ensure(m_func != nullptr, "func is null");
@@ -599,6 +615,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3, A4 a4) {
             ensure(m_func != nullptr, "func is null");
@@ -715,6 +735,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5) {
             ensure(m_func != nullptr, "func is null");
@@ -831,6 +855,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6) {
             ensure(m_func != nullptr, "func is null");
@@ -947,6 +975,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7) {
             ensure(m_func != nullptr, "func is null");
@@ -1063,6 +1095,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8) {
             ensure(m_func != nullptr, "func is null");
@@ -1179,6 +1215,10 @@ namespace TrenchBroom {
             delete m_func;
             m_func = 0;
         }
+
+        bool bound() const {
+            return m_func != nullptr;
+        }
         
         R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9) {
             ensure(m_func != nullptr, "func is null");
@@ -24,12 +24,19 @@
 #include <wx/filename.h>
 
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <stdlib.h>
+#include <sys/stat.h>
+#endif
 
 namespace TrenchBroom {
     namespace IO {
         namespace Disk {
             bool doCheckCaseSensitive();
-            Path findCaseSensitivePath(const Path::List& list, const Path& path);
             Path fixCase(const Path& path);
             
             bool doCheckCaseSensitive() {
@@ -43,12 +50,149 @@ namespace TrenchBroom {
                 return caseSensitive;
             }
             
-            Path findCaseSensitivePath(const Path::List& list, const Path& path) {
-                for (const Path& entry : list) {
-                    if (StringUtils::caseInsensitiveEqual(entry.asString(), path.asString()))
-                        return entry;
+            /**
+             * Caches the contents of directories together with an index from the lower case names of their entries
+             * to the actual names. A cached directory is read again when its modification time or its file ID
+             * changes, and when it is invalidated, which the functions in this file do for every directory they
+             * modify.
+             */
+            class DirectoryCache {
+            private:
+                struct Stamp {
+                    uint64_t id;
+                    int64_t seconds;
+                    int64_t nanoseconds;
+                    
+                    bool operator==(const Stamp& other) const {
+                        return id == other.id && seconds == other.seconds && nanoseconds == other.nanoseconds;
+                    }
+                };
+                
+                struct Entry {
+                    Stamp stamp;
+                    Path::List contents;
+                    std::unordered_set<String> names;
+                    std::unordered_map<String, String> lowerCaseNames;
+                };
+                
+                typedef std::unordered_map<String, Entry> EntryMap;
+                
+                std::mutex m_mutex;
+                EntryMap m_entries;
+            public:
+                Path::List contents(const Path& directory) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const Entry* entry = findEntry(directory);
+                    if (entry == nullptr)
+                        throw FileSystemException("Cannot open directory: '" + directory.asString() + "'");
+                    return entry->contents;
                 }
-                return Path("");
+                
+                /**
+                 * Returns the actual name of the entry of the given directory that matches the given name, ignoring
+                 * case unless there is an entry with exactly the given name. Returns an empty path if there is no
+                 * such entry or if the given directory cannot be read.
+                 */
+                Path findName(const Path& directory, const String& name) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const Entry* entry = findEntry(directory);
+                    if (entry == nullptr)
+                        return Path("");
+                    if (entry->names.count(name) > 0)
+                        return Path(name);
+                    
+                    const auto it = entry->lowerCaseNames.find(StringUtils::toLower(name));
+                    if (it == std::end(entry->lowerCaseNames))
+                        return Path("");
+                    return Path(it->second);
+                }
+                
+                void invalidate(const Path& directory) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_entries.erase(directory.asString());
+                }
+                
+                void clear() {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_entries.clear();
+                }
+            private:
+                const Entry* findEntry(const Path& directory) {
+                    const String key = directory.asString();
+                    
+                    Stamp stamp;
+                    if (!getStamp(key, stamp)) {
+                        m_entries.erase(key);
+                        return nullptr;
+                    }
+                    
+                    const auto it = m_entries.find(key);
+                    if (it != std::end(m_entries) && it->second.stamp == stamp)
+                        return &it->second;
+                    
+                    Entry entry;
+                    entry.stamp = stamp;
+                    if (!readDirectory(key, entry))
+                        return nullptr;
+                    
+                    Entry& result = m_entries[key];
+                    result = std::move(entry);
+                    return &result;
+                }
+                
+                static bool readDirectory(const String& directory, Entry& entry) {
+                    wxDir dir(directory);
+                    if (!dir.IsOpened())
+                        return false;
+                    
+                    wxString filename;
+                    bool more = dir.GetFirst(&filename);
+                    while (more) {
+                        const String name = filename.ToStdString();
+                        entry.contents.push_back(Path(name));
+                        entry.names.insert(name);
+                        entry.lowerCaseNames.insert(std::make_pair(StringUtils::toLower(name), name));
+                        more = dir.GetNext(&filename);
+                    }
+                    return true;
+                }
+                
+                static bool getStamp(const String& directory, Stamp& stamp) {
+#ifdef _WIN32
+                    if (!::wxDirExists(directory))
+                        return false;
+                    stamp.id = 0;
+                    stamp.seconds = static_cast<int64_t>(::wxFileModificationTime(directory));
+                    stamp.nanoseconds = 0;
+#else
+                    struct stat info;
+                    if (::stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+                        return false;
+                    stamp.id = static_cast<uint64_t>(info.st_ino);
+#ifdef __APPLE__
+                    stamp.seconds = static_cast<int64_t>(info.st_mtimespec.tv_sec);
+                    stamp.nanoseconds = static_cast<int64_t>(info.st_mtimespec.tv_nsec);
+#else
+                    stamp.seconds = static_cast<int64_t>(info.st_mtim.tv_sec);
+                    stamp.nanoseconds = static_cast<int64_t>(info.st_mtim.tv_nsec);
+#endif
+#endif
+                    return true;
+                }
+            };
+            
+            DirectoryCache& directoryCache() {
+                static DirectoryCache cache;
+                return cache;
+            }
+            
+            void refreshDirectoryCache() {
+                directoryCache().clear();
+            }
+            
+            void invalidateParentDirectory(const Path& path) {
+                if (path.length() > 1)
+                    directoryCache().invalidate(path.deleteLastComponent());
             }
             
             Path fixCase(const Path& path) {
@@ -64,21 +208,11 @@ namespace TrenchBroom {
                     
                     Path result(path.firstComponent());
                     Path remainder(path.deleteFirstComponent());
-                    if (remainder.isEmpty())
-                        return result;
-                    
                     while (!remainder.isEmpty()) {
-                        const String nextPathStr = (result + remainder.firstComponent()).asString();
-                        if (!::wxDirExists(nextPathStr) &&
-                            !::wxFileExists(nextPathStr)) {
-                            const Path::List content = getDirectoryContents(result);
-                            const Path part = findCaseSensitivePath(content, remainder.firstComponent());
-                            if (part.isEmpty())
-                                return path;
-                            result = result + part;
-                        } else {
-                            result = result + remainder.firstComponent();
-                        }
+                        const Path part = directoryCache().findName(result, remainder.firstComponent().asString());
+                        if (part.isEmpty())
+                            return path;
+                        result = result + part;
                         remainder = remainder.deleteFirstComponent();
                     }
                     return result;
@@ -97,6 +231,19 @@ namespace TrenchBroom {
                 }
             }
             
+            Path resolveSymbolicLinks(const Path& path) {
+#ifdef _WIN32
+                return path;
+#else
+                char* resolvedPath = ::realpath(path.asString().c_str(), nullptr);
+                if (resolvedPath == nullptr)
+                    return path;
+                const Path result(resolvedPath);
+                ::free(resolvedPath);
+                return result;
+#endif
+            }
+            
             bool directoryExists(const Path& path) {
                 const Path fixedPath = fixPath(path);
                 return ::wxDirExists(fixedPath.asString());
@@ -113,20 +260,7 @@ namespace TrenchBroom {
             }
 
             Path::List getDirectoryContents(const Path& path) {
-                const Path fixedPath = fixPath(path);
-                wxDir dir(fixedPath.asString());
-                if (!dir.IsOpened())
-                    throw FileSystemException("Cannot open directory: '" + fixedPath.asString() + "'");
-                
-                Path::List result;
-                wxString filename;
-                if (dir.GetFirst(&filename)) {
-                    result.push_back(Path(filename.ToStdString()));
-                    while (dir.GetNext(&filename))
-                        result.push_back(Path(filename.ToStdString()));
-                }
-                
-                return result;
+                return directoryCache().contents(fixPath(path));
             }
             
             MappedFile::Ptr openFile(const Path& path) {
@@ -165,6 +299,7 @@ namespace TrenchBroom {
                 const String fixedPathStr = fixedPath.asString();
                 std::ofstream stream(fixedPathStr.c_str());
                 stream  << contents;
+                invalidateParentDirectory(fixedPath);
             }
 
             bool createDirectoryHelper(const Path& path);
@@ -185,6 +320,7 @@ namespace TrenchBroom {
                 const IO::Path parent = path.deleteLastComponent();
                 if (!::wxDirExists(parent.asString()) && !createDirectoryHelper(parent))
                     return false;
+                directoryCache().invalidate(parent);
                 return ::wxMkdir(path.asString());
             }
 
@@ -202,6 +338,7 @@ namespace TrenchBroom {
                     throw FileSystemException("Could not delete file '" + fixedPath.asString() + "': File does not exist.");
                 if (!::wxRemoveFile(fixedPath.asString()))
                     throw FileSystemException("Could not delete file '" + path.asString() + "'");
+                invalidateParentDirectory(fixedPath);
             }
             
             void copyFile(const Path& sourcePath, const Path& destPath, const bool overwrite) {
@@ -213,6 +350,7 @@ namespace TrenchBroom {
                     fixedDestPath = fixedDestPath + sourcePath.lastComponent();
                 if (!::wxCopyFile(fixedSourcePath.asString(), fixedDestPath.asString(), overwrite))
                     throw FileSystemException("Could not copy file '" + fixedSourcePath.asString() + "' to '" + fixedDestPath.asString() + "'");
+                invalidateParentDirectory(fixedDestPath);
             }
             
             void moveFile(const Path& sourcePath, const Path& destPath, const bool overwrite) {
@@ -224,6 +362,8 @@ namespace TrenchBroom {
                     fixedDestPath = fixedDestPath + sourcePath.lastComponent();
                 if (!::wxRenameFile(fixedSourcePath.asString(), fixedDestPath.asString(), overwrite))
                     throw FileSystemException("Could not move file '" + fixedSourcePath.asString() + "' to '" + fixedDestPath.asString() + "'");
+                invalidateParentDirectory(fixedSourcePath);
+                invalidateParentDirectory(fixedDestPath);
             }
             
             IO::Path resolvePath(const Path::List& searchPaths, const Path& path) {
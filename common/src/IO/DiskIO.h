@@ -34,12 +34,25 @@ namespace TrenchBroom {
             
             Path fixPath(const Path& path);
             
+            /**
+             * Returns the given path with every symbolic link in it resolved, so that all paths to the same file or
+             * directory yield the same result. A path that does not exist or cannot be resolved is returned unchanged.
+             */
+            Path resolveSymbolicLinks(const Path& path);
+            
             bool directoryExists(const Path& path);
             bool fileExists(const Path& path);
             
             String replaceForbiddenChars(const String& name);
             
             Path::List getDirectoryContents(const Path& path);
+            
+            /**
+             * Discards all cached directory contents. A cached directory is otherwise only read again when its
+             * modification time changes or when it is modified by one of the functions in this namespace.
+             */
+            void refreshDirectoryCache();
+            
             MappedFile::Ptr openFile(const Path& path);
             Path getCurrentWorkingDir();
             
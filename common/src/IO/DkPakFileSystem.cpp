@@ -24,7 +24,9 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/IOUtils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace TrenchBroom {
     namespace IO {
@@ -35,38 +37,97 @@ namespace TrenchBroom {
             static const String HeaderMagic       = "PACK";
         }
         
-        DkPakFileSystem::CompressedFile::CompressedFile(MappedFile::Ptr file, const size_t uncompressedSize) :
+        DkPakFileSystem::DecompressedFileCache::DecompressedFileCache(const size_t capacity) :
+        m_capacity(capacity),
+        m_size(0) {}
+        
+        MappedFile::Ptr DkPakFileSystem::DecompressedFileCache::find(const CompressedFile* file) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_index.find(file);
+            if (it == std::end(m_index))
+                return MappedFile::Ptr();
+            
+            m_entries.splice(std::begin(m_entries), m_entries, it->second);
+            return it->second->second;
+        }
+        
+        void DkPakFileSystem::DecompressedFileCache::insert(const CompressedFile* file, MappedFile::Ptr decompressed) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_index.count(file) > 0 || decompressed->size() > m_capacity)
+                return;
+            
+            m_entries.push_front(std::make_pair(file, decompressed));
+            m_index[file] = std::begin(m_entries);
+            m_size += decompressed->size();
+            
+            while (m_size > m_capacity) {
+                const Entry& last = m_entries.back();
+                m_size -= last.second->size();
+                m_index.erase(last.first);
+                m_entries.pop_back();
+            }
+        }
+        
+        DkPakFileSystem::CompressedFile::CompressedFile(MappedFile::Ptr file, const size_t uncompressedSize, DecompressedFileCache& cache) :
         m_file(file),
-        m_uncompressedSize(uncompressedSize) {}
+        m_uncompressedSize(uncompressedSize),
+        m_cache(cache) {}
 
         MappedFile::Ptr DkPakFileSystem::CompressedFile::doOpen() {
-            const char* data = decompress();
-            return MappedFile::Ptr(new MappedFileBuffer(m_file->path(), data, m_uncompressedSize));
+            MappedFile::Ptr result = m_cache.find(this);
+            if (result.get() != nullptr)
+                return result;
+            
+            char* data = new char[m_uncompressedSize];
+            try {
+                decompress(m_file->begin(), m_file->end(), data, m_uncompressedSize);
+            } catch (const FileSystemException& e) {
+                delete [] data;
+                throw FileSystemException("Cannot decompress '" + m_file->path().asString() + "': " + e.what());
+            }
+            
+            result = MappedFile::Ptr(new MappedFileBuffer(m_file->path(), data, m_uncompressedSize));
+            m_cache.insert(this, result);
+            return result;
         }
 
-        char* DkPakFileSystem::CompressedFile::decompress() const {
-            CharArrayReader reader(m_file->begin(), m_file->end());
-            
-            char* result = new char[m_uncompressedSize];
-            char* curTarget = result;
+        DkPakFileSystem::DkPakFileSystem(const Path& path, MappedFile::Ptr file, const size_t cacheCapacity) :
+        ImageFileSystem(path, file),
+        m_cache(cacheCapacity) {
+            initialize();
+        }
+        
+        void DkPakFileSystem::decompress(const char* begin, const char* end, char* target, const size_t targetSize) {
+            const char* cursor = begin;
+            char* curTarget = target;
+            char* const targetEnd = target + targetSize;
             
-            unsigned char x;
-            while (!reader.eof() && (x = reader.readUnsignedChar<unsigned char>()) < 0xFF) {
+            while (cursor < end) {
+                const unsigned char x = static_cast<unsigned char>(*cursor++);
+                if (x == 0xFF)
+                    break;
+                
                 if (x < 0x40) {
                     // x+1 bytes of uncompressed data follow (just read+write them as they are)
                     const size_t len = static_cast<size_t>(x) + 1;
-                    reader.read(curTarget, len);
+                    if (static_cast<size_t>(end - cursor) < len || static_cast<size_t>(targetEnd - curTarget) < len)
+                        throw FileSystemException("Malformed compressed data");
+                    std::memcpy(curTarget, cursor, len);
+                    cursor += len;
                     curTarget += len;
                 } else if (x < 0x80) {
                     // run-length encoded zeros, write (x - 62) zero-bytes to output
                     const size_t len = static_cast<size_t>(x) - 62;
-                    memset(curTarget, 0, len);
+                    if (static_cast<size_t>(targetEnd - curTarget) < len)
+                        throw FileSystemException("Malformed compressed data");
+                    std::memset(curTarget, 0, len);
                     curTarget += len;
                 } else if (x < 0xC0) {
                     // run-length encoded data, read one byte, write it (x-126) times to output
                     const size_t len = static_cast<size_t>(x) - 126;
-                    const int data = reader.readInt<unsigned char>();
-                    memset(curTarget, data, len);
+                    if (cursor == end || static_cast<size_t>(targetEnd - curTarget) < len)
+                        throw FileSystemException("Malformed compressed data");
+                    std::memset(curTarget, *cursor++, len);
                     curTarget += len;
                 } else if (x < 0xFE) {
                     // this references previously uncompressed data
@@ -74,25 +135,20 @@ namespace TrenchBroom {
                     // read (x-190) bytes from the already uncompressed and written output data,
                     // starting at (offset+2) bytes before the current write position (and add them to output, of course)
                     const size_t len = static_cast<size_t>(x) - 190;
-                    const size_t offset = reader.readSize<unsigned char>();
-                    char* from = curTarget - offset + 2;
-                    
-                    assert(from >= result);
-                    assert(from <  curTarget - len);
+                    if (cursor == end)
+                        throw FileSystemException("Malformed compressed data");
+                    const size_t offset = static_cast<size_t>(static_cast<unsigned char>(*cursor++)) + 2;
+                    if (static_cast<size_t>(curTarget - target) < offset || static_cast<size_t>(targetEnd - curTarget) < len)
+                        throw FileSystemException("Malformed compressed data");
                     
-                    memcpy(from, curTarget, len);
-                    curTarget += len;
+                    // the source range may overlap the bytes being written, which then repeat
+                    const char* from = curTarget - offset;
+                    for (size_t i = 0; i < len; ++i)
+                        *curTarget++ = *from++;
                 }
-
-                x = reader.readUnsignedChar<unsigned char>();
             }
             
-            return result;
-        }
-        
-        DkPakFileSystem::DkPakFileSystem(const Path& path, MappedFile::Ptr file) :
-        ImageFileSystem(path, file) {
-            initialize();
+            std::fill(curTarget, targetEnd, 0);
         }
         
         void DkPakFileSystem::doReadDirectory() {
@@ -113,14 +169,14 @@ namespace TrenchBroom {
                 const bool compressed = reader.readBool<int32_t>();
                 
                 const char* entryBegin = m_file->begin() + entryAddress;
-                const char* entryEnd = entryBegin + compressedSize;
+                const char* entryEnd = entryBegin + (compressed ? compressedSize : uncompressedSize);
                 const Path filePath(StringUtils::toLower(entryName));
                 MappedFile::Ptr entryFile(new MappedFileView(m_file, filePath, entryBegin, entryEnd));
                 
                 if (compressed)
-                    m_root.addFile(filePath, new SimpleFile(entryFile));
+                    m_root.addFile(filePath, new CompressedFile(entryFile, uncompressedSize, m_cache));
                 else
-                    m_root.addFile(filePath, new CompressedFile(entryFile, uncompressedSize));
+                    m_root.addFile(filePath, new SimpleFile(entryFile));
             }
         }
     }
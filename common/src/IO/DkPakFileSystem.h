@@ -24,24 +24,63 @@
 #include "IO/ImageFileSystem.h"
 #include "IO/Path.h"
 
-#include <map>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace IO {
         class DkPakFileSystem : public ImageFileSystem {
+        public:
+            static const size_t DefaultCacheCapacity = 32 * 1024 * 1024;
         private:
+            class CompressedFile;
+            
+            /**
+             * Keeps the most recently opened decompressed entries of a pak file, up to a given total size in bytes,
+             * so that opening the same entry again does not decompress it again. Once the capacity is exceeded, the
+             * least recently opened entries are dropped. Files that were opened before remain valid since they are
+             * shared.
+             */
+            class DecompressedFileCache {
+            private:
+                typedef std::pair<const CompressedFile*, MappedFile::Ptr> Entry;
+                typedef std::list<Entry> EntryList;
+                typedef std::unordered_map<const CompressedFile*, EntryList::iterator> EntryMap;
+                
+                const size_t m_capacity;
+                size_t m_size;
+                EntryList m_entries; // most recently used first
+                EntryMap m_index;
+                std::mutex m_mutex;
+            public:
+                explicit DecompressedFileCache(size_t capacity);
+                
+                MappedFile::Ptr find(const CompressedFile* file);
+                void insert(const CompressedFile* file, MappedFile::Ptr decompressed);
+            };
+            
             class CompressedFile : public File {
             private:
                 MappedFile::Ptr m_file;
                 const size_t m_uncompressedSize;
+                DecompressedFileCache& m_cache;
             public:
-                CompressedFile(MappedFile::Ptr file, size_t uncompressedSize);
+                CompressedFile(MappedFile::Ptr file, size_t uncompressedSize, DecompressedFileCache& cache);
             private:
                 MappedFile::Ptr doOpen();
-                char* decompress() const;
             };
+            
+            DecompressedFileCache m_cache;
         public:
-            DkPakFileSystem(const Path& path, MappedFile::Ptr file);
+            DkPakFileSystem(const Path& path, MappedFile::Ptr file, size_t cacheCapacity = DefaultCacheCapacity);
+            
+            /**
+             * Decompresses the given entry data into the given buffer in a single pass. Decompression stops at the
+             * end marker or at the end of the data, and the remainder of the buffer is filled with zeros. Throws a
+             * FileSystemException if the data is malformed or decompresses to more than targetSize bytes.
+             */
+            static void decompress(const char* begin, const char* end, char* target, size_t targetSize);
         private:
             void doReadDirectory();
             
@@ -456,9 +456,9 @@ namespace TrenchBroom {
             EL::ExpressionBase::List subExpressions;
             
             token = m_tokenizer.peekToken();
-            expect(ELToken::SimpleTerm | ELToken::DoubleCBrace, token);
+            expect(ELToken::SimpleTerm | ELToken::DoubleOBrace | ELToken::DoubleCBrace, token);
             
-            if (token.hasType(ELToken::SimpleTerm)) {
+            if (token.hasType(ELToken::SimpleTerm | ELToken::DoubleOBrace)) {
                 do {
                     subExpressions.push_back(parseExpression());
                 } while (expect(ELToken::Comma | ELToken::DoubleCBrace, m_tokenizer.nextToken()).hasType(ELToken::Comma));
@@ -0,0 +1,553 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityDefinitionCache.h"
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "Macros.h"
+#include "Assets/AttributeDefinition.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "EL/Expression.h"
+#include "IO/DiskIO.h"
+#include "IO/ELParser.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <thread>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace {
+            const char Magic[4] = { 'T', 'B', 'E', 'D' };
+            const uint32_t Version = 2;
+
+            // Cache files are named after their key and the format version, e.g. 0123456789abcdef-v2.bin.
+            const String CacheFileExtension = "bin";
+            const String VersionSuffix = "-v" + std::to_string(Version);
+
+            // The model definition of a class without a model is the literal undefined, which cannot be parsed.
+            const String UndefinedModelExpression = "undefined";
+
+            enum class AttributeType : uint8_t {
+                TargetSource,
+                TargetDestination,
+                String,
+                Integer,
+                Float,
+                Choice,
+                Flags,
+                Unknown
+            };
+
+            class CacheWriter {
+            private:
+                String& m_buffer;
+            public:
+                explicit CacheWriter(String& buffer) :
+                m_buffer(buffer) {}
+
+                size_t position() const {
+                    return m_buffer.size();
+                }
+
+                template <typename T>
+                void write(const T& value) {
+                    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+
+                template <typename T>
+                void writeAt(const size_t position, const T& value) {
+                    std::memcpy(&m_buffer[position], &value, sizeof(T));
+                }
+
+                void writeString(const String& str) {
+                    write(static_cast<uint32_t>(str.size()));
+                    m_buffer.append(str);
+                }
+            };
+
+            class CacheReader {
+            private:
+                const char* m_cur;
+                const char* m_end;
+            public:
+                CacheReader(const char* begin, const char* end) :
+                m_cur(begin),
+                m_end(end) {}
+
+                template <typename T>
+                T read() {
+                    T value;
+                    std::memcpy(&value, consume(sizeof(T)), sizeof(T));
+                    return value;
+                }
+
+                String readString() {
+                    const size_t size = read<uint32_t>();
+                    return String(consume(size), size);
+                }
+
+                const char* consume(const size_t size) {
+                    if (static_cast<size_t>(m_end - m_cur) < size)
+                        throw FileFormatException("Unexpected end of entity definition cache file");
+                    const char* result = m_cur;
+                    m_cur += size;
+                    return result;
+                }
+            };
+
+            AttributeType attributeType(const Assets::AttributeDefinition& definition) {
+                switch (definition.type()) {
+                    case Assets::AttributeDefinition::Type_TargetSourceAttribute:
+                        return AttributeType::TargetSource;
+                    case Assets::AttributeDefinition::Type_TargetDestinationAttribute:
+                        return AttributeType::TargetDestination;
+                    case Assets::AttributeDefinition::Type_StringAttribute:
+                        if (dynamic_cast<const Assets::UnknownAttributeDefinition*>(&definition) != nullptr)
+                            return AttributeType::Unknown;
+                        return AttributeType::String;
+                    case Assets::AttributeDefinition::Type_IntegerAttribute:
+                        return AttributeType::Integer;
+                    case Assets::AttributeDefinition::Type_FloatAttribute:
+                        return AttributeType::Float;
+                    case Assets::AttributeDefinition::Type_ChoiceAttribute:
+                        return AttributeType::Choice;
+                    case Assets::AttributeDefinition::Type_FlagsAttribute:
+                        return AttributeType::Flags;
+                    switchDefault()
+                }
+            }
+
+            void writeStringDefaultValue(CacheWriter& writer, const Assets::StringAttributeDefinition& definition) {
+                writer.write(static_cast<uint8_t>(definition.hasDefaultValue()));
+                if (definition.hasDefaultValue())
+                    writer.writeString(definition.defaultValue());
+            }
+
+            void writeAttributeDefinition(CacheWriter& writer, const Assets::AttributeDefinition& definition) {
+                const AttributeType type = attributeType(definition);
+                writer.write(type);
+                writer.writeString(definition.name());
+                writer.writeString(definition.shortDescription());
+                writer.writeString(definition.longDescription());
+
+                switch (type) {
+                    case AttributeType::TargetSource:
+                    case AttributeType::TargetDestination:
+                        break;
+                    case AttributeType::String:
+                    case AttributeType::Unknown:
+                        writeStringDefaultValue(writer, static_cast<const Assets::StringAttributeDefinition&>(definition));
+                        break;
+                    case AttributeType::Integer: {
+                        const Assets::IntegerAttributeDefinition& intDef = static_cast<const Assets::IntegerAttributeDefinition&>(definition);
+                        writer.write(static_cast<uint8_t>(intDef.hasDefaultValue()));
+                        if (intDef.hasDefaultValue())
+                            writer.write(static_cast<int32_t>(intDef.defaultValue()));
+                        break;
+                    }
+                    case AttributeType::Float: {
+                        const Assets::FloatAttributeDefinition& floatDef = static_cast<const Assets::FloatAttributeDefinition&>(definition);
+                        writer.write(static_cast<uint8_t>(floatDef.hasDefaultValue()));
+                        if (floatDef.hasDefaultValue())
+                            writer.write(floatDef.defaultValue());
+                        break;
+                    }
+                    case AttributeType::Choice: {
+                        const Assets::ChoiceAttributeDefinition& choiceDef = static_cast<const Assets::ChoiceAttributeDefinition&>(definition);
+                        writer.write(static_cast<uint32_t>(choiceDef.options().size()));
+                        for (const Assets::ChoiceAttributeOption& option : choiceDef.options()) {
+                            writer.writeString(option.value());
+                            writer.writeString(option.description());
+                        }
+                        writer.write(static_cast<uint8_t>(choiceDef.hasDefaultValue()));
+                        if (choiceDef.hasDefaultValue())
+                            writer.write(static_cast<uint64_t>(choiceDef.defaultValue()));
+                        break;
+                    }
+                    case AttributeType::Flags: {
+                        const Assets::FlagsAttributeDefinition& flagsDef = static_cast<const Assets::FlagsAttributeDefinition&>(definition);
+                        writer.write(static_cast<uint32_t>(flagsDef.options().size()));
+                        for (const Assets::FlagsAttributeOption& option : flagsDef.options()) {
+                            writer.write(static_cast<int32_t>(option.value()));
+                            writer.writeString(option.shortDescription());
+                            writer.writeString(option.longDescription());
+                            writer.write(static_cast<uint8_t>(option.isDefault()));
+                        }
+                        break;
+                    }
+                    switchDefault()
+                }
+            }
+
+            Assets::AttributeDefinition* readAttributeDefinition(CacheReader& reader) {
+                const AttributeType type = reader.read<AttributeType>();
+                const String name = reader.readString();
+                const String shortDescription = reader.readString();
+                const String longDescription = reader.readString();
+
+                switch (type) {
+                    case AttributeType::TargetSource:
+                        return new Assets::AttributeDefinition(name, Assets::AttributeDefinition::Type_TargetSourceAttribute, shortDescription, longDescription);
+                    case AttributeType::TargetDestination:
+                        return new Assets::AttributeDefinition(name, Assets::AttributeDefinition::Type_TargetDestinationAttribute, shortDescription, longDescription);
+                    case AttributeType::String:
+                        if (reader.read<uint8_t>() != 0)
+                            return new Assets::StringAttributeDefinition(name, shortDescription, longDescription, reader.readString());
+                        return new Assets::StringAttributeDefinition(name, shortDescription, longDescription);
+                    case AttributeType::Unknown:
+                        if (reader.read<uint8_t>() != 0)
+                            return new Assets::UnknownAttributeDefinition(name, shortDescription, longDescription, reader.readString());
+                        return new Assets::UnknownAttributeDefinition(name, shortDescription, longDescription);
+                    case AttributeType::Integer:
+                        if (reader.read<uint8_t>() != 0)
+                            return new Assets::IntegerAttributeDefinition(name, shortDescription, longDescription, static_cast<int>(reader.read<int32_t>()));
+                        return new Assets::IntegerAttributeDefinition(name, shortDescription, longDescription);
+                    case AttributeType::Float:
+                        if (reader.read<uint8_t>() != 0)
+                            return new Assets::FloatAttributeDefinition(name, shortDescription, longDescription, reader.read<float>());
+                        return new Assets::FloatAttributeDefinition(name, shortDescription, longDescription);
+                    case AttributeType::Choice: {
+                        const size_t count = reader.read<uint32_t>();
+                        Assets::ChoiceAttributeOption::List options;
+                        for (size_t i = 0; i < count; ++i) {
+                            const String value = reader.readString();
+                            const String description = reader.readString();
+                            options.push_back(Assets::ChoiceAttributeOption(value, description));
+                        }
+                        if (reader.read<uint8_t>() != 0)
+                            return new Assets::ChoiceAttributeDefinition(name, shortDescription, longDescription, options, static_cast<size_t>(reader.read<uint64_t>()));
+                        return new Assets::ChoiceAttributeDefinition(name, shortDescription, longDescription, options);
+                    }
+                    case AttributeType::Flags: {
+                        std::unique_ptr<Assets::FlagsAttributeDefinition> definition(new Assets::FlagsAttributeDefinition(name));
+                        const size_t count = reader.read<uint32_t>();
+                        for (size_t i = 0; i < count; ++i) {
+                            const int value = static_cast<int>(reader.read<int32_t>());
+                            const String optionShortDescription = reader.readString();
+                            const String optionLongDescription = reader.readString();
+                            const bool isDefault = reader.read<uint8_t>() != 0;
+                            definition->addOption(value, optionShortDescription, optionLongDescription, isDefault);
+                        }
+                        return definition.release();
+                    }
+                }
+                throw FileFormatException("Unknown attribute type in entity definition cache file");
+            }
+
+            Assets::AttributeDefinitionList readAttributeDefinitions(const char* begin, const char* end) {
+                CacheReader reader(begin, end);
+                const size_t count = reader.read<uint32_t>();
+
+                Assets::AttributeDefinitionList result;
+                result.reserve(count);
+                for (size_t i = 0; i < count; ++i)
+                    result.push_back(Assets::AttributeDefinitionPtr(readAttributeDefinition(reader)));
+                return result;
+            }
+
+            /**
+             * Reads the attribute definitions of a class from the cache file when they are first requested. The
+             * bounds of the attribute block are validated when the cache file is loaded.
+             */
+            Assets::AttributeDefinitionLoader attributeDefinitionLoader(MappedFile::Ptr file, const char* begin, const char* end) {
+                return [file, begin, end]() {
+                    try {
+                        return readAttributeDefinitions(begin, end);
+                    } catch (const FileFormatException&) {
+                        return Assets::AttributeDefinitionList();
+                    }
+                };
+            }
+
+            void writeColor(CacheWriter& writer, const Color& color) {
+                writer.write(color.r());
+                writer.write(color.g());
+                writer.write(color.b());
+                writer.write(color.a());
+            }
+
+            Color readColor(CacheReader& reader) {
+                const float r = reader.read<float>();
+                const float g = reader.read<float>();
+                const float b = reader.read<float>();
+                const float a = reader.read<float>();
+                return Color(r, g, b, a);
+            }
+
+            /**
+             * The part of a cache file that identifies the definition file it was created from.
+             */
+            struct Header {
+                EntityDefinitionCache::Key key;
+                uint64_t size;
+                String source;
+                Color defaultColor;
+            };
+
+            Header readHeader(CacheReader& reader) {
+                if (std::memcmp(reader.consume(sizeof(Magic)), Magic, sizeof(Magic)) != 0)
+                    throw FileFormatException("Not an entity definition cache file");
+                if (reader.read<uint32_t>() != Version)
+                    throw FileFormatException("Unsupported entity definition cache file version");
+
+                Header header;
+                header.key = reader.read<EntityDefinitionCache::Key>();
+                header.size = reader.read<uint64_t>();
+                header.source = reader.readString();
+                header.defaultColor = readColor(reader);
+                return header;
+            }
+
+            void writeEntityDefinition(CacheWriter& writer, const Assets::EntityDefinition& definition) {
+                writer.write(static_cast<uint8_t>(definition.type()));
+                writer.writeString(definition.name());
+                writeColor(writer, definition.color());
+                writer.writeString(definition.description());
+
+                if (definition.type() == Assets::EntityDefinition::Type_PointEntity) {
+                    const Assets::PointEntityDefinition& pointDefinition = static_cast<const Assets::PointEntityDefinition&>(definition);
+                    const BBox3& bounds = pointDefinition.bounds();
+                    for (size_t i = 0; i < 3; ++i)
+                        writer.write(bounds.min[i]);
+                    for (size_t i = 0; i < 3; ++i)
+                        writer.write(bounds.max[i]);
+
+                    const String expression = pointDefinition.modelDefinition().expression().asString();
+                    writer.writeString(expression == UndefinedModelExpression ? EmptyString : expression);
+                }
+
+                // The size of the attribute block precedes it so that it can be skipped when loading.
+                const size_t sizePosition = writer.position();
+                writer.write(static_cast<uint32_t>(0));
+
+                const Assets::AttributeDefinitionList& attributeDefinitions = definition.attributeDefinitions();
+                writer.write(static_cast<uint32_t>(attributeDefinitions.size()));
+                for (const Assets::AttributeDefinitionPtr& attributeDefinition : attributeDefinitions)
+                    writeAttributeDefinition(writer, *attributeDefinition);
+
+                writer.writeAt(sizePosition, static_cast<uint32_t>(writer.position() - sizePosition - sizeof(uint32_t)));
+            }
+
+            Assets::EntityDefinition* readEntityDefinition(CacheReader& reader, MappedFile::Ptr file) {
+                const uint8_t type = reader.read<uint8_t>();
+                const String name = reader.readString();
+                const Color color = readColor(reader);
+                const String description = reader.readString();
+
+                if (type == Assets::EntityDefinition::Type_PointEntity) {
+                    BBox3 bounds;
+                    for (size_t i = 0; i < 3; ++i)
+                        bounds.min[i] = reader.read<FloatType>();
+                    for (size_t i = 0; i < 3; ++i)
+                        bounds.max[i] = reader.read<FloatType>();
+
+                    const String expression = reader.readString();
+                    Assets::ModelDefinition modelDefinition;
+                    if (!expression.empty()) {
+                        try {
+                            modelDefinition = Assets::ModelDefinition(ELParser::parseStrict(expression));
+                        } catch (const ParserException& e) {
+                            throw FileFormatException("Invalid model definition in entity definition cache file: " + String(e.what()));
+                        }
+                    }
+
+                    const size_t attributesSize = reader.read<uint32_t>();
+                    const char* attributesBegin = reader.consume(attributesSize);
+                    const Assets::AttributeDefinitionLoader loader = attributeDefinitionLoader(file, attributesBegin, attributesBegin + attributesSize);
+                    return new Assets::PointEntityDefinition(name, color, bounds, description, loader, modelDefinition);
+                } else if (type == Assets::EntityDefinition::Type_BrushEntity) {
+                    const size_t attributesSize = reader.read<uint32_t>();
+                    const char* attributesBegin = reader.consume(attributesSize);
+                    const Assets::AttributeDefinitionLoader loader = attributeDefinitionLoader(file, attributesBegin, attributesBegin + attributesSize);
+                    return new Assets::BrushEntityDefinition(name, color, description, loader);
+                } else {
+                    throw FileFormatException("Unknown entity definition type in entity definition cache file");
+                }
+            }
+        }
+
+        EntityDefinitionCache::EntityDefinitionCache(const Path& directory) :
+        m_directory(directory) {}
+
+        bool EntityDefinitionCache::load(const MappedFile& file, const Color& defaultColor, Assets::EntityDefinitionList& definitions) const {
+            const Key cacheKey = key(file, defaultColor);
+            const Path path = cacheFilePath(cacheKey);
+            if (!Disk::fileExists(path))
+                return false;
+
+            try {
+                const Assets::EntityDefinitionList cached = deserialize(cacheKey, Disk::openFile(path));
+                definitions.insert(std::end(definitions), std::begin(cached), std::end(cached));
+                return true;
+            } catch (const Exception&) {
+                return false;
+            }
+        }
+
+        void EntityDefinitionCache::store(const MappedFile& file, const Color& defaultColor, const Assets::EntityDefinitionList& definitions) const {
+            const Key cacheKey = key(file, defaultColor);
+            const Path path = cacheFilePath(cacheKey);
+            const String contents = serialize(cacheKey, file.path(), defaultColor, definitions);
+
+            Disk::ensureDirectoryExists(m_directory);
+
+            // Definitions that were loaded from an existing cache file read their attributes from a mapping of
+            // it, so the file must not be changed in place. The new contents are written to a temporary file
+            // which then replaces the existing one.
+            const Path tempPath = temporaryFilePath(path);
+            try {
+                std::ofstream stream(tempPath.asString().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!stream.is_open())
+                    throw FileSystemException("Cannot open file: " + tempPath.asString());
+                stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+                stream.close();
+                if (!stream)
+                    throw FileSystemException("Cannot write file: " + tempPath.asString());
+
+                Disk::moveFile(tempPath, path, true);
+            } catch (...) {
+                if (Disk::fileExists(tempPath))
+                    Disk::deleteFile(tempPath);
+                throw;
+            }
+
+            evictOrphans(path, file.path(), defaultColor);
+        }
+
+        EntityDefinitionCache::Key EntityDefinitionCache::key(const MappedFile& file, const Color& defaultColor) {
+            // 64 bit FNV-1a
+            static const Key Prime = 1099511628211ull;
+            Key hash = 14695981039346656037ull;
+
+            const auto add = [&hash](const char* begin, const char* end) {
+                for (const char* cur = begin; cur != end; ++cur) {
+                    hash ^= static_cast<unsigned char>(*cur);
+                    hash *= Prime;
+                }
+            };
+
+            add(file.begin(), file.end());
+
+            const float components[] = { defaultColor.r(), defaultColor.g(), defaultColor.b(), defaultColor.a() };
+            const char* colorBegin = reinterpret_cast<const char*>(components);
+            add(colorBegin, colorBegin + sizeof(components));
+
+            return hash;
+        }
+
+        String EntityDefinitionCache::serialize(const Key key, const Path& source, const Color& defaultColor, const Assets::EntityDefinitionList& definitions) {
+            String result;
+            CacheWriter writer(result);
+
+            result.append(Magic, sizeof(Magic));
+            writer.write(Version);
+            writer.write(key);
+
+            const size_t sizePosition = writer.position();
+            writer.write(static_cast<uint64_t>(0));
+
+            writer.writeString(source.asString());
+            writeColor(writer, defaultColor);
+
+            writer.write(static_cast<uint32_t>(definitions.size()));
+            for (const Assets::EntityDefinition* definition : definitions)
+                writeEntityDefinition(writer, *definition);
+
+            writer.writeAt(sizePosition, static_cast<uint64_t>(writer.position()));
+            return result;
+        }
+
+        Assets::EntityDefinitionList EntityDefinitionCache::deserialize(const Key key, MappedFile::Ptr file) {
+            CacheReader reader(file->begin(), file->end());
+
+            const Header header = readHeader(reader);
+            if (header.key != key)
+                throw FileFormatException("Entity definition cache file does not match its definition file");
+            if (header.size != file->size())
+                throw FileFormatException("Incomplete entity definition cache file");
+
+            Assets::EntityDefinitionList result;
+            try {
+                const size_t count = reader.read<uint32_t>();
+                result.reserve(count);
+                for (size_t i = 0; i < count; ++i)
+                    result.push_back(readEntityDefinition(reader, file));
+            } catch (...) {
+                VectorUtils::clearAndDelete(result);
+                throw;
+            }
+            return result;
+        }
+
+        Path EntityDefinitionCache::cacheFilePath(const Key key) const {
+            StringStream name;
+            name << std::hex << std::setw(16) << std::setfill('0') << key << VersionSuffix << "." << CacheFileExtension;
+            return m_directory + Path(name.str());
+        }
+
+        Path EntityDefinitionCache::temporaryFilePath(const Path& path) {
+            // another thread or instance may store the same file at the same time
+            const size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+            const auto time = std::chrono::steady_clock::now().time_since_epoch().count();
+
+            StringStream suffix;
+            suffix << std::hex << thread << "-" << time << ".tmp";
+            return path.addExtension(suffix.str());
+        }
+
+        void EntityDefinitionCache::evictOrphans(const Path& path, const Path& source, const Color& defaultColor) const {
+            const Path::List cacheFiles = Disk::findItems(m_directory, [](const Path& itemPath, const bool directory) {
+                return !directory && itemPath.extension() == CacheFileExtension;
+            });
+
+            for (const Path& cacheFile : cacheFiles) {
+                if (cacheFile != path && isOrphan(cacheFile, source, defaultColor)) {
+                    try {
+                        Disk::deleteFile(cacheFile);
+                    } catch (const FileSystemException&) {
+                        // the file is still in use, try again next time
+                    }
+                }
+            }
+        }
+
+        bool EntityDefinitionCache::isOrphan(const Path& cacheFile, const Path& source, const Color& defaultColor) {
+            if (!StringUtils::caseSensitiveSuffix(cacheFile.basename(), VersionSuffix))
+                return true;
+
+            try {
+                const MappedFile::Ptr file = Disk::openFile(cacheFile);
+                CacheReader reader(file->begin(), file->end());
+                const Header header = readHeader(reader);
+
+                // a cache file for an older version of the same definition file
+                return header.source == source.asString() && header.defaultColor == defaultColor;
+            } catch (const Exception&) {
+                return true;
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityDefinitionCache
+#define TrenchBroom_EntityDefinitionCache
+
+#include "Color.h"
+#include "StringUtils.h"
+#include "Assets/AssetTypes.h"
+#include "IO/MappedFile.h"
+#include "IO/Path.h"
+
+#include <cstdint>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Stores parsed entity definitions in a binary form in a directory, so that an unchanged definition file
+         * can be loaded again without tokenizing it.
+         *
+         * Each cache file is named after a hash of the contents of the definition file and of the default color
+         * that was used to parse it, and after the version of the cache file format. Model definitions are stored as
+         * the source of their EL expressions, and the attribute definitions of a class are only read from the cache
+         * file when they are first requested.
+         *
+         * Storing the definitions of a file removes the cache files of earlier versions of the same file and the
+         * files of other format versions, so that the directory does not grow with every change of a file.
+         */
+        class EntityDefinitionCache {
+        public:
+            typedef uint64_t Key;
+        private:
+            Path m_directory;
+        public:
+            explicit EntityDefinitionCache(const Path& directory);
+
+            /**
+             * Loads the cached definitions for the given definition file. Returns false if there is no valid cache
+             * file for it, in which case the given list remains unchanged.
+             */
+            bool load(const MappedFile& file, const Color& defaultColor, Assets::EntityDefinitionList& definitions) const;
+
+            /**
+             * Writes the given definitions, which must have been parsed from the given definition file, to the cache.
+             * Reads the attribute definitions of all of the given definitions, so they should not be definitions that
+             * are otherwise in use if their attributes are loaded lazily.
+             *
+             * The cache file is replaced rather than overwritten, so definitions that were loaded from it earlier
+             * remain valid.
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void store(const MappedFile& file, const Color& defaultColor, const Assets::EntityDefinitionList& definitions) const;
+
+            static Key key(const MappedFile& file, const Color& defaultColor);
+
+            static String serialize(Key key, const Path& source, const Color& defaultColor, const Assets::EntityDefinitionList& definitions);
+
+            /**
+             * Reads the definitions from the given cache file.
+             *
+             * @throw FileFormatException if the file is not a cache file for the given key or if it is corrupt
+             */
+            static Assets::EntityDefinitionList deserialize(Key key, MappedFile::Ptr file);
+        private:
+            Path cacheFilePath(Key key) const;
+            static Path temporaryFilePath(const Path& path);
+            void evictOrphans(const Path& path, const Path& source, const Color& defaultColor) const;
+            static bool isOrphan(const Path& cacheFile, const Path& source, const Color& defaultColor);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityDefinitionCache) */
@@ -149,6 +149,10 @@ namespace TrenchBroom {
                         if (classAttributeIt != std::end(m_attributes)) {
                             // the class already has a definition for this attribute, attempt merging them
                             mergeProperties(classAttributeIt->second.get(), baseAttribute.get());
+                        } else if (baseAttribute->type() == Assets::AttributeDefinition::Type_FlagsAttribute) {
+                            // the flags may be merged with those of another base class later, so they must not be shared
+                            const Assets::FlagsAttributeDefinition* baseFlags = static_cast<const Assets::FlagsAttributeDefinition*>(baseAttribute.get());
+                            addAttributeDefinition(Assets::AttributeDefinitionPtr(new Assets::FlagsAttributeDefinition(*baseFlags)));
                         } else {
                             // the class doesn't have a definition for this attribute, add the base class attribute
                             addAttributeDefinition(baseAttribute);
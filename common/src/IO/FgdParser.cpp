@@ -27,6 +27,11 @@
 #include "IO/ELParser.h"
 #include "IO/LegacyModelDefinitionParser.h"
 #include "IO/ParserStatus.h"
+#include "IO/SimpleParserStatus.h"
+
+#include <algorithm>
+#include <cassert>
+#include <mutex>
 
 namespace TrenchBroom {
     namespace IO {
@@ -102,13 +107,75 @@ namespace TrenchBroom {
             return Token(FgdToken::Eof, nullptr, nullptr, length(), line(), column());
         }
         
-        FgdParser::FgdParser(const char* begin, const char* end, const Color& defaultEntityColor) :
+        class FgdParser::AttributeSource {
+        private:
+            MappedFile::Ptr m_file;
+            TokenizerState::Snapshot m_snapshot;
+            StringList m_superClasses;
+            AttributeSourceMap m_baseClasses;
+            std::once_flag m_loaded;
+            Assets::AttributeDefinitionMap m_attributes;
+        public:
+            AttributeSource(MappedFile::Ptr file, const TokenizerState::Snapshot& snapshot, const StringList& superClasses, const AttributeSourceMap& baseClasses) :
+            m_file(file),
+            m_snapshot(snapshot),
+            m_superClasses(superClasses) {
+                for (const String& superClass : m_superClasses) {
+                    const auto it = baseClasses.find(superClass);
+                    if (it != std::end(baseClasses))
+                        m_baseClasses[superClass] = it->second;
+                }
+            }
+            
+            const Assets::AttributeDefinitionMap& attributes() {
+                // definitions may be queried from several threads at once
+                std::call_once(m_loaded, [this]() { load(); });
+                return m_attributes;
+            }
+        private:
+            void load() {
+                // the block was validated and its problems were reported when the class was parsed
+                SimpleParserStatus status(nullptr);
+                try {
+                    FgdParser parser(m_file, Color());
+                    parser.m_tokenizer.restore(m_snapshot);
+                    
+                    EntityDefinitionClassInfo classInfo;
+                    classInfo.addAttributeDefinitions(parser.parseProperties(status));
+                    
+                    EntityDefinitionClassInfoMap baseClasses;
+                    for (const auto& entry : m_baseClasses)
+                        baseClasses[entry.first].addAttributeDefinitions(entry.second->attributes());
+                    classInfo.resolveBaseClasses(baseClasses, m_superClasses);
+                    
+                    m_attributes = classInfo.attributeMap();
+                } catch (const ParserException&) {
+                    assert(false);
+                    m_attributes.clear();
+                }
+                
+                m_file.reset();
+                m_baseClasses.clear();
+            }
+        };
+        
+        static MappedFile::Ptr copyToBuffer(const char* begin, const char* end) {
+            const size_t size = static_cast<size_t>(end - begin);
+            char* buffer = new char[size];
+            std::copy(begin, end, buffer);
+            return MappedFile::Ptr(new MappedFileBuffer(Path(""), buffer, size));
+        }
+        
+        FgdParser::FgdParser(MappedFile::Ptr file, const Color& defaultEntityColor) :
+        m_file(file),
         m_defaultEntityColor(defaultEntityColor),
-        m_tokenizer(FgdTokenizer(begin, end)) {}
+        m_tokenizer(FgdTokenizer(m_file->begin(), m_file->end())) {}
+        
+        FgdParser::FgdParser(const char* begin, const char* end, const Color& defaultEntityColor) :
+        FgdParser(copyToBuffer(begin, end), defaultEntityColor) {}
         
         FgdParser::FgdParser(const String& str, const Color& defaultEntityColor) :
-        m_defaultEntityColor(defaultEntityColor),
-        m_tokenizer(FgdTokenizer(str)) {}
+        FgdParser(copyToBuffer(str.c_str(), str.c_str() + str.size()), defaultEntityColor) {}
         
         FgdParser::TokenNameMap FgdParser::tokenNames() const {
             using namespace FgdToken;
@@ -157,8 +224,10 @@ namespace TrenchBroom {
             } else if (StringUtils::caseInsensitiveEqual(classname, "@PointClass")) {
                 return parsePointClass(status);
             } else if (StringUtils::caseInsensitiveEqual(classname, "@BaseClass")) {
-                const EntityDefinitionClassInfo baseClass = parseBaseClass(status);
+                AttributeSourcePtr attributes;
+                const EntityDefinitionClassInfo baseClass = parseBaseClass(status, attributes);
                 m_baseClasses[baseClass.name()] = baseClass;
+                m_baseClassAttributes[baseClass.name()] = attributes;
                 return parseDefinition(status);
             } else if (StringUtils::caseInsensitiveEqual(classname, "@Main")) {
                 skipMainClass(status);
@@ -171,27 +240,29 @@ namespace TrenchBroom {
         }
         
         Assets::EntityDefinition* FgdParser::parseSolidClass(ParserStatus& status) {
-            EntityDefinitionClassInfo classInfo = parseClass(status);
+            AttributeSourcePtr attributes;
+            EntityDefinitionClassInfo classInfo = parseClass(status, attributes);
             if (classInfo.hasSize())
                 status.warn(classInfo.line(), classInfo.column(), "Solid entity definition must not have a size");
             if (classInfo.hasModelDefinition())
                 status.warn(classInfo.line(), classInfo.column(), "Solid entity definition must not have model definitions");
-            return new Assets::BrushEntityDefinition(classInfo.name(), classInfo.color(), classInfo.description(), classInfo.attributeList());
+            return new Assets::BrushEntityDefinition(classInfo.name(), classInfo.color(), classInfo.description(), attributeDefinitionLoader(attributes));
         }
         
         Assets::EntityDefinition* FgdParser::parsePointClass(ParserStatus& status) {
-            EntityDefinitionClassInfo classInfo = parseClass(status);
-            return new Assets::PointEntityDefinition(classInfo.name(), classInfo.color(), classInfo.size(), classInfo.description(), classInfo.attributeList(), classInfo.modelDefinition());
+            AttributeSourcePtr attributes;
+            EntityDefinitionClassInfo classInfo = parseClass(status, attributes);
+            return new Assets::PointEntityDefinition(classInfo.name(), classInfo.color(), classInfo.size(), classInfo.description(), attributeDefinitionLoader(attributes), classInfo.modelDefinition());
         }
         
-        EntityDefinitionClassInfo FgdParser::parseBaseClass(ParserStatus& status) {
-            EntityDefinitionClassInfo classInfo = parseClass(status);
+        EntityDefinitionClassInfo FgdParser::parseBaseClass(ParserStatus& status, AttributeSourcePtr& attributes) {
+            EntityDefinitionClassInfo classInfo = parseClass(status, attributes);
             if (m_baseClasses.count(classInfo.name()) > 0)
                 status.warn(classInfo.line(), classInfo.column(), "Redefinition of base class '" + classInfo.name() + "'");
             return classInfo;
         }
         
-        EntityDefinitionClassInfo FgdParser::parseClass(ParserStatus& status) {
+        EntityDefinitionClassInfo FgdParser::parseClass(ParserStatus& status, AttributeSourcePtr& attributes) {
             Token token;
             expect(status, FgdToken::Word | FgdToken::Equality, token = m_tokenizer.nextToken());
             
@@ -235,11 +306,17 @@ namespace TrenchBroom {
                 classInfo.setDescription(StringUtils::trim(token.data()));
             }
             
-            classInfo.addAttributeDefinitions(parseProperties(status));
+            // the attributes are only parsed once they are needed, see AttributeSource
+            attributes = std::make_shared<AttributeSource>(m_file, m_tokenizer.snapshot(), superClasses, m_baseClassAttributes);
+            validateProperties(status);
             classInfo.resolveBaseClasses(m_baseClasses, superClasses);
             return classInfo;
         }
 
+        Assets::AttributeDefinitionLoader FgdParser::attributeDefinitionLoader(AttributeSourcePtr attributes) const {
+            return [attributes]() { return MapUtils::valueList(attributes->attributes()); };
+        }
+        
         void FgdParser::skipMainClass(ParserStatus& status) {
             Token token;
             expect(status, FgdToken::Equality, token = m_tokenizer.nextToken());
@@ -310,6 +387,101 @@ namespace TrenchBroom {
             } while (depth > 0 && token.type() != FgdToken::Eof);
         }
 
+        void FgdParser::validateProperties(ParserStatus& status) {
+            // checks the same grammar as parseProperties and reports the same problems, but does not create any
+            // attribute definitions
+            StringSet attributeKeys;
+            
+            Token token;
+            expect(status, FgdToken::OBracket, token = m_tokenizer.nextToken());
+            expect(status, FgdToken::Word | FgdToken::CBracket, token = m_tokenizer.nextToken());
+            while (token.type() != FgdToken::CBracket) {
+                const String attributeKey = token.data();
+                
+                if (!attributeKeys.insert(attributeKey).second) {
+                    status.warn(token.line(), token.column(), "Redefinition of property declaration '" + attributeKey + "'");
+                }
+                
+                expect(status, FgdToken::OParenthesis, token = m_tokenizer.nextToken());
+                expect(status, FgdToken::Word, token = m_tokenizer.nextToken());
+                const String typeName = token.data();
+                expect(status, FgdToken::CParenthesis, token = m_tokenizer.nextToken());
+                
+                if (StringUtils::caseInsensitiveEqual(typeName, "integer")) {
+                    skipAttributeString(status);
+                    parseDefaultIntegerValue(status);
+                    skipAttributeString(status);
+                } else if (StringUtils::caseInsensitiveEqual(typeName, "float")) {
+                    skipAttributeString(status);
+                    parseDefaultFloatValue(status);
+                    skipAttributeString(status);
+                } else if (StringUtils::caseInsensitiveEqual(typeName, "choices")) {
+                    skipAttributeString(status);
+                    parseDefaultIntegerValue(status);
+                    skipAttributeString(status);
+                    validateChoices(status);
+                } else if (StringUtils::caseInsensitiveEqual(typeName, "flags")) {
+                    validateFlags(status);
+                } else {
+                    if (!StringUtils::caseInsensitiveEqual(typeName, "target_source") &&
+                        !StringUtils::caseInsensitiveEqual(typeName, "target_destination") &&
+                        !StringUtils::caseInsensitiveEqual(typeName, "string"))
+                        status.debug(token.line(), token.column(), "Unknown property definition type '" + typeName + "' for attribute '" + attributeKey + "'");
+                    skipAttributeString(status);
+                    skipAttributeString(status);
+                    skipAttributeString(status);
+                }
+                
+                expect(status, FgdToken::Word | FgdToken::CBracket, token = m_tokenizer.nextToken());
+            }
+        }
+        
+        void FgdParser::validateChoices(ParserStatus& status) {
+            Token token;
+            expect(status, FgdToken::Equality, token = m_tokenizer.nextToken());
+            expect(status, FgdToken::OBracket, token = m_tokenizer.nextToken());
+            expect(status, FgdToken::Integer | FgdToken::Decimal | FgdToken::String | FgdToken::CBracket, token = m_tokenizer.nextToken());
+            while (token.type() != FgdToken::CBracket) {
+                expect(status, FgdToken::Colon, token = m_tokenizer.nextToken());
+                expect(status, FgdToken::String, token = m_tokenizer.nextToken());
+                expect(status, FgdToken::Integer | FgdToken::Decimal | FgdToken::String | FgdToken::CBracket, token = m_tokenizer.nextToken());
+            }
+        }
+        
+        void FgdParser::validateFlags(ParserStatus& status) {
+            Token token;
+            expect(status, FgdToken::Equality, token = m_tokenizer.nextToken());
+            expect(status, FgdToken::OBracket, token = m_tokenizer.nextToken());
+            expect(status, FgdToken::Integer | FgdToken::CBracket, token = m_tokenizer.nextToken());
+            while (token.type() != FgdToken::CBracket) {
+                expect(status, FgdToken::Colon, token = m_tokenizer.nextToken());
+                expect(status, FgdToken::String, token = m_tokenizer.nextToken());
+                
+                expect(status, FgdToken::Colon | FgdToken::Integer | FgdToken::CBracket, token = m_tokenizer.peekToken());
+                if (token.type() == FgdToken::Colon) {
+                    m_tokenizer.nextToken();
+                    expect(status, FgdToken::Integer, token = m_tokenizer.nextToken());
+                }
+                
+                expect(status, FgdToken::Integer | FgdToken::CBracket | FgdToken::Colon, token = m_tokenizer.nextToken());
+                if (token.type() == FgdToken::Colon) {
+                    expect(status, FgdToken::String, token = m_tokenizer.nextToken());
+                    expect(status, FgdToken::Integer | FgdToken::CBracket, token = m_tokenizer.nextToken());
+                }
+            }
+        }
+        
+        void FgdParser::skipAttributeString(ParserStatus& status) {
+            // an optional description or string default value, see parseAttributeDescription
+            Token token = m_tokenizer.peekToken();
+            if (token.type() == FgdToken::Colon) {
+                m_tokenizer.nextToken();
+                expect(status, FgdToken::String | FgdToken::Colon, token = m_tokenizer.peekToken());
+                if (token.type() == FgdToken::String)
+                    m_tokenizer.nextToken();
+            }
+        }
+
         Assets::AttributeDefinitionMap FgdParser::parseProperties(ParserStatus& status) {
             Assets::AttributeDefinitionMap attributes;
             
@@ -25,12 +25,17 @@
 #include "Color.h"
 #include "StringUtils.h"
 #include "Assets/AssetTypes.h"
+#include "Assets/EntityDefinition.h"
 #include "IO/EntityDefinitionClassInfo.h"
 #include "IO/EntityDefinitionParser.h"
+#include "IO/MappedFile.h"
 #include "IO/Parser.h"
 #include "IO/Token.h"
 #include "IO/Tokenizer.h"
 
+#include <map>
+#include <memory>
+
 namespace TrenchBroom {
     namespace IO {
         namespace FgdToken {
@@ -71,10 +76,23 @@ namespace TrenchBroom {
                 DefaultValue(const T& i_value) : present(true), value(i_value) {}
             };
             
+            /**
+             * The attribute block of a class, which is only parsed when the attributes of the class are first
+             * requested. Keeps the file alive until then, along with the attribute blocks of the base classes the
+             * class inherits from as they were defined when the class was parsed. The block is validated when the
+             * class is parsed, so its problems are reported to the status of that parse.
+             */
+            class AttributeSource;
+            typedef std::shared_ptr<AttributeSource> AttributeSourcePtr;
+            typedef std::map<String, AttributeSourcePtr> AttributeSourceMap;
+            
+            MappedFile::Ptr m_file;
             Color m_defaultEntityColor;
             FgdTokenizer m_tokenizer;
             EntityDefinitionClassInfoMap m_baseClasses;
+            AttributeSourceMap m_baseClassAttributes;
         public:
+            FgdParser(MappedFile::Ptr file, const Color& defaultEntityColor);
             FgdParser(const char* begin, const char* end, const Color& defaultEntityColor);
             FgdParser(const String& str, const Color& defaultEntityColor);
         private:
@@ -84,8 +102,9 @@ namespace TrenchBroom {
             Assets::EntityDefinition* parseDefinition(ParserStatus& status);
             Assets::EntityDefinition* parseSolidClass(ParserStatus& status);
             Assets::EntityDefinition* parsePointClass(ParserStatus& status);
-            EntityDefinitionClassInfo parseBaseClass(ParserStatus& status);
-            EntityDefinitionClassInfo parseClass(ParserStatus& status);
+            EntityDefinitionClassInfo parseBaseClass(ParserStatus& status, AttributeSourcePtr& attributes);
+            EntityDefinitionClassInfo parseClass(ParserStatus& status, AttributeSourcePtr& attributes);
+            Assets::AttributeDefinitionLoader attributeDefinitionLoader(AttributeSourcePtr attributes) const;
             void skipMainClass(ParserStatus& status);
             
             StringList parseSuperClasses(ParserStatus& status);
@@ -93,6 +112,10 @@ namespace TrenchBroom {
             String parseNamedValue(ParserStatus& status, const String& name);
             void skipClassAttribute(ParserStatus& status);
             
+            void validateProperties(ParserStatus& status);
+            void validateChoices(ParserStatus& status);
+            void validateFlags(ParserStatus& status);
+            void skipAttributeString(ParserStatus& status);
             Assets::AttributeDefinitionMap parseProperties(ParserStatus& status);
             Assets::AttributeDefinitionPtr parseTargetSourceAttribute(ParserStatus& status, const String& name);
             Assets::AttributeDefinitionPtr parseTargetDestinationAttribute(ParserStatus& status, const String& name);
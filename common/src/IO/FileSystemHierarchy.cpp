@@ -22,6 +22,7 @@
 #include "CollectionUtils.h"
 #include "StringUtils.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
 #include "IO/FileMatcher.h"
 #include "IO/IdPakFileSystem.h"
 
@@ -36,62 +37,168 @@ namespace TrenchBroom {
         void FileSystemHierarchy::addFileSystem(FileSystem* fileSystem) {
             ensure(fileSystem != nullptr, "fileSystem is null");
             m_fileSystems.push_back(fileSystem);
+            indexFileSystem(fileSystem);
         }
 
         void FileSystemHierarchy::clear() {
             VectorUtils::clearAndDelete(m_fileSystems);
+            m_files.clear();
+            m_directories.clear();
+        }
+        
+        void FileSystemHierarchy::updateIndex(const Path& path) {
+            const Path canonicalPath = path.makeCanonical();
+            const String key = indexKey(canonicalPath);
+            
+            m_files.erase(key);
+            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
+                FileSystem* fileSystem = *it;
+                if (fileSystem->fileExists(canonicalPath)) {
+                    FileEntry& file = m_files[key];
+                    file.fileSystem = fileSystem;
+                    file.path = canonicalPath;
+                    break;
+                }
+            }
+            
+            bool directory = false;
+            for (const FileSystem* fileSystem : m_fileSystems) {
+                if (fileSystem->directoryExists(canonicalPath)) {
+                    directory = true;
+                    break;
+                }
+            }
+            
+            if (directory) {
+                m_directories[key];
+                addDirectoryEntry(canonicalPath);
+            } else {
+                m_directories.erase(key);
+                if (m_files.count(key) > 0)
+                    addDirectoryEntry(canonicalPath);
+                else
+                    removeDirectoryEntry(canonicalPath);
+            }
+        }
+        
+        void FileSystemHierarchy::indexFileSystem(FileSystem* fileSystem) {
+            if (fileSystem->directoryExists(Path(""))) {
+                StringSet ancestors;
+                indexDirectory(fileSystem, Path(""), ancestors, 0);
+            }
+        }
+        
+        void FileSystemHierarchy::indexDirectory(FileSystem* fileSystem, const Path& path, StringSet& ancestors, const size_t depth) {
+            // guards against directory cycles that cannot be detected by resolving symbolic links
+            static const size_t MaxDepth = 64;
+            
+            DirectoryContents& contents = m_directories[indexKey(path)];
+            if (depth >= MaxDepth)
+                return;
+            
+            // A symbolic link to one of its ancestors makes a directory contain itself. Such a directory is listed,
+            // but its contents are not indexed again.
+            const String canonicalPath = Disk::resolveSymbolicLinks(fileSystem->makeAbsolute(path)).asString();
+            if (!ancestors.insert(canonicalPath).second)
+                return;
+            
+            Path::List entries;
+            try {
+                entries = fileSystem->getDirectoryContents(path);
+            } catch (const FileSystemException&) {
+                ancestors.erase(canonicalPath);
+                return;
+            }
+            
+            for (const Path& entry : entries) {
+                const Path entryPath = path + entry;
+                contents[indexKey(entry)] = entry;
+                
+                if (fileSystem->directoryExists(entryPath)) {
+                    indexDirectory(fileSystem, entryPath, ancestors, depth + 1);
+                } else {
+                    FileEntry& file = m_files[indexKey(entryPath)];
+                    file.fileSystem = fileSystem;
+                    file.path = entryPath;
+                }
+            }
+            
+            ancestors.erase(canonicalPath);
+        }
+        
+        void FileSystemHierarchy::addDirectoryEntry(const Path& path) {
+            Path current = path;
+            while (!current.isEmpty()) {
+                const Path parent = current.deleteLastComponent();
+                const Path name = current.lastComponent();
+                m_directories[indexKey(parent)][indexKey(name)] = name;
+                current = parent;
+            }
+        }
+        
+        void FileSystemHierarchy::removeDirectoryEntry(const Path& path) {
+            if (path.isEmpty())
+                return;
+            
+            const auto it = m_directories.find(indexKey(path.deleteLastComponent()));
+            if (it != std::end(m_directories))
+                it->second.erase(indexKey(path.lastComponent()));
+        }
+        
+        String FileSystemHierarchy::indexKey(const Path& path) {
+            return path.makeLowerCase().asString();
         }
 
         Path FileSystemHierarchy::doMakeAbsolute(const Path& relPath) const {
-            const FileSystem* fileSystem = findFileSystemContaining(relPath);
-            if (fileSystem != nullptr)
-                return fileSystem->makeAbsolute(relPath);
+            const FileEntry* file = findFile(relPath);
+            if (file != nullptr)
+                return file->fileSystem->makeAbsolute(file->path);
             return Path("");
         }
 
         bool FileSystemHierarchy::doDirectoryExists(const Path& path) const {
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                const FileSystem* fileSystem = *it;
-                if (fileSystem->directoryExists(path))
-                    return true;
-            }
-            return false;
+            return m_directories.count(indexKey(path.makeCanonical())) > 0;
         }
         
         bool FileSystemHierarchy::doFileExists(const Path& path) const {
-            return (findFileSystemContaining(path)) != nullptr;
+            return findFile(path) != nullptr;
         }
         
-        FileSystem* FileSystemHierarchy::findFileSystemContaining(const Path& path) const {
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                FileSystem* fileSystem = *it;
-                if (fileSystem->fileExists(path))
-                    return fileSystem;
-            }
-            return nullptr;
+        const FileSystemHierarchy::FileEntry* FileSystemHierarchy::findFile(const Path& path) const {
+            const auto it = m_files.find(indexKey(path.makeCanonical()));
+            if (it == std::end(m_files))
+                return nullptr;
+            return &it->second;
         }
 
         Path::List FileSystemHierarchy::doGetDirectoryContents(const Path& path) const {
             Path::List result;
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                const FileSystem* fileSystem = *it;
-                if (fileSystem->directoryExists(path)) {
-                    const Path::List contents = fileSystem->getDirectoryContents(path);
-                    VectorUtils::append(result, contents);
-                }
+            const auto it = m_directories.find(indexKey(path.makeCanonical()));
+            if (it != std::end(m_directories)) {
+                for (const auto& entry : it->second)
+                    result.push_back(entry.second);
             }
             
-            VectorUtils::sortAndRemoveDuplicates(result);
+            VectorUtils::sort(result);
             return result;
         }
         
         const MappedFile::Ptr FileSystemHierarchy::doOpenFile(const Path& path) const {
+            const FileEntry* file = findFile(path);
+            if (file == nullptr)
+                return MappedFile::Ptr();
+            
+            const MappedFile::Ptr result = file->fileSystem->openFile(file->path);
+            if (result.get() != nullptr)
+                return result;
+            
+            // fall back to the file systems that are shadowed by the one containing the file
             for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
                 const FileSystem* fileSystem = *it;
-                if (fileSystem->fileExists(path)) {
-                    const MappedFile::Ptr file = fileSystem->openFile(path);
-                    if (file.get() != nullptr)
-                        return file;
+                if (fileSystem != file->fileSystem && fileSystem->fileExists(file->path)) {
+                    const MappedFile::Ptr shadowed = fileSystem->openFile(file->path);
+                    if (shadowed.get() != nullptr)
+                        return shadowed;
                 }
             }
             return MappedFile::Ptr();
@@ -115,29 +222,44 @@ namespace TrenchBroom {
             m_writableFileSystem = nullptr;
         }
 
+        Path WritableFileSystemHierarchy::destinationPath(const Path& sourcePath, const Path& destPath) const {
+            // a file that is copied or moved into a directory keeps its name
+            if (m_writableFileSystem->directoryExists(destPath))
+                return destPath + sourcePath.lastComponent();
+            return destPath;
+        }
+
         void WritableFileSystemHierarchy::doCreateFile(const Path& path, const String& contents) {
             ensure(m_writableFileSystem != nullptr, "writableFileSystem is null");
             m_writableFileSystem->createFile(path, contents);
+            updateIndex(path);
         }
 
         void WritableFileSystemHierarchy::doCreateDirectory(const Path& path) {
             ensure(m_writableFileSystem != nullptr, "writableFileSystem is null");
             m_writableFileSystem->createDirectory(path);
+            updateIndex(path);
         }
         
         void WritableFileSystemHierarchy::doDeleteFile(const Path& path) {
             ensure(m_writableFileSystem != nullptr, "writableFileSystem is null");
             m_writableFileSystem->deleteFile(path);
+            updateIndex(path);
         }
         
         void WritableFileSystemHierarchy::doCopyFile(const Path& sourcePath, const Path& destPath, const bool overwrite) {
             ensure(m_writableFileSystem != nullptr, "writableFileSystem is null");
+            const Path actualDestPath = destinationPath(sourcePath, destPath);
             m_writableFileSystem->copyFile(sourcePath, destPath, overwrite);
+            updateIndex(actualDestPath);
         }
         
         void WritableFileSystemHierarchy::doMoveFile(const Path& sourcePath, const Path& destPath, const bool overwrite) {
             ensure(m_writableFileSystem != nullptr, "writableFileSystem is null");
+            const Path actualDestPath = destinationPath(sourcePath, destPath);
             m_writableFileSystem->moveFile(sourcePath, destPath, overwrite);
+            updateIndex(sourcePath);
+            updateIndex(actualDestPath);
         }
     }
 }
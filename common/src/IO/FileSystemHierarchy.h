@@ -26,27 +26,57 @@
 #include "IO/FileSystem.h"
 #include "IO/Path.h"
 
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         class Path;
         
+        /**
+         * Merges a list of file systems, where a file in a file system shadows the files with the same path in the
+         * file systems that were added before it. Paths are case insensitive.
+         *
+         * The entries of every file system are indexed when it is added, so that the file system containing a
+         * file and the contents of a directory are found without asking every file system. Changes made through a
+         * WritableFileSystemHierarchy update the index for the affected paths only.
+         */
         class FileSystemHierarchy : public virtual FileSystem {
         private:
             typedef std::vector<FileSystem*> FileSystemList;
+            
+            struct FileEntry {
+                FileSystem* fileSystem;
+                Path path;
+            };
+            
+            typedef std::unordered_map<String, FileEntry> FileIndex;
+            typedef std::map<String, Path> DirectoryContents;
+            typedef std::unordered_map<String, DirectoryContents> DirectoryIndex;
+            
             FileSystemList m_fileSystems;
+            FileIndex m_files;
+            DirectoryIndex m_directories;
         public:
             FileSystemHierarchy();
             virtual ~FileSystemHierarchy();
             
             void addFileSystem(FileSystem* fileSystem);
             virtual void clear();
+        protected:
+            void updateIndex(const Path& path);
         private:
+            void indexFileSystem(FileSystem* fileSystem);
+            void indexDirectory(FileSystem* fileSystem, const Path& path, StringSet& ancestors, size_t depth);
+            void addDirectoryEntry(const Path& path);
+            void removeDirectoryEntry(const Path& path);
+            static String indexKey(const Path& path);
+            
             Path doMakeAbsolute(const Path& relPath) const;
             bool doDirectoryExists(const Path& path) const;
             bool doFileExists(const Path& path) const;
-            FileSystem* findFileSystemContaining(const Path& path) const;
+            const FileEntry* findFile(const Path& path) const;
             
             Path::List doGetDirectoryContents(const Path& path) const;
             const MappedFile::Ptr doOpenFile(const Path& path) const;
@@ -69,6 +99,8 @@ namespace TrenchBroom {
             void addWritableFileSystem(WritableFileSystem* fileSystem);
             void clear();
         private:
+            Path destinationPath(const Path& sourcePath, const Path& destPath) const;
+            
             void doCreateFile(const Path& path, const String& contents);
             void doCreateDirectory(const Path& path);
             void doDeleteFile(const Path& path);
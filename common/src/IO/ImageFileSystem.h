@@ -50,8 +50,8 @@ namespace TrenchBroom {
             
             class Directory {
             private:
-                typedef std::map<Path, Directory*, Path::Less<StringUtils::CaseInsensitiveStringLess>> DirMap;
-                typedef std::map<Path, File*,      Path::Less<StringUtils::CaseInsensitiveStringLess>> FileMap;
+                typedef std::map<Path, Directory*, Path::Less<StringUtils::CaseInsensitiveCharCompare>> DirMap;
+                typedef std::map<Path, File*,      Path::Less<StringUtils::CaseInsensitiveCharCompare>> FileMap;
                 
                 Path m_path;
                 DirMap m_directories;
@@ -224,8 +224,9 @@ namespace TrenchBroom {
             if (m_filedesc >= 0) {
                 m_size = static_cast<size_t>(lseek(m_filedesc, 0, SEEK_END));
                 lseek(m_filedesc, 0, SEEK_SET);
-                m_address = static_cast<char*>(mmap(nullptr, m_size, prot, MAP_FILE | MAP_PRIVATE, m_filedesc, 0));
-                if (m_address != nullptr) {
+                void* address = mmap(nullptr, m_size, prot, MAP_FILE | MAP_PRIVATE, m_filedesc, 0);
+                if (address != MAP_FAILED) {
+                    m_address = static_cast<char*>(address);
                     init(m_address, m_address + m_size);
                 } else {
                     close(m_filedesc);
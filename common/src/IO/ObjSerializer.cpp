@@ -20,14 +20,25 @@
 #include "ObjSerializer.h"
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
 
+#include <algorithm>
 #include <cassert>
 
 namespace TrenchBroom {
     namespace IO {
+        template <typename V>
+        size_t ObjFileSerializer::BrushElements<V>::index(const V& v) {
+            const auto it = std::find(std::begin(values), std::end(values), v);
+            if (it != std::end(values))
+                return static_cast<size_t>(std::distance(std::begin(values), it));
+            values.push_back(v);
+            return values.size() - 1;
+        }
+
         ObjFileSerializer::IndexedVertex::IndexedVertex(const size_t i_vertex, const size_t i_texCoords, const size_t i_normal) :
         vertex(i_vertex),
         texCoords(i_texCoords),
@@ -36,62 +47,115 @@ namespace TrenchBroom {
         ObjFileSerializer::ObjFileSerializer(FILE* stream) :
         m_stream(stream) {
             ensure(m_stream != nullptr, "stream is null");
+            m_buffer.reserve(BufferSize);
         }
 
         void ObjFileSerializer::doBeginFile() {}
         
         void ObjFileSerializer::doEndFile() {
-            writeVertices();
-            std::fprintf(m_stream, "\n");
-            writeTexCoords();
-            std::fprintf(m_stream, "\n");
-            writeNormals();
-            std::fprintf(m_stream, "\n");
-            writeObjects();
+            writeBrushes();
+            flush();
         }
 
-        void ObjFileSerializer::writeVertices() {
-            std::fprintf(m_stream, "# vertices\n");
-            for (const Vec3& elem : m_vertices.list())
-                std::fprintf(m_stream, "v %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
-        }
-        
-        void ObjFileSerializer::writeTexCoords() {
-            std::fprintf(m_stream, "# texture coordinates\n");
-            for (const Vec2f& elem : m_texCoords.list())
-                std::fprintf(m_stream, "vt %.17g %.17g\n", elem.x(), elem.y());
+        void ObjFileSerializer::writeBrushes() {
+            const std::vector<BrushData> data = ParallelUtils::transform<BrushData>(m_brushes, buildBrush);
+            for (size_t i = 0; i < m_brushes.size(); ++i)
+                writeBrush(m_brushes[i], data[i]);
+            m_brushes.clear();
         }
-        
-        void ObjFileSerializer::writeNormals() {
-            std::fprintf(m_stream, "# face normals\n");
-            for (const Vec3& elem : m_normals.list())
-                std::fprintf(m_stream, "vn %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
-        }
-        
-        void ObjFileSerializer::writeObjects() {
-            std::fprintf(m_stream, "# objects\n");
-            for (const Object& object : m_objects) {
-            ObjectList::const_iterator fIt, fEnd;
-                std::fprintf(m_stream, "o entity%u_brush%u\n",
-                             static_cast<unsigned long>(object.entityNo),
-                             static_cast<unsigned long>(object.brushNo));
-                
-                writeFaces(object.faces);
-                std::fprintf(m_stream, "\n");
+
+        ObjFileSerializer::BrushData ObjFileSerializer::buildBrush(const BrushEntry& brush) {
+            BrushData data;
+            data.faces.reserve(brush.faces.size());
+
+            for (const Model::BrushFace* face : brush.faces) {
+                const size_t normalIndex = data.normals.index(face->boundary().normal);
+
+                const Model::BrushFace::VertexList vertices = face->vertices();
+                IndexedVertexList indexedVertices;
+                indexedVertices.reserve(vertices.size());
+
+                for (const Model::BrushVertex* vertex : vertices) {
+                    const Vec3& position = vertex->position();
+                    const Vec2f texCoords = face->textureCoords(position);
+
+                    const size_t vertexIndex = data.vertices.index(position);
+                    const size_t texCoordsIndex = data.texCoords.index(texCoords);
+                    indexedVertices.push_back(IndexedVertex(vertexIndex, texCoordsIndex, normalIndex));
+                }
+
+                data.faces.push_back(indexedVertices);
+            }
+
+            char line[128];
+            for (const Vec3& elem : data.vertices.values) {
+                std::snprintf(line, sizeof(line), "v %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
+                data.vertices.lines.push_back(line);
             }
+            for (const Vec2f& elem : data.texCoords.values) {
+                std::snprintf(line, sizeof(line), "vt %.17g %.17g\n", elem.x(), elem.y());
+                data.texCoords.lines.push_back(line);
+            }
+            for (const Vec3& elem : data.normals.values) {
+                std::snprintf(line, sizeof(line), "vn %.17g %.17g %.17g\n", elem.x(), elem.z(), -elem.y()); // no idea why I have to switch Y and Z
+                data.normals.lines.push_back(line);
+            }
+
+            return data;
         }
 
-        void ObjFileSerializer::writeFaces(const FaceList& faces) {
-            for (const IndexedVertexList& face : faces) {
-                std::fprintf(m_stream, "f");
+        void ObjFileSerializer::writeBrush(const BrushEntry& brush, const BrushData& data) {
+            char line[64];
+            std::snprintf(line, sizeof(line), "o entity%lu_brush%lu\n",
+                          static_cast<unsigned long>(brush.entityNo),
+                          static_cast<unsigned long>(brush.brushNo));
+            write(line);
+
+            const std::vector<size_t> vertexIndices = writeElements(m_vertices, data.vertices);
+            const std::vector<size_t> texCoordsIndices = writeElements(m_texCoords, data.texCoords);
+            const std::vector<size_t> normalIndices = writeElements(m_normals, data.normals);
+
+            for (const IndexedVertexList& face : data.faces) {
+                write("f", 1);
                 for (const IndexedVertex& vertex : face) {
-                    std::fprintf(m_stream, " %u/%u/%u",
-                                 static_cast<unsigned long>(vertex.vertex) + 1,
-                                 static_cast<unsigned long>(vertex.texCoords) + 1,
-                                 static_cast<unsigned long>(vertex.normal) + 1);
+                    const int length = std::snprintf(line, sizeof(line), " %lu/%lu/%lu",
+                                                     static_cast<unsigned long>(vertexIndices[vertex.vertex]) + 1,
+                                                     static_cast<unsigned long>(texCoordsIndices[vertex.texCoords]) + 1,
+                                                     static_cast<unsigned long>(normalIndices[vertex.normal]) + 1);
+                    write(line, static_cast<size_t>(length));
                 }
-                std::fprintf(m_stream, "\n");
+                write("\n", 1);
+            }
+            write("\n", 1);
+        }
+
+        template <typename V>
+        std::vector<size_t> ObjFileSerializer::writeElements(IndexMap<V>& indices, const BrushElements<V>& elements) {
+            std::vector<size_t> result;
+            result.reserve(elements.values.size());
+
+            for (size_t i = 0; i < elements.values.size(); ++i) {
+                const std::pair<size_t, bool> index = indices.index(elements.values[i]);
+                if (index.second)
+                    write(elements.lines[i]);
+                result.push_back(index.first);
             }
+            return result;
+        }
+
+        void ObjFileSerializer::write(const String& str) {
+            write(str.data(), str.size());
+        }
+
+        void ObjFileSerializer::write(const char* str, const size_t length) {
+            if (m_buffer.size() + length > BufferSize)
+                flush();
+            m_buffer.append(str, length);
+        }
+
+        void ObjFileSerializer::flush() {
+            std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_stream);
+            m_buffer.clear();
         }
 
         void ObjFileSerializer::doBeginEntity(const Model::Node* node) {}
@@ -99,35 +163,20 @@ namespace TrenchBroom {
         void ObjFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {}
         
         void ObjFileSerializer::doBeginBrush(const Model::Brush* brush) {
-            m_currentObject.entityNo = entityNo();
-            m_currentObject.brushNo = brushNo();
+            BrushEntry entry;
+            entry.entityNo = entityNo();
+            entry.brushNo = brushNo();
+            m_brushes.push_back(entry);
         }
         
         void ObjFileSerializer::doEndBrush(Model::Brush* brush) {
-            m_objects.push_back(m_currentObject);
-            m_currentObject.faces.clear();
+            if (m_brushes.size() >= BatchSize)
+                writeBrushes();
         }
         
         void ObjFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const Vec3& normal = face->boundary().normal;
-            const size_t normalIndex = m_normals.index(normal);
-            
-            const Model::BrushFace::VertexList vertices = face->vertices();
-            IndexedVertexList indexedVertices;
-            indexedVertices.reserve(vertices.size());
-            
-            for (const Model::BrushVertex* vertex : vertices) {
-            Model::BrushFace::VertexList::const_iterator it, end;
-                const Vec3& position = vertex->position();
-                const Vec2f texCoords = face->textureCoords(position);
-                
-                const size_t vertexIndex = m_vertices.index(position);
-                const size_t texCoordsIndex = m_texCoords.index(texCoords);
-                
-                indexedVertices.push_back(IndexedVertex(vertexIndex, texCoordsIndex, normalIndex));
-            }
-            
-            m_currentObject.faces.push_back(indexedVertices);
+            assert(!m_brushes.empty());
+            m_brushes.back().faces.push_back(face);
         }
     }
 }
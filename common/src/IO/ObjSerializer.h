@@ -21,40 +21,74 @@
 #define ObjSerializer_h
 
 #include "IO/NodeSerializer.h"
+#include "StringUtils.h"
 #include "VecMath.h"
 #include "Model/ModelTypes.h"
 
 #include <cstdio>
-#include <list>
-#include <map>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Writes the brushes of a map as an OBJ file.
+         *
+         * Brushes are collected in batches. The vertex data of the brushes in a batch is computed and formatted
+         * concurrently, and then the batch is written to the file. Each vertex, texture coordinate and normal is
+         * written once, before the first face that refers to it, so only the indices of the elements written so
+         * far must be kept in memory.
+         */
         class ObjFileSerializer : public NodeSerializer {
+        public:
+            static const size_t BatchSize = 1024;
         private:
+            static const size_t BufferSize = 64 * 1024;
+
+            template <typename V>
+            struct VecHash {
+                size_t operator()(const V& v) const {
+                    std::hash<typename V::Type> hash;
+                    size_t result = 0;
+                    for (size_t i = 0; i < V::Size; ++i) {
+                        // 0.0 and -0.0 are equal, so they must have the same hash
+                        const typename V::Type c = v[i] == static_cast<typename V::Type>(0) ? static_cast<typename V::Type>(0) : v[i];
+                        result ^= hash(c) + 0x9e3779b9 + (result << 6) + (result >> 2);
+                    }
+                    return result;
+                }
+            };
+
+            /**
+             * Assigns indices to distinct values in the order in which they are first seen.
+             */
             template <typename V>
             class IndexMap {
-            public:
-                typedef std::vector<V> List;
             private:
-                typedef std::map<V, size_t> Map;
+                typedef std::unordered_map<V, size_t, VecHash<V>> Map;
                 Map m_map;
-                List m_list;
             public:
-                const List& list() const {
-                    return m_list;
-                }
-                
-                size_t index(const V& v) {
-                    typename Map::iterator indexIt = MapUtils::findOrInsert(m_map, v, m_list.size());
-                    const size_t index = indexIt->second;
-                    if (index == m_list.size())
-                        m_list.push_back(v);
-                    return index;
+                /**
+                 * Returns the index of the given value and whether the value was seen for the first time.
+                 */
+                std::pair<size_t, bool> index(const V& v) {
+                    const auto result = m_map.insert(std::make_pair(v, m_map.size()));
+                    return std::make_pair(result.first->second, result.second);
                 }
             };
 
+            /**
+             * The distinct elements of a brush along with the lines that declare them in the file.
+             */
+            template <typename V>
+            struct BrushElements {
+                std::vector<V> values;
+                StringList lines;
+
+                size_t index(const V& v);
+            };
+
             struct IndexedVertex {
                 size_t vertex;
                 size_t texCoords;
@@ -62,42 +96,55 @@ namespace TrenchBroom {
 
                 IndexedVertex(size_t i_vertex, size_t i_texCoords, size_t i_normal);
             };
-            
+
             typedef std::vector<IndexedVertex> IndexedVertexList;
-            typedef std::list<IndexedVertexList> FaceList;
+            typedef std::vector<IndexedVertexList> FaceList;
 
-            struct Object {
+            struct BrushEntry {
                 size_t entityNo;
                 size_t brushNo;
+                Model::BrushFaceList faces;
+            };
+
+            /**
+             * The vertex data of a single brush. The indices of its faces refer to the elements of the brush.
+             */
+            struct BrushData {
+                BrushElements<Vec3> vertices;
+                BrushElements<Vec2f> texCoords;
+                BrushElements<Vec3> normals;
                 FaceList faces;
             };
-            
-            typedef std::list<Object> ObjectList;
-            
+
             FILE* m_stream;
+            String m_buffer;
 
             IndexMap<Vec3> m_vertices;
             IndexMap<Vec2f> m_texCoords;
             IndexMap<Vec3> m_normals;
 
-            Object m_currentObject;
-            ObjectList m_objects;
+            std::vector<BrushEntry> m_brushes;
         public:
             ObjFileSerializer(FILE* stream);
         private:
             void doBeginFile();
             void doEndFile();
-            
-            void writeVertices();
-            void writeTexCoords();
-            void writeNormals();
-            void writeObjects();
-            void writeFaces(const FaceList& faces);
-            
+
+            void writeBrushes();
+            static BrushData buildBrush(const BrushEntry& brush);
+            void writeBrush(const BrushEntry& brush, const BrushData& data);
+
+            template <typename V>
+            std::vector<size_t> writeElements(IndexMap<V>& indices, const BrushElements<V>& elements);
+
+            void write(const String& str);
+            void write(const char* str, size_t length);
+            void flush();
+
             void doBeginEntity(const Model::Node* node);
             void doEndEntity(Model::Node* node);
             void doEntityAttribute(const Model::EntityAttribute& attribute);
-            
+
             void doBeginBrush(const Model::Brush* brush);
             void doEndBrush(Model::Brush* brush);
             void doBrushFace(Model::BrushFace* face);
@@ -43,15 +43,32 @@ namespace TrenchBroom {
             return sep;
         }
 
-        Path::Path(bool absolute, const StringList& components) :
-        m_components(components),
+        namespace {
+            struct ByteCompare {
+                int operator()(const char lhs, const char rhs) const {
+                    return static_cast<int>(static_cast<unsigned char>(lhs)) - static_cast<int>(static_cast<unsigned char>(rhs));
+                }
+            };
+        }
+
+        Path::Path(const bool absolute, const String& path) :
+        m_path(path),
+        m_absolute(absolute) {}
+
+        Path::Path(const bool absolute, const StringList& components) :
+        m_path(StringUtils::join(components, '/')),
         m_absolute(absolute) {}
 
         Path::Path(const String& path) {
             const String trimmed = StringUtils::trim(path);
-            m_components = StringUtils::split(trimmed, separators());
+            const size_t first = trimmed.find_first_not_of(separators());
+            if (first != String::npos) {
+                const size_t last = trimmed.find_last_not_of(separators());
+                m_path = trimmed.substr(first, last - first + 1);
+                std::replace(std::begin(m_path), std::end(m_path), '\\', '/');
+            }
 #ifdef _WIN32
-            m_absolute = (hasDriveSpec(m_components) ||
+            m_absolute = (hasDriveSpec(m_path) ||
                           (!trimmed.empty() && trimmed[0] == '/') ||
                           (!trimmed.empty() && trimmed[0] == '\\'));
 #else
@@ -62,9 +79,17 @@ namespace TrenchBroom {
         Path Path::operator+(const Path& rhs) const {
             if (rhs.isAbsolute())
                 throw PathException("Cannot concatenate absolute path");
-            StringList components = m_components;
-            components.insert(std::end(components), std::begin(rhs.m_components), std::end(rhs.m_components));
-            return Path(m_absolute, components);
+            if (rhs.m_path.empty())
+                return *this;
+            if (m_path.empty())
+                return Path(m_absolute, rhs.m_path);
+            
+            String path;
+            path.reserve(m_path.size() + 1 + rhs.m_path.size());
+            path.append(m_path);
+            path.push_back('/');
+            path.append(rhs.m_path);
+            return Path(m_absolute, path);
         }
 
         int Path::compare(const Path& rhs) const {
@@ -72,30 +97,11 @@ namespace TrenchBroom {
                 return -1;
             if (isAbsolute() && !rhs.isAbsolute())
                 return 1;
-            
-            const StringList& rcomps = rhs.m_components;
-            
-            size_t i = 0;
-            const size_t max = std::min(m_components.size(), rcomps.size());
-            while (i < max) {
-                const String& mcomp = m_components[i];
-                const String& rcomp = rcomps[i];
-                const int result = mcomp.compare(rcomp);
-                if (result < 0)
-                    return -1;
-                if (result > 0)
-                    return 1;
-                ++i;
-            }
-            if (m_components.size() < rcomps.size())
-                return -1;
-            if (m_components.size() > rcomps.size())
-                return 1;
-            return 0;
+            return compareComponents(m_path, rhs.m_path, ByteCompare());
         }
 
         bool Path::operator==(const Path& rhs) const {
-            return compare(rhs) == 0;
+            return m_absolute == rhs.m_absolute && m_path == rhs.m_path;
         }
 
         bool Path::operator!= (const Path& rhs) const {
@@ -111,31 +117,30 @@ namespace TrenchBroom {
         }
 
         String Path::asString(const char separator) const {
-            if (m_absolute) {
-#ifdef _WIN32
-                if (hasDriveSpec(m_components))
-                    return StringUtils::join(m_components, separator);
-                else
-                    return separator + StringUtils::join(m_components, separator);
-#else
-                return separator + StringUtils::join(m_components, separator);
-#endif
-            }
-            return StringUtils::join(m_components, separator);
+            String result;
+            result.reserve(m_path.size() + 1);
+            if (m_absolute && !hasDriveSpec(m_path))
+                result.push_back(separator);
+            result.append(m_path);
+            if (separator != '/')
+                std::replace(std::begin(result), std::end(result), '/', separator);
+            return result;
         }
 
         String Path::asString(const String& separator) const {
-            if (m_absolute) {
-#ifdef _WIN32
-                if (hasDriveSpec(m_components))
-                    return StringUtils::join(m_components, separator);
+            if (separator.size() == 1)
+                return asString(separator[0]);
+            
+            String result;
+            if (m_absolute && !hasDriveSpec(m_path))
+                result.append(separator);
+            for (const char c : m_path) {
+                if (c == '/')
+                    result.append(separator);
                 else
-                    return separator + StringUtils::join(m_components, separator);
-#else
-                return separator + StringUtils::join(m_components, separator);
-#endif
+                    result.push_back(c);
             }
-            return StringUtils::join(m_components, separator);
+            return result;
         }
 
         StringList Path::asStrings(const Path::List& paths, const char separator) {
@@ -155,21 +160,23 @@ namespace TrenchBroom {
         }
 
         size_t Path::length() const {
-            return m_components.size();
+            if (m_path.empty())
+                return 0;
+            return static_cast<size_t>(std::count(std::begin(m_path), std::end(m_path), '/')) + 1;
         }
 
         bool Path::isEmpty() const {
-            return !m_absolute && m_components.empty();
+            return !m_absolute && m_path.empty();
         }
 
         Path Path::firstComponent() const {
             if (isEmpty())
                 throw PathException("Cannot return first component of empty path");
             if (!m_absolute)
-                return Path(m_components.front());
+                return Path(false, m_path.substr(0, m_path.find('/')));
 #ifdef _WIN32
-            if (hasDriveSpec(m_components))
-                return Path(m_components.front());
+            if (hasDriveSpec(m_path))
+                return Path(true, m_path.substr(0, m_path.find('/')));
             return Path("\\");
 #else
             return Path("/");
@@ -179,30 +186,24 @@ namespace TrenchBroom {
         Path Path::deleteFirstComponent() const {
             if (isEmpty())
                 throw PathException("Cannot delete first component of empty path");
-            if (!m_absolute) {
-                StringList components;
-                components.reserve(m_components.size() - 1);
-                components.insert(std::begin(components), std::begin(m_components) + 1, std::end(m_components));
-                return Path(false, components);
-            }
 #ifdef _WIN32
-            if (!m_components.empty() && hasDriveSpec(m_components[0])) {
-                StringList components;
-                components.reserve(m_components.size() - 1);
-                components.insert(std::begin(components), std::begin(m_components) + 1, std::end(m_components));
-                return Path(false, components);
-            }
-            return Path(false, m_components);
+            if (!m_absolute || hasDriveSpec(m_path)) {
 #else
-            return Path(false, m_components);
+            if (!m_absolute) {
 #endif
+                const size_t pos = m_path.find('/');
+                if (pos == String::npos)
+                    return Path(false, String());
+                return Path(false, m_path.substr(pos + 1));
+            }
+            return Path(false, m_path);
         }
 
         Path Path::lastComponent() const {
             if (isEmpty())
                 throw PathException("Cannot return last component of empty path");
-            if (!m_components.empty()) {
-                return Path(m_components.back());
+            if (!m_path.empty()) {
+                return Path(filename());
             } else {
                 return Path("");
             }
@@ -211,14 +212,10 @@ namespace TrenchBroom {
         Path Path::deleteLastComponent() const {
             if (isEmpty())
                 throw PathException("Cannot delete last component of empty path");
-            if (!m_components.empty()) {
-                StringList components;
-                components.reserve(m_components.size() - 1);
-                components.insert(std::begin(components), std::begin(m_components), std::end(m_components) - 1);
-                return Path(m_absolute, components);
-            } else {
-                return Path(m_absolute, m_components);
-            }
+            const size_t pos = m_path.rfind('/');
+            if (pos == String::npos)
+                return Path(m_absolute, String());
+            return Path(m_absolute, m_path.substr(0, pos));
         }
 
         Path Path::prefix(const size_t count) const {
@@ -226,32 +223,28 @@ namespace TrenchBroom {
         }
         
         Path Path::suffix(const size_t count) const {
-            return subPath(m_components.size() - count, count);
+            return subPath(length() - count, count);
         }
         
         Path Path::subPath(const size_t index, const size_t count) const {
-            if (index + count > m_components.size())
+            const size_t length = this->length();
+            if (index + count > length)
                 throw PathException("Sub path out of bounds");
             if (count == 0)
                 return Path("");
             
-            auto begin = std::begin(m_components);
-            std::advance(begin, static_cast<StringList::const_iterator::difference_type>(index));
-            auto end = begin;
-            std::advance(end, static_cast<StringList::const_iterator::difference_type>(count));
-            StringList newComponents(count);
-            std::copy(begin, end, std::begin(newComponents));
-            return Path(m_absolute && index == 0, newComponents);
+            const size_t begin = componentOffset(index);
+            const size_t end = index + count == length ? m_path.size() : componentOffset(index + count) - 1;
+            return Path(m_absolute && index == 0, m_path.substr(begin, end - begin));
         }
 
         String Path::filename() const {
             if (isEmpty())
                 throw PathException("Cannot get filename of empty path");
-            if (m_components.empty()) {
-                return "";
-            } else {
-                return m_components.back();
-            }
+            const size_t pos = m_path.rfind('/');
+            if (pos == String::npos)
+                return m_path;
+            return m_path.substr(pos + 1);
         }
         
         String Path::basename() const {
@@ -281,17 +274,13 @@ namespace TrenchBroom {
         Path Path::addExtension(const String& extension) const {
             if (isEmpty())
                 throw PathException("Cannot add extension to empty path");
-            auto components = m_components;
-            if (components.empty()
+            if (m_path.empty())
+                return Path(m_absolute, "." + extension);
 #ifdef _WIN32
-				|| hasDriveSpec(m_components.back())
+            if (m_path.find('/') == String::npos && hasDriveSpec(m_path))
+                return Path(m_absolute, m_path + "/." + extension);
 #endif
-				) {
-                components.push_back("." + extension);
-            } else {
-                components.back() += "." + extension;
-            }
-            return Path(m_absolute, components);
+            return Path(m_absolute, m_path + "." + extension);
         }
 
         Path Path::replaceExtension(const String& extension) const {
@@ -307,9 +296,9 @@ namespace TrenchBroom {
                     isAbsolute() && absolutePath.isAbsolute()
 #ifdef _WIN32
                     && 
-                    !m_components.empty() && !absolutePath.m_components.empty()
+                    !m_path.empty() && !absolutePath.m_path.empty()
                     &&
-                    m_components[0] == absolutePath.m_components[0]
+                    m_path.substr(0, m_path.find('/')) == absolutePath.m_path.substr(0, absolutePath.m_path.find('/'))
 #endif
             );
         }
@@ -332,17 +321,20 @@ namespace TrenchBroom {
             if (!absolutePath.isAbsolute())
                 throw PathException("Cannot make relative path with relative sub path");
 
+            const StringList myComponents = components();
+            const StringList theirComponents = absolutePath.components();
+            
 #ifdef _WIN32
-            if (m_components.empty())
+            if (myComponents.empty())
                 throw PathException("Cannot make relative path from an reference path with no drive spec");
-            if (absolutePath.m_components.empty())
+            if (theirComponents.empty())
                 throw PathException("Cannot make relative path with sub path with no drive spec");
-            if (m_components[0] != absolutePath.m_components[0])
+            if (myComponents[0] != theirComponents[0])
                 throw PathException("Cannot make relative path if reference path has different drive spec");
 #endif
             
-            const StringList myResolved = resolvePath(true, m_components);
-            const StringList theirResolved = resolvePath(true, absolutePath.m_components);
+            const StringList myResolved = resolvePath(true, myComponents);
+            const StringList theirResolved = resolvePath(true, theirComponents);
             
             // cross off all common prefixes
             size_t p = 0;
@@ -362,15 +354,14 @@ namespace TrenchBroom {
         }
 
         Path Path::makeCanonical() const {
-            return Path(m_absolute, resolvePath(m_absolute, m_components));
+            // most paths are canonical already, so avoid splitting them up
+            if (!hasDotComponents())
+                return *this;
+            return Path(m_absolute, resolvePath(m_absolute, components()));
         }
 
         Path Path::makeLowerCase() const {
-            StringList lcComponents;
-            lcComponents.reserve(m_components.size());
-            std::transform(std::begin(m_components), std::end(m_components), std::back_inserter(lcComponents),
-                           [](const String& component) { return StringUtils::toLower(component); });
-            return Path(m_absolute, lcComponents);
+            return Path(m_absolute, StringUtils::toLower(m_path));
         }
 
         Path::List Path::makeAbsoluteAndCanonical(const List& paths, const Path& relativePath) {
@@ -381,6 +372,36 @@ namespace TrenchBroom {
             return result;
         }
 
+        StringList Path::components() const {
+            return StringUtils::split(m_path, '/');
+        }
+
+        size_t Path::componentOffset(size_t index) const {
+            assert(index < length());
+            size_t offset = 0;
+            while (index-- > 0)
+                offset = m_path.find('/', offset) + 1;
+            return offset;
+        }
+
+        bool Path::hasDotComponents() const {
+            size_t pos = m_path.find('.');
+            while (pos != String::npos) {
+                const size_t begin = pos == 0 ? 0 : m_path.rfind('/', pos - 1) + 1;
+                size_t end = m_path.find('/', pos);
+                if (end == String::npos)
+                    end = m_path.size();
+                
+                const size_t componentLength = end - begin;
+                if ((componentLength == 1 && m_path[begin] == '.') ||
+                    (componentLength == 2 && m_path[begin] == '.' && m_path[begin + 1] == '.'))
+                    return true;
+                
+                pos = m_path.find('.', end);
+            }
+            return false;
+        }
+
         bool Path::hasDriveSpec(const StringList& components) {
 #ifdef _WIN32
             if (components.empty())
@@ -22,6 +22,7 @@
 
 #include "StringUtils.h"
 
+#include <algorithm>
 #include <vector>
 
 namespace TrenchBroom {
@@ -42,22 +43,31 @@ namespace TrenchBroom {
                 }
             };
             
-            template <typename StringLess>
+            /**
+             * Orders paths component by component, comparing the characters of each component with the given char
+             * compare, such as StringUtils::CaseInsensitiveCharCompare. Does not allocate.
+             */
+            template <typename CharCompare>
             class Less {
             private:
-                StringLess m_less;
+                CharCompare m_compare;
             public:
                 bool operator()(const Path& lhs, const Path& rhs) const {
-                    return std::lexicographical_compare(std::begin(lhs.m_components), std::end(lhs.m_components),
-                                                        std::begin(rhs.m_components), std::end(rhs.m_components), m_less);
+                    return compareComponents(lhs.m_path, rhs.m_path, m_compare) < 0;
                 }
             };
         private:
             static const String& separators();
             
-            StringList m_components;
+            /**
+             * The components of this path joined by '/' without a leading or trailing separator. Keeping a path in
+             * a single string rather than one string per component makes paths cheap to create, copy and compare,
+             * since short paths fit into the string's small buffer and avoid the heap entirely.
+             */
+            String m_path;
             bool m_absolute;
             
+            Path(bool absolute, const String& path);
             Path(bool absolute, const StringList& components);
         public:
             explicit Path(const String& path = "");
@@ -99,6 +109,33 @@ namespace TrenchBroom {
             
             static List makeAbsoluteAndCanonical(const List& paths, const Path& relativePath);
         private:
+            template <typename CharCompare>
+            static int compareComponents(const String& lhs, const String& rhs, const CharCompare& compare) {
+                // the separator orders before any character so that shorter components come first
+                const size_t max = std::min(lhs.size(), rhs.size());
+                for (size_t i = 0; i < max; ++i) {
+                    const char l = lhs[i];
+                    const char r = rhs[i];
+                    if (l == '/' || r == '/') {
+                        if (l != r)
+                            return l == '/' ? -1 : 1;
+                    } else {
+                        const int result = compare(l, r);
+                        if (result != 0)
+                            return result < 0 ? -1 : 1;
+                    }
+                }
+                if (lhs.size() < rhs.size())
+                    return -1;
+                if (lhs.size() > rhs.size())
+                    return 1;
+                return 0;
+            }
+            
+            StringList components() const;
+            size_t componentOffset(size_t index) const;
+            bool hasDotComponents() const;
+            
             static bool hasDriveSpec(const StringList& components);
             static bool hasDriveSpec(const String& component);
             StringList resolvePath(const bool absolute, const StringList& components) const;
@@ -380,6 +380,21 @@ namespace TrenchBroom {
             }
         }
 
+        Brush::Brush(const BrushFaceList& faces, BrushGeometry* geometry) :
+        m_geometry(geometry),
+        m_contentTypeBuilder(nullptr),
+        m_contentType(0),
+        m_transparent(false),
+        m_contentTypeValid(true) {
+            ensure(m_geometry != nullptr, "geometry is null");
+            addFaces(faces);
+            restoreFaceLinks(m_geometry);
+            for (BrushFace* face : m_faces)
+                face->resetTexCoordSystemCache();
+            assert(checkGeometry());
+            nodeBoundsDidChange();
+        }
+
         Brush::~Brush() {
             cleanup();
         }
@@ -733,33 +748,20 @@ namespace TrenchBroom {
             ensure(!vertexPositions.empty(), "no vertex positions");
             assert(canMoveVertices(worldBounds, vertexPositions, delta));
 
-            BrushGeometry newGeometry;
-            Vec3::Set vertexSet(std::begin(vertexPositions), std::end(vertexPositions));
-
-            for (BrushVertex* vertex : m_geometry->vertices()) {
-                const Vec3& position = vertex->position();
-                if (vertexSet.count(position) > 0)
-                    newGeometry.addPoint(position + delta);
-                else
-                    newGeometry.addPoint(position);
-            }
+            NewGeometry newGeometry = computeMovedVertices(vertexPositions, delta);
+            const Vec3::Set vertexSet(std::begin(vertexPositions), std::end(vertexPositions));
 
             Vec3::List result;
-            Vec3::Map vertexMapping;
-            for (BrushVertex* vertex : m_geometry->vertices()) {
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
                 const Vec3& oldPosition = vertex->position();
-                const bool moved = vertexSet.count(oldPosition) > 0;
-                const Vec3 newPosition = moved ? oldPosition + delta : oldPosition;
-                if (newGeometry.hasVertex(newPosition)) {
-                    vertexMapping.insert(std::make_pair(oldPosition, newPosition));
-                    if (moved)
-                        result.push_back(newPosition);
+                if (vertexSet.count(oldPosition) > 0) {
+                    const Vec3::Map::const_iterator it = newGeometry.vertexMapping.find(oldPosition);
+                    if (it != std::end(newGeometry.vertexMapping))
+                        result.push_back(it->second);
                 }
             }
 
-            const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry, vertexMapping);
-            doSetNewGeometry(worldBounds, matcher, newGeometry);
-
+            setNewGeometry(worldBounds, newGeometry);
             return result;
         }
 
@@ -771,13 +773,11 @@ namespace TrenchBroom {
         BrushVertex* Brush::addVertex(const BBox3& worldBounds, const Vec3& position) {
             assert(canAddVertex(worldBounds, position));
 
-            BrushGeometry newGeometry(*m_geometry);
-            BrushVertex* newVertex = newGeometry.addPoint(position);
-            ensure(newVertex != nullptr, "vertex could not be added");
-
-            const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry);
-            doSetNewGeometry(worldBounds, matcher, newGeometry);
+            NewGeometry newGeometry = computeAddedVertices(Vec3::List(1, position));
+            setNewGeometry(worldBounds, newGeometry);
 
+            BrushVertex* newVertex = m_geometry->findVertexByPosition(position);
+            ensure(newVertex != nullptr, "vertex could not be added");
             return newVertex;
         }
 
@@ -804,54 +804,19 @@ namespace TrenchBroom {
             ensure(!vertexPositions.empty(), "no vertex positions");
             assert(canRemoveVertices(worldBounds, vertexPositions));
 
-            BrushGeometry newGeometry;
-            const Vec3::Set vertexSet(std::begin(vertexPositions), std::end(vertexPositions));
-
-            for (const BrushVertex* vertex : m_geometry->vertices()) {
-                const Vec3& position = vertex->position();
-                if (vertexSet.count(position) == 0)
-                    newGeometry.addPoint(position);
-            }
-
-            const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry);
-            doSetNewGeometry(worldBounds, matcher, newGeometry);
+            NewGeometry newGeometry = computeRemovedVertices(vertexPositions);
+            setNewGeometry(worldBounds, newGeometry);
         }
 
-        bool Brush::canSnapVertices(const BBox3& worldBounds, const size_t snapTo) {
-            const FloatType snapToF = static_cast<FloatType>(snapTo);
-            BrushGeometry newGeometry;
-
-            for (const BrushVertex* vertex : m_geometry->vertices()) {
-                const Vec3& origin = vertex->position();
-                const Vec3 destination = snapToF * (origin / snapToF).rounded();
-                newGeometry.addPoint(destination);
-            }
-
-            return newGeometry.polyhedron();
+        bool Brush::canSnapVertices(const BBox3& worldBounds, const size_t snapTo) const {
+            return computeSnappedVertices(snapTo).geometry.polyhedron();
         }
 
         void Brush::snapVertices(const BBox3& worldBounds, const size_t snapTo) {
             ensure(m_geometry != nullptr, "geometry is null");
 
-            const FloatType snapToF = static_cast<FloatType>(snapTo);
-            BrushGeometry newGeometry;
-
-            for (const BrushVertex* vertex : m_geometry->vertices()) {
-                const Vec3& origin = vertex->position();
-                const Vec3 destination = snapToF * (origin / snapToF).rounded();
-                newGeometry.addPoint(destination);
-            }
-
-            Vec3::Map vertexMapping;
-            for (const BrushVertex* vertex : m_geometry->vertices()) {
-                const Vec3& origin = vertex->position();
-                const Vec3 destination = snapToF * (origin / snapToF).rounded();
-                if (newGeometry.hasVertex(destination))
-                    vertexMapping.insert(std::make_pair(origin, destination));
-            }
-
-            const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry, vertexMapping);
-            doSetNewGeometry(worldBounds, matcher, newGeometry);
+            NewGeometry newGeometry = computeSnappedVertices(snapTo);
+            setNewGeometry(worldBounds, newGeometry);
         }
 
         bool Brush::canMoveEdges(const BBox3& worldBounds, const Edge3::List& edgePositions, const Vec3& delta) const {
@@ -1044,11 +1009,96 @@ namespace TrenchBroom {
             return CanMoveVerticesResult::acceptVertexMove(result);
         }
 
-        void Brush::doSetNewGeometry(const BBox3& worldBounds, const PolyhedronMatcher<BrushGeometry>& matcher, BrushGeometry& newGeometry) {
+        Brush::NewGeometry Brush::computeMovedVertices(const Vec3::List& vertexPositions, const Vec3& delta) const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            NewGeometry result;
+            const Vec3::Set vertexSet(std::begin(vertexPositions), std::end(vertexPositions));
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& position = vertex->position();
+                if (vertexSet.count(position) > 0)
+                    result.geometry.addPoint(position + delta);
+                else
+                    result.geometry.addPoint(position);
+            }
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& oldPosition = vertex->position();
+                const Vec3 newPosition = vertexSet.count(oldPosition) > 0 ? oldPosition + delta : oldPosition;
+                if (result.geometry.hasVertex(newPosition))
+                    result.vertexMapping.insert(std::make_pair(oldPosition, newPosition));
+            }
+
+            return result;
+        }
+
+        Brush::NewGeometry Brush::computeAddedVertices(const Vec3::List& positions) const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            NewGeometry result;
+            result.geometry = *m_geometry;
+            for (const Vec3& position : positions)
+                result.geometry.addPoint(position);
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& position = vertex->position();
+                if (result.geometry.hasVertex(position))
+                    result.vertexMapping.insert(std::make_pair(position, position));
+            }
+
+            return result;
+        }
+
+        Brush::NewGeometry Brush::computeRemovedVertices(const Vec3::List& vertexPositions) const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            NewGeometry result;
+            const Vec3::Set vertexSet(std::begin(vertexPositions), std::end(vertexPositions));
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& position = vertex->position();
+                if (vertexSet.count(position) == 0)
+                    result.geometry.addPoint(position);
+            }
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& position = vertex->position();
+                if (result.geometry.hasVertex(position))
+                    result.vertexMapping.insert(std::make_pair(position, position));
+            }
+
+            return result;
+        }
+
+        Brush::NewGeometry Brush::computeSnappedVertices(const size_t snapTo) const {
+            ensure(m_geometry != nullptr, "geometry is null");
+
+            NewGeometry result;
+            const FloatType snapToF = static_cast<FloatType>(snapTo);
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& origin = vertex->position();
+                const Vec3 destination = snapToF * (origin / snapToF).rounded();
+                result.geometry.addPoint(destination);
+            }
+
+            for (const BrushVertex* vertex : m_geometry->vertices()) {
+                const Vec3& origin = vertex->position();
+                const Vec3 destination = snapToF * (origin / snapToF).rounded();
+                if (result.geometry.hasVertex(destination))
+                    result.vertexMapping.insert(std::make_pair(origin, destination));
+            }
+
+            return result;
+        }
+
+        void Brush::setNewGeometry(const BBox3& worldBounds, NewGeometry& newGeometry) {
+            const PolyhedronMatcher<BrushGeometry> matcher(*m_geometry, newGeometry.geometry, newGeometry.vertexMapping);
             matcher.processRightFaces(FaceMatchingCallback());
 
             const NotifyNodeChange nodeChange(this);
-            using std::swap; swap(*m_geometry, newGeometry);
+            using std::swap; swap(*m_geometry, newGeometry.geometry);
             VectorUtils::clearAndDelete(m_faces);
             updateFacesFromGeometry(worldBounds);
             assert(fullySpecified());
@@ -1056,17 +1106,11 @@ namespace TrenchBroom {
         }
 
         BrushList Brush::subtract(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const Brush* subtrahend) const {
-            const BrushGeometry::SubtractResult result = m_geometry->subtract(*subtrahend->m_geometry);
-
-            BrushList brushes(0);
-            brushes.reserve(result.size());
-
-            for (const BrushGeometry& geometry : result) {
-                Brush* brush = createBrush(factory, worldBounds, defaultTextureName, geometry, subtrahend);
-                brushes.push_back(brush);
-            }
+            return subtract(factory, worldBounds, defaultTextureName, BrushList(1, const_cast<Brush*>(subtrahend)));
+        }
 
-            return brushes;
+        BrushList Brush::subtract(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushList& subtrahends) const {
+            return createBrushes(factory, worldBounds, defaultTextureName, subtractGeometry(subtrahends), subtrahends);
         }
 
         void Brush::intersect(const BBox3& worldBounds, const Brush* brush) {
@@ -1076,7 +1120,55 @@ namespace TrenchBroom {
             rebuildGeometry(worldBounds);
         }
 
-        Brush* Brush::createBrush(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const Brush* subtrahend) const {
+        BrushGeometry::SubtractResult Brush::subtractGeometry(const BrushList& subtrahends) const {
+            BrushGeometry::SubtractResult fragments;
+            fragments.push_back(*m_geometry);
+            bool changed = false;
+
+            for (const Brush* subtrahend : subtrahends) {
+                const BrushGeometry& subtrahendGeometry = *subtrahend->m_geometry;
+                if (!bounds().intersects(subtrahendGeometry.bounds()))
+                    continue;
+
+                auto it = std::begin(fragments);
+                while (it != std::end(fragments)) {
+                    if (!it->bounds().intersects(subtrahendGeometry.bounds())) {
+                        ++it;
+                        continue;
+                    }
+
+                    BrushGeometry::SubtractResult remainders = it->subtract(subtrahendGeometry);
+                    if (!remainders.empty()) {
+                        fragments.splice(it, remainders);
+                        it = fragments.erase(it);
+                        changed = true;
+                    } else if (subtrahendGeometry.contains(*it)) {
+                        it = fragments.erase(it);
+                        changed = true;
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+
+            if (!changed)
+                fragments.clear();
+            return fragments;
+        }
+
+        BrushList Brush::createBrushes(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry::SubtractResult& fragments, const BrushList& subtrahends) const {
+            BrushList brushes(0);
+            brushes.reserve(fragments.size());
+
+            for (const BrushGeometry& geometry : fragments) {
+                Brush* brush = createBrush(factory, worldBounds, defaultTextureName, geometry, subtrahends);
+                brushes.push_back(brush);
+            }
+
+            return brushes;
+        }
+
+        Brush* Brush::createBrush(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const BrushList& subtrahends) const {
             BrushFaceList faces(0);
             faces.reserve(geometry.faceCount());
 
@@ -1095,7 +1187,7 @@ namespace TrenchBroom {
 
             Brush* brush = factory.createBrush(worldBounds, faces);
             brush->cloneFaceAttributesFrom(this);
-            brush->cloneInvertedFaceAttributesFrom(subtrahend);
+            brush->cloneInvertedFaceAttributesFrom(subtrahends);
             return brush;
         }
 
@@ -1217,18 +1309,55 @@ namespace TrenchBroom {
         }
 
         Node* Brush::doClone(const BBox3& worldBounds) const {
+            return clone(worldBounds, copyGeometry(worldBounds));
+        }
+
+        Brush* Brush::clone(const BBox3& worldBounds, BrushGeometry* geometry) const {
             BrushFaceList faceClones;
             faceClones.reserve(m_faces.size());
 
             for (const BrushFace* face : m_faces)
                 faceClones.push_back(face->clone());
 
-            Brush* brush = new Brush(worldBounds, faceClones);
+            Brush* brush = nullptr;
+            if (geometry != nullptr) {
+                setGeometryPayloads(geometry, faceClones);
+                brush = new Brush(faceClones, geometry);
+            } else {
+                brush = new Brush(worldBounds, faceClones);
+            }
             brush->setContentTypeBuilder(m_contentTypeBuilder);
             cloneAttributes(brush);
             return brush;
         }
 
+        BrushGeometry* Brush::copyGeometry(const BBox3& worldBounds) const {
+            // The geometry of a brush that lies within the world bounds does not depend on them, so it can be
+            // copied instead of being rebuilt from the face planes.
+            if (!worldBounds.contains(bounds()))
+                return nullptr;
+            return new BrushGeometry(*m_geometry);
+        }
+
+        void Brush::setGeometryPayloads(BrushGeometry* geometry, const BrushFaceList& faceClones) const {
+            assert(faceClones.size() == m_faces.size());
+
+            // the copy contains the faces in the same order as the original geometry
+            const BrushFaceGeometry* firstOriginal = m_geometry->faces().front();
+            const BrushFaceGeometry* currentOriginal = firstOriginal;
+            BrushFaceGeometry* currentCopy = geometry->faces().front();
+            do {
+                BrushFace* face = currentOriginal->payload();
+                if (face != nullptr) {
+                    const size_t index = VectorUtils::indexOf(m_faces, face);
+                    assert(index < faceClones.size());
+                    currentCopy->setPayload(faceClones[index]);
+                }
+                currentOriginal = currentOriginal->next();
+                currentCopy = currentCopy->next();
+            } while (currentOriginal != firstOriginal);
+        }
+
         bool Brush::doCanAddChild(const Node* child) const {
             return false;
         }
@@ -75,9 +75,28 @@ namespace TrenchBroom {
             Brush(const BBox3& worldBounds, const BrushFaceList& faces);
             ~Brush();
         private:
+            /**
+             * Creates a brush from the given faces and takes ownership of the given geometry, which must have been
+             * computed from the faces and must carry them as its face payloads.
+             */
+            Brush(const BrushFaceList& faces, BrushGeometry* geometry);
             void cleanup();
         public:
             Brush* clone(const BBox3& worldBounds) const;
+
+            /**
+             * Clones this brush and passes the given geometry to the clone, which takes ownership of it. The geometry
+             * must have been returned by copyGeometry for this brush, and this brush must not have changed since. If
+             * the given geometry is null, the geometry of the clone is rebuilt from its faces.
+             */
+            Brush* clone(const BBox3& worldBounds, BrushGeometry* geometry) const;
+
+            /**
+             * Returns a copy of the geometry of this brush for passing to clone, or null if the geometry must be
+             * rebuilt because the brush is not contained in the given world bounds. Other than cloning, copying the
+             * geometry does not modify any shared state, so it can be done concurrently for different brushes.
+             */
+            BrushGeometry* copyGeometry(const BBox3& worldBounds) const;
             
             AttributableNode* entity() const;
         public: // face management:
@@ -165,7 +184,7 @@ namespace TrenchBroom {
             bool canRemoveVertices(const BBox3& worldBounds, const Vec3::List& vertexPositions) const;
             void removeVertices(const BBox3& worldBounds, const Vec3::List& vertexPositions);
             
-            bool canSnapVertices(const BBox3& worldBounds, size_t snapTo);
+            bool canSnapVertices(const BBox3& worldBounds, size_t snapTo) const;
             void snapVertices(const BBox3& worldBounds, size_t snapTo);
 
             // edge operations
@@ -175,6 +194,27 @@ namespace TrenchBroom {
             // face operations
             bool canMoveFaces(const BBox3& worldBounds, const Polygon3::List& facePositions, const Vec3& delta) const;
             Polygon3::List moveFaces(const BBox3& worldBounds, const Polygon3::List& facePositions, const Vec3& delta);
+        public:
+            /**
+             * The geometry resulting from a vertex operation, together with a mapping of the old vertex positions to
+             * the new ones that is used to transfer the face attributes to the new faces.
+             */
+            struct NewGeometry {
+                BrushGeometry geometry;
+                Vec3::Map vertexMapping;
+            };
+
+            /*
+             These compute the results of the vertex operations above without modifying this brush, its faces or any
+             textures, so they may be called concurrently for different brushes. The results must then be applied on
+             the main thread by calling setNewGeometry. Neither validates the new geometry, this is left to the
+             corresponding can* methods.
+             */
+            NewGeometry computeMovedVertices(const Vec3::List& vertexPositions, const Vec3& delta) const;
+            NewGeometry computeAddedVertices(const Vec3::List& positions) const;
+            NewGeometry computeRemovedVertices(const Vec3::List& vertexPositions) const;
+            NewGeometry computeSnappedVertices(size_t snapTo) const;
+            void setNewGeometry(const BBox3& worldBounds, NewGeometry& newGeometry);
         private:
             struct CanMoveVerticesResult {
             public:
@@ -190,13 +230,19 @@ namespace TrenchBroom {
             };
             
             CanMoveVerticesResult doCanMoveVertices(const BBox3& worldBounds, const Vec3::List& vertices, Vec3 delta, bool allowVertexRemoval) const;
-            void doSetNewGeometry(const BBox3& worldBounds, const PolyhedronMatcher<BrushGeometry>& matcher, BrushGeometry& newGeometry);
         public:
             // CSG operations
             BrushList subtract(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const Brush* subtrahend) const;
+            BrushList subtract(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushList& subtrahends) const;
             void intersect(const BBox3& worldBounds, const Brush* brush);
         private:
-            Brush* createBrush(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const Brush* subtrahend) const;
+            /**
+             * Computes the fragments that remain of this brush's geometry after subtracting the given brushes in
+             * order. Returns an empty list if the subtrahends do not overlap this brush or if nothing remains of it.
+             */
+            BrushGeometry::SubtractResult subtractGeometry(const BrushList& subtrahends) const;
+            BrushList createBrushes(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry::SubtractResult& fragments, const BrushList& subtrahends) const;
+            Brush* createBrush(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const BrushList& subtrahends) const;
         private:
             void updateFacesFromGeometry(const BBox3& worldBounds);
             void updatePointsFromVertices(const BBox3& worldBounds);
@@ -219,6 +265,7 @@ namespace TrenchBroom {
             const BBox3& doGetBounds() const;
             
             Node* doClone(const BBox3& worldBounds) const;
+            void setGeometryPayloads(BrushGeometry* geometry, const BrushFaceList& faceClones) const;
             NodeSnapshot* doTakeSnapshot();
             
             bool doCanAddChild(const Node* child) const;
@@ -63,7 +63,8 @@ namespace TrenchBroom {
         }
 
         GameSPtr GameFactory::createGame(const String& gameName, Logger* logger) {
-            return GameSPtr(new GameImpl(gameConfig(gameName), gamePath(gameName), logger));
+            const IO::Path entityDefinitionCacheDirectory = IO::SystemPaths::userDataDirectory() + IO::Path("cache/entities");
+            return GameSPtr(new GameImpl(gameConfig(gameName), gamePath(gameName), entityDefinitionCacheDirectory, logger));
         }
         
         const StringList& GameFactory::fileFormats(const String& gameName) const {
@@ -25,6 +25,7 @@
 #include "IO/Bsp29Parser.h"
 #include "IO/DefParser.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/EntityDefinitionCache.h"
 #include "IO/FgdParser.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
@@ -48,28 +49,47 @@
 #include "Model/Tutorial.h"
 #include "Model/World.h"
 
+#include "CollectionUtils.h"
 #include "Exceptions.h"
+#include "ParallelUtils.h"
 
+#include <chrono>
 #include <cstdio>
+#include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         GameImpl::GameImpl(GameConfig& config, const IO::Path& gamePath, Logger* logger) :
+        GameImpl(config, gamePath, IO::Path(), logger) {}
+        
+        GameImpl::GameImpl(GameConfig& config, const IO::Path& gamePath, const IO::Path& entityDefinitionCacheDirectory, Logger* logger) :
         m_config(config),
-        m_gamePath(gamePath) {
+        m_gamePath(gamePath),
+        m_entityDefinitionCacheDirectory(entityDefinitionCacheDirectory) {
             initializeFileSystem(logger);
         }
         
+        const IO::FileSystem& GameImpl::gameFileSystem() const {
+            return m_gameFS;
+        }
+        
         void GameImpl::initializeFileSystem(Logger* logger) {
+            typedef std::chrono::steady_clock Clock;
+            const Clock::time_point start = Clock::now();
+            
             const GameConfig::FileSystemConfig& fileSystemConfig = m_config.fileSystemConfig();
             if (!m_gamePath.isEmpty() && IO::Disk::directoryExists(m_gamePath)) {
                 addSearchPath(fileSystemConfig.searchPath, logger);
                 for (const IO::Path& searchPath : m_additionalSearchPaths)
                     addSearchPath(searchPath, logger);
                 
-                addPackages(m_gamePath + fileSystemConfig.searchPath);
+                size_t packageCount = addPackages(m_gamePath + fileSystemConfig.searchPath, logger);
                 for (const IO::Path& searchPath : m_additionalSearchPaths)
-                    addPackages(m_gamePath + searchPath);
+                    packageCount += addPackages(m_gamePath + searchPath, logger);
+                
+                const std::chrono::duration<double, std::milli> duration = Clock::now() - start;
+                logger->info("Mounted game file system with %u packages in %.0f ms", static_cast<unsigned int>(packageCount), duration.count());
             }
         }
 
@@ -81,24 +101,50 @@ namespace TrenchBroom {
             }
         }
         
-        void GameImpl::addPackages(const IO::Path& searchPath) {
+        size_t GameImpl::addPackages(const IO::Path& searchPath, Logger* logger) {
             const GameConfig::FileSystemConfig& fileSystemConfig = m_config.fileSystemConfig();
             const GameConfig::PackageFormatConfig& packageFormatConfig = fileSystemConfig.packageFormat;
 
             const String& packageExtension = packageFormatConfig.extension;
             const String& packageFormat = packageFormatConfig.format;
 
-            if (IO::Disk::directoryExists(searchPath)) {
-                const IO::DiskFileSystem diskFS(searchPath);
-                const IO::Path::List packages = diskFS.findItems(IO::Path(""), IO::FileExtensionMatcher(packageExtension));
-                for (const IO::Path& packagePath : packages) {
-                    IO::MappedFile::Ptr packageFile = diskFS.openFile(packagePath);
-                    ensure(packageFile.get() != nullptr, "packageFile is null");
-
-                    if (StringUtils::caseInsensitiveEqual(packageFormat, "idpak"))
-                        m_gameFS.addFileSystem(new IO::IdPakFileSystem(packagePath, packageFile));
+            if (!IO::Disk::directoryExists(searchPath))
+                return 0;
+            
+            const IO::DiskFileSystem diskFS(searchPath);
+            const IO::Path::List packagePaths = diskFS.findItems(IO::Path(""), IO::FileExtensionMatcher(packageExtension));
+            
+            // Reading the package directories is independent for each package, so it is done concurrently. A package
+            // that cannot be read is reported after all workers have finished. The packages are mounted in the order in
+            // which they were found afterwards, so that later packages still override the files of earlier ones.
+            std::vector<std::unique_ptr<IO::FileSystem>> packages(packagePaths.size());
+            StringList errors(packagePaths.size());
+            ParallelUtils::forEachIndex(packagePaths.size(), [&](const size_t i) {
+                try {
+                    packages[i].reset(createPackageFileSystem(packageFormat, packagePaths[i], diskFS.openFile(packagePaths[i])));
+                } catch (const Exception& e) {
+                    errors[i] = e.what();
+                }
+            });
+            
+            size_t count = 0;
+            for (size_t i = 0; i < packagePaths.size(); ++i) {
+                if (!errors[i].empty()) {
+                    logger->error("Unable to mount package '" + packagePaths[i].asString() + "': " + errors[i]);
+                } else if (packages[i] != nullptr) {
+                    m_gameFS.addFileSystem(packages[i].release());
+                    ++count;
                 }
             }
+            return count;
+        }
+        
+        IO::FileSystem* GameImpl::createPackageFileSystem(const String& packageFormat, const IO::Path& packagePath, IO::MappedFile::Ptr packageFile) {
+            if (packageFile.get() == nullptr)
+                throw FileSystemException("Cannot open package file '" + packagePath.asString() + "'");
+            if (StringUtils::caseInsensitiveEqual(packageFormat, "idpak"))
+                return new IO::IdPakFileSystem(packagePath, packageFile);
+            return nullptr;
         }
 
         const String& GameImpl::doGameName() const {
@@ -281,23 +327,56 @@ namespace TrenchBroom {
             const String extension = path.extension();
             const Color& defaultColor = m_config.entityConfig().defaultColor;
 
-            Assets::EntityDefinitionList definitions;
-            if (StringUtils::caseInsensitiveEqual("fgd", extension)) {
-                const IO::MappedFile::Ptr file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                IO::FgdParser parser(file->begin(), file->end(), defaultColor);
-                definitions = parser.parseDefinitions(status);
-            } else if (StringUtils::caseInsensitiveEqual("def", extension)) {
-                const IO::MappedFile::Ptr file = IO::Disk::openFile(IO::Disk::fixPath(path));
-                IO::DefParser parser(file->begin(), file->end(), defaultColor);
-                definitions = parser.parseDefinitions(status);
-            } else {
+            const bool fgd = StringUtils::caseInsensitiveEqual("fgd", extension);
+            const bool def = StringUtils::caseInsensitiveEqual("def", extension);
+            if (!fgd && !def)
                 throw GameException("Unknown entity definition format: '" + path.asString() + "'");
+
+            const IO::MappedFile::Ptr file = IO::Disk::openFile(IO::Disk::fixPath(path));
+
+            Assets::EntityDefinitionList definitions;
+            if (m_entityDefinitionCacheDirectory.isEmpty()) {
+                definitions = parseEntityDefinitions(file, fgd, defaultColor, status);
+            } else if (!IO::EntityDefinitionCache(m_entityDefinitionCacheDirectory).load(*file, defaultColor, definitions)) {
+                definitions = parseEntityDefinitions(file, fgd, defaultColor, status);
+                writeEntityDefinitionCache(file, fgd, defaultColor);
             }
 
             definitions.push_back(Tutorial::createTutorialEntityDefinition());
             return definitions;
         }
 
+        Assets::EntityDefinitionList GameImpl::parseEntityDefinitions(IO::MappedFile::Ptr file, const bool fgd, const Color& defaultColor, IO::ParserStatus& status) {
+            if (fgd) {
+                IO::FgdParser parser(file, defaultColor);
+                return parser.parseDefinitions(status);
+            } else {
+                IO::DefParser parser(file->begin(), file->end(), defaultColor);
+                return parser.parseDefinitions(status);
+            }
+        }
+
+        void GameImpl::writeEntityDefinitionCache(IO::MappedFile::Ptr file, const bool fgd, const Color& defaultColor) const {
+            // The cache needs the attribute definitions of every class, but the parsed definitions only read them
+            // when they are first requested. Instead of forcing that, the file is parsed again in the background and
+            // those definitions are written to the cache.
+            if (m_entityDefinitionCacheWriter.valid())
+                m_entityDefinitionCacheWriter.wait();
+            
+            const IO::EntityDefinitionCache cache(m_entityDefinitionCacheDirectory);
+            m_entityDefinitionCacheWriter = std::async(std::launch::async, [cache, file, fgd, defaultColor]() {
+                IO::SimpleParserStatus status(nullptr);
+                Assets::EntityDefinitionList definitions;
+                try {
+                    definitions = parseEntityDefinitions(file, fgd, defaultColor, status);
+                    cache.store(*file, defaultColor, definitions);
+                } catch (const Exception&) {
+                    // the definitions are just parsed again next time
+                }
+                VectorUtils::clearAndDelete(definitions);
+            });
+        }
+
         Assets::EntityDefinitionFileSpec::List GameImpl::doAllEntityDefinitionFiles() const {
             const IO::Path::List paths = m_config.entityConfig().defFilePaths;
             const size_t count = paths.size();
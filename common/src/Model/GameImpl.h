@@ -29,6 +29,7 @@
 #include "Model/GameConfig.h"
 #include "Model/ModelTypes.h"
 
+#include <future>
 
 namespace TrenchBroom {
     class Logger;
@@ -41,12 +42,21 @@ namespace TrenchBroom {
             IO::Path::List m_additionalSearchPaths;
             
             IO::FileSystemHierarchy m_gameFS;
+            
+            // the parsed entity definitions are only cached if this is not empty
+            IO::Path m_entityDefinitionCacheDirectory;
+            // Writes the entity definition cache in the background, waits for it when destroyed.
+            mutable std::future<void> m_entityDefinitionCacheWriter;
         public:
             GameImpl(GameConfig& config, const IO::Path& gamePath, Logger* logger);
+            GameImpl(GameConfig& config, const IO::Path& gamePath, const IO::Path& entityDefinitionCacheDirectory, Logger* logger);
+            
+            const IO::FileSystem& gameFileSystem() const;
         private:
             void initializeFileSystem(Logger* logger);
             void addSearchPath(const IO::Path& searchPath, Logger* logger);
-            void addPackages(const IO::Path& searchPath);
+            size_t addPackages(const IO::Path& searchPath, Logger* logger);
+            static IO::FileSystem* createPackageFileSystem(const String& packageFormat, const IO::Path& packagePath, IO::MappedFile::Ptr packageFile);
         private:
             const String& doGameName() const;
             IO::Path doGamePath() const;
@@ -80,6 +90,8 @@ namespace TrenchBroom {
             
             bool doIsEntityDefinitionFile(const IO::Path& path) const;
             Assets::EntityDefinitionList doLoadEntityDefinitions(IO::ParserStatus& status, const IO::Path& path) const;
+            static Assets::EntityDefinitionList parseEntityDefinitions(IO::MappedFile::Ptr file, bool fgd, const Color& defaultColor, IO::ParserStatus& status);
+            void writeEntityDefinitionCache(IO::MappedFile::Ptr file, bool fgd, const Color& defaultColor) const;
             Assets::EntityDefinitionFileSpec::List doAllEntityDefinitionFiles() const;
             Assets::EntityDefinitionFileSpec doExtractEntityDefinitionFile(const AttributableNode* node) const;
             Assets::EntityDefinitionFileSpec defaultEntityDefinitionFile() const;
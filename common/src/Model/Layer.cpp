@@ -35,6 +35,11 @@ namespace TrenchBroom {
             m_name = name;
         }
 
+        void Layer::findChildren(const BBox3& bounds, NodeList& result) const {
+            const NodeTree::List children = m_octree.findObjects(bounds);
+            result.insert(std::end(result), std::begin(children), std::end(children));
+        }
+
         const String& Layer::doGetName() const {
             return m_name;
         }
@@ -46,7 +51,6 @@ namespace TrenchBroom {
         Node* Layer::doClone(const BBox3& worldBounds) const {
             Layer* layer = new Layer(m_name, worldBounds);
             cloneAttributes(layer);
-            layer->addChildren(clone(worldBounds, children()));
             return layer;
         }
 
@@ -37,6 +37,12 @@ namespace TrenchBroom {
             Layer(const String& name, const BBox3& worldBounds);
             
             void setName(const String& name);
+            
+            /**
+             * Adds the children of this layer whose bounds may intersect the given bounds to the given list. The
+             * list may also contain children whose bounds do not intersect the given bounds.
+             */
+            void findChildren(const BBox3& bounds, NodeList& result) const;
         private: // implement Node interface
             const String& doGetName() const;
             const BBox3& doGetBounds() const;
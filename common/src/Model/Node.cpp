@@ -20,10 +20,19 @@
 #include "Node.h"
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
+#include "Model/Brush.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
 #include "Model/Issue.h"
 #include "Model/IssueGenerator.h"
+#include "Model/Layer.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace TrenchBroom {
     namespace Model {
@@ -77,13 +86,112 @@ namespace TrenchBroom {
             return clones;
         }
 
-        NodeList Node::cloneRecursively(const BBox3& worldBounds, const NodeList& nodes) {
+        class CollectBrushesToClone : public ConstNodeVisitor {
+        private:
+            std::vector<const Brush*> m_brushes;
+        public:
+            const std::vector<const Brush*>& brushes() const {
+                return m_brushes;
+            }
+        private:
+            // a world clones its children by itself
+            void doVisit(const World* world) override   { stopRecursion(); }
+            void doVisit(const Layer* layer) override   {}
+            void doVisit(const Group* group) override   {}
+            void doVisit(const Entity* entity) override {}
+            void doVisit(const Brush* brush) override   { m_brushes.push_back(brush); }
+        };
+
+        /**
+         * Copies the geometries of the given brushes concurrently and hands them out in the same order.
+         */
+        class BrushGeometryCopies {
+        private:
+            // below this, starting the worker threads takes longer than copying the geometries
+            static const size_t MinParallelCount = 64;
+
+            std::vector<BrushGeometry*> m_geometries;
+            size_t m_next;
+        public:
+            BrushGeometryCopies(const BBox3& worldBounds, const std::vector<const Brush*>& brushes) :
+            m_next(0) {
+                const auto copyGeometry = [&worldBounds](const Brush* brush) { return brush->copyGeometry(worldBounds); };
+                if (brushes.size() < MinParallelCount) {
+                    m_geometries.reserve(brushes.size());
+                    std::transform(std::begin(brushes), std::end(brushes), std::back_inserter(m_geometries), copyGeometry);
+                } else {
+                    m_geometries = ParallelUtils::transform<BrushGeometry*>(brushes, copyGeometry);
+                }
+            }
+
+            ~BrushGeometryCopies() {
+                for (size_t i = m_next; i < m_geometries.size(); ++i)
+                    delete m_geometries[i];
+            }
+
+            BrushGeometry* next() {
+                assert(m_next < m_geometries.size());
+                return m_geometries[m_next++];
+            }
+        };
+
+        static NodeList cloneNodes(const BBox3& worldBounds, const NodeList& nodes, BrushGeometryCopies& geometries);
+
+        class CloneNode : public ConstNodeVisitor, public NodeQuery<Node*> {
+        private:
+            const BBox3& m_worldBounds;
+            BrushGeometryCopies& m_geometries;
+        public:
+            CloneNode(const BBox3& worldBounds, BrushGeometryCopies& geometries) :
+            m_worldBounds(worldBounds),
+            m_geometries(geometries) {}
+        private:
+            void doVisit(const World* world) override   { setResult(world->cloneRecursively(m_worldBounds)); }
+            void doVisit(const Layer* layer) override   { setResult(cloneWithChildren(layer)); }
+            void doVisit(const Group* group) override   { setResult(cloneWithChildren(group)); }
+            void doVisit(const Entity* entity) override { setResult(cloneWithChildren(entity)); }
+            void doVisit(const Brush* brush) override   { setResult(brush->clone(m_worldBounds, m_geometries.next())); }
+
+            Node* cloneWithChildren(const Node* node) {
+                Node* clone = node->clone(m_worldBounds);
+                try {
+                    clone->addChildren(cloneNodes(m_worldBounds, node->children(), m_geometries));
+                } catch (...) {
+                    delete clone;
+                    throw;
+                }
+                return clone;
+            }
+        };
+
+        static NodeList cloneNodes(const BBox3& worldBounds, const NodeList& nodes, BrushGeometryCopies& geometries) {
             NodeList clones;
             clones.reserve(nodes.size());
-            cloneRecursively(worldBounds, std::begin(nodes), std::end(nodes), std::back_inserter(clones));
+            try {
+                for (const Node* node : nodes) {
+                    CloneNode cloneNode(worldBounds, geometries);
+                    node->accept(cloneNode);
+                    clones.push_back(cloneNode.result());
+                }
+            } catch (...) {
+                VectorUtils::clearAndDelete(clones);
+                throw;
+            }
             return clones;
         }
 
+        NodeList Node::cloneRecursively(const BBox3& worldBounds, const NodeList& nodes) {
+            // Copying the brush geometries is the bulk of the work, and it is the only part that can be done
+            // concurrently: cloning a node updates the usage counts of its textures and entity definitions, whose
+            // observers must be notified on the calling thread.
+            CollectBrushesToClone collectBrushes;
+            for (const Node* node : nodes)
+                node->acceptAndRecurse(collectBrushes);
+
+            BrushGeometryCopies geometries(worldBounds, collectBrushes.brushes());
+            return cloneNodes(worldBounds, nodes, geometries);
+        }
+
         size_t Node::depth() const {
             if (m_parent == nullptr)
                 return 0;
@@ -60,11 +60,16 @@ namespace TrenchBroom {
             Node* clone(const BBox3& worldBounds) const;
             Node* cloneRecursively(const BBox3& worldBounds) const;
             NodeSnapshot* takeSnapshot();
+
+            /**
+             * Clones the given nodes and their descendants. The geometries of the brushes among them are copied
+             * concurrently.
+             */
+            static NodeList cloneRecursively(const BBox3& worldBounds, const NodeList& nodes);
         protected:
             void cloneAttributes(Node* node) const;
             
             static NodeList clone(const BBox3& worldBounds, const NodeList& nodes);
-            static NodeList cloneRecursively(const BBox3& worldBounds, const NodeList& nodes);
             
             template <typename I, typename O>
             static void clone(const BBox3& worldBounds, I cur, I end, O result) {
@@ -141,6 +141,16 @@ namespace TrenchBroom {
                         m_children[i]->findObjects(point, result);
                 result.insert(std::end(result), std::begin(m_objects), std::end(m_objects));
             }
+            
+            void findObjects(const BBox<F,3>& bounds, List& result) const {
+                if (!m_bounds.intersects(bounds))
+                    return;
+                
+                for (size_t i = 0; i < 8; ++i)
+                    if (m_children[i] != nullptr)
+                        m_children[i]->findObjects(bounds, result);
+                result.insert(std::end(result), std::begin(m_objects), std::end(m_objects));
+            }
         private:
             BBox<F,3> octant(const size_t index) const {
                 const Vec3f& min = m_bounds.min;
@@ -255,6 +265,17 @@ namespace TrenchBroom {
                 m_root->findObjects(point, result);
                 return result;
             }
+            
+            /**
+             * Returns all objects stored in octree nodes that intersect the given bounds. Since the octree does not
+             * store the bounds of the individual objects, the result may contain objects that do not actually
+             * intersect the given bounds.
+             */
+            List findObjects(const BBox<F,3>& bounds) const {
+                List result;
+                m_root->findObjects(bounds, result);
+                return result;
+            }
         };
     }
 }
@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_ParallelNodeVisitor
+#define TrenchBroom_ParallelNodeVisitor
+
+#include "ParallelUtils.h"
+#include "Model/ModelTypes.h"
+#include "Model/Node.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Visits the given root node and all of its descendants like acceptAndRecurse, but visits the subtrees of
+         * the grandchildren of the root concurrently. For a world, these are the groups, entities and brushes of
+         * its layers.
+         *
+         * The root and its children are visited on the calling thread, each with its own visitor. The children of
+         * every child are split into contiguous ranges, and each range is visited with its own visitor on a worker
+         * thread. The visitors are created by calling the given function and are returned in the order of the
+         * nodes they have visited, so merging them in order yields the same result as a sequential traversal.
+         *
+         * The visitors must not modify any state that is shared between them, including the nodes. Cancelling a
+         * visitor only stops the traversal of the nodes assigned to it.
+         */
+        template <typename V, typename R, typename F>
+        std::vector<V> acceptAndRecurseParallel(R* root, F createVisitor) {
+            typedef typename std::conditional<std::is_const<R>::value, const Node, Node>::type N;
+
+            struct Range {
+                const NodeList* nodes;
+                size_t begin;
+                size_t end;
+                size_t visitor;
+            };
+
+            std::vector<V> visitors;
+            std::vector<Range> ranges;
+
+            visitors.push_back(createVisitor());
+            root->accept(visitors.back());
+            if (visitors.back().cancelled() || visitors.back().recursionStopped())
+                return visitors;
+
+            for (N* child : root->children()) {
+                visitors.push_back(createVisitor());
+                child->accept(visitors.back());
+                if (visitors.back().recursionStopped())
+                    continue;
+
+                const NodeList& grandChildren = child->children();
+                const size_t count = grandChildren.size();
+                const size_t rangeCount = std::min(count, 8 * ParallelUtils::threadCount(count));
+                for (size_t i = 0; i < rangeCount; ++i) {
+                    visitors.push_back(createVisitor());
+                    ranges.push_back(Range { &grandChildren, i * count / rangeCount, (i + 1) * count / rangeCount, visitors.size() - 1 });
+                }
+            }
+
+            ParallelUtils::forEachIndex(ranges.size(), [&visitors, &ranges](const size_t i) {
+                const Range& range = ranges[i];
+                V& visitor = visitors[range.visitor];
+                for (size_t j = range.begin; j < range.end && !visitor.cancelled(); ++j) {
+                    N* node = (*range.nodes)[j];
+                    node->acceptAndRecurse(visitor);
+                }
+            });
+
+            return visitors;
+        }
+
+        /**
+         * Collects nodes like a visitor created by the given function would when passed to acceptAndRecurse, but
+         * visits the nodes concurrently as described above. The collected nodes are merged in traversal order.
+         */
+        template <typename V, typename R, typename F>
+        NodeList collectNodesParallel(R* root, F createVisitor) {
+            V result = createVisitor();
+            for (const V& visitor : acceptAndRecurseParallel<V>(root, createVisitor)) {
+                for (Node* node : visitor.nodes())
+                    result.addNode(node);
+            }
+            return result.nodes();
+        }
+
+        /**
+         * Collects nodes like a visitor created by the given function would when passed to acceptAndRecurse for
+         * each of the given nodes in turn, but visits contiguous ranges of the given nodes concurrently. The
+         * collected nodes are merged in the order of the given nodes.
+         */
+        template <typename V, typename F>
+        NodeList collectNodesParallel(const NodeList& nodes, F createVisitor) {
+            const size_t count = nodes.size();
+            const size_t rangeCount = std::min(count, 8 * ParallelUtils::threadCount(count));
+
+            std::vector<V> visitors;
+            visitors.reserve(rangeCount);
+            for (size_t i = 0; i < rangeCount; ++i)
+                visitors.push_back(createVisitor());
+
+            ParallelUtils::forEachIndex(rangeCount, [&](const size_t i) {
+                V& visitor = visitors[i];
+                for (size_t j = i * count / rangeCount; j < (i + 1) * count / rangeCount && !visitor.cancelled(); ++j)
+                    nodes[j]->acceptAndRecurse(visitor);
+            });
+
+            V result = createVisitor();
+            for (const V& visitor : visitors) {
+                for (Node* node : visitor.nodes())
+                    result.addNode(node);
+            }
+            return result.nodes();
+        }
+    }
+}
+
+#endif /* defined(TrenchBroom_ParallelNodeVisitor) */
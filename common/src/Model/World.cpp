@@ -52,6 +52,13 @@ namespace TrenchBroom {
             return visitor.layers();
         }
 
+        NodeList World::findLayerChildren(const BBox3& bounds) const {
+            NodeList result;
+            for (const Layer* layer : allLayers())
+                layer->findChildren(bounds, result);
+            return result;
+        }
+
         void World::createDefaultLayer(const BBox3& worldBounds) {
             m_defaultLayer = createLayer("Default Layer", worldBounds);
             addChild(m_defaultLayer);
@@ -47,6 +47,12 @@ namespace TrenchBroom {
             Layer* defaultLayer() const;
             LayerList allLayers() const;
             LayerList customLayers() const;
+            
+            /**
+             * Returns the children of all layers whose bounds may intersect the given bounds, see
+             * Layer::findChildren.
+             */
+            NodeList findLayerChildren(const BBox3& bounds) const;
         private:
             void createDefaultLayer(const BBox3& worldBounds);
         public: // index
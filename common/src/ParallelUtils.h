@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ParallelUtils_h
+#define TrenchBroom_ParallelUtils_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace ParallelUtils {
+    /**
+     * Returns the number of worker threads to use for the given number of independent work items. Never returns
+     * more threads than there are work items or hardware threads, and never returns 0.
+     */
+    inline size_t threadCount(const size_t workItems) {
+        const size_t hardwareThreads = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1));
+        return std::max(std::min(hardwareThreads, workItems), static_cast<size_t>(1));
+    }
+
+    /**
+     * Calls the given function for every index in [0, count). The indices are handed out to a number of worker
+     * threads one at a time, so the work items may vary in cost. The calling thread takes part in the work. If
+     * the function throws, the remaining indices are skipped and the first exception is rethrown on the calling
+     * thread once all workers have finished.
+     *
+     * The function must be safe to call concurrently for different indices.
+     */
+    template <typename F>
+    void forEachIndex(const size_t count, F func) {
+        if (count == 0)
+            return;
+
+        const size_t workers = threadCount(count);
+        if (workers == 1) {
+            for (size_t i = 0; i < count; ++i)
+                func(i);
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        std::atomic<bool> failed(false);
+        std::exception_ptr exception;
+        std::atomic_flag exceptionLock = ATOMIC_FLAG_INIT;
+
+        auto work = [&]() {
+            size_t i;
+            while (!failed && (i = next++) < count) {
+                try {
+                    func(i);
+                } catch (...) {
+                    if (!exceptionLock.test_and_set())
+                        exception = std::current_exception();
+                    failed = true;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (size_t i = 0; i < workers - 1; ++i)
+            threads.push_back(std::thread(work));
+        work();
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    /**
+     * Calls the given function for every element of the given random access range concurrently.
+     */
+    template <typename I, typename F>
+    void forEach(I begin, I end, F func) {
+        const size_t count = static_cast<size_t>(std::distance(begin, end));
+        forEachIndex(count, [&](const size_t i) { func(*(begin + static_cast<typename std::iterator_traits<I>::difference_type>(i))); });
+    }
+
+    /**
+     * Returns true if the given predicate holds for all elements of the given range, which is evaluated
+     * concurrently. Unlike forEach, this accepts forward iterators, e.g. of maps or sets. Once the predicate fails
+     * for any element, the remaining elements are skipped.
+     */
+    template <typename I, typename P>
+    bool allOf(I begin, I end, P pred) {
+        std::vector<I> items;
+        for (I it = begin; it != end; ++it)
+            items.push_back(it);
+
+        std::atomic<bool> result(true);
+        forEachIndex(items.size(), [&](const size_t i) {
+            if (result && !pred(*items[i]))
+                result = false;
+        });
+        return result;
+    }
+
+    /**
+     * Applies the given function to every element of the given vector concurrently and returns the results in
+     * the order of the input elements, regardless of the order in which they were computed.
+     */
+    template <typename R, typename T, typename F>
+    std::vector<R> transform(const std::vector<T>& items, F func) {
+        std::vector<R> result(items.size());
+        forEachIndex(items.size(), [&](const size_t i) { result[i] = func(items[i]); });
+        return result;
+    }
+}
+
+#endif
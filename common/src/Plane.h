@@ -24,6 +24,7 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 #include "MathUtils.h"
 #include "Mat.h"
 #include "Ray.h"
+#include "RobustPredicates.h"
 #include "Vec.h"
 #include <vector>
 
@@ -148,12 +149,7 @@ public:
     }
     
     Math::PointStatus::Type pointStatus(const Vec<T,S>& point, const T epsilon = Math::Constants<T>::pointStatusEpsilon()) const {
-        const T dist = pointDistance(point);
-        if (dist >  epsilon)
-            return Math::PointStatus::PSAbove;
-        if (dist < -epsilon)
-            return Math::PointStatus::PSBelow;
-        return Math::PointStatus::PSInside;
+        return Math::Robust::pointStatus(normal, distance, point, epsilon);
     }
     
     T pointDistance(const Vec<T,S>& point) const {
@@ -23,6 +23,7 @@
 #include "Algorithms.h"
 #include "Allocator.h"
 #include "DoublyLinkedList.h"
+#include "PositionArray.h"
 #include "VecMath.h"
 
 #include <cassert>
@@ -538,8 +539,7 @@ private:
     static bool polyhedronIntersectsPolygon(const Polyhedron& lhs, const Polyhedron& rhs, const Callback& callback = Callback());
     static bool polyhedronIntersectsPolyhedron(const Polyhedron& lhs, const Polyhedron& rhs, const Callback& callback = Callback());
 
-    static bool separate(const Face* faces, const Vertex* vertices, const Callback& callback);
-    static Math::PointStatus::Type pointStatus(const Plane<T,3>& plane, const Vertex* vertices);
+    static bool separate(const Face* faces, const PositionArray<T>& positions, const Callback& callback);
 };
 
 #endif
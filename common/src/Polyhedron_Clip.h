@@ -114,33 +114,15 @@ typename Polyhedron<T,FP,VP>::ClipResult Polyhedron<T,FP,VP>::clip(const Polyhed
 
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T,FP,VP>::ClipResult Polyhedron<T,FP,VP>::checkIntersects(const Plane<T,3>& plane) const {
-    size_t above = 0;
-    size_t below = 0;
-    size_t inside = 0;
+    // The polyhedron is unchanged if no vertex is above the plane, and it becomes empty if no vertex is below the
+    // plane. The classification stops as soon as there are vertices on both sides.
+    PositionArray<T> positions(m_vertices.size());
+    getVertexPositions(std::back_inserter(positions));
 
-    const Vertex* firstVertex = m_vertices.front();
-    const Vertex* currentVertex = firstVertex;
-    do {
-        const Math::PointStatus::Type status = plane.pointStatus(currentVertex->position());
-        switch (status) {
-            case Math::PointStatus::PSAbove:
-                ++above;
-                break;
-            case Math::PointStatus::PSBelow:
-                ++below;
-                break;
-            case Math::PointStatus::PSInside:
-                ++inside;
-                break;
-            switchDefault()
-        }
-        currentVertex = currentVertex->next();
-    } while (currentVertex != firstVertex);
-    
-    assert(above + below + inside == m_vertices.size());
-    if (below + inside == m_vertices.size())
+    const Math::PointStatus::Type status = positions.status(plane);
+    if (status == Math::PointStatus::PSBelow)
         return ClipResult(ClipResult::Type_ClipUnchanged);
-    if (above + inside == m_vertices.size())
+    if (status == Math::PointStatus::PSAbove)
         return ClipResult(ClipResult::Type_ClipEmpty);
     return ClipResult(ClipResult::Type_ClipSuccess);
 }
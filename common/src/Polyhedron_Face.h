@@ -223,13 +223,7 @@ T Polyhedron<T,FP,VP>::Face::intersectWithRay(const Ray<T,3>& ray, const Math::S
 
 template <typename T, typename FP, typename VP>
 Math::PointStatus::Type Polyhedron<T,FP,VP>::Face::pointStatus(const V& point, const T epsilon) const {
-    const V norm = normal();
-    const T distance = (point - origin()).dot(norm);
-    if (distance > epsilon)
-        return Math::PointStatus::PSAbove;
-    if (distance < -epsilon)
-        return Math::PointStatus::PSBelow;
-    return Math::PointStatus::PSInside;
+    return Math::Robust::pointStatus(normal(), origin(), point, epsilon);
 }
 
 template <typename T, typename FP, typename VP> template <typename O>
@@ -363,9 +363,15 @@ bool Polyhedron<T,FP,VP>::polyhedronIntersectsPolyhedron(const Polyhedron& lhs,
     // separating axis theorem
     // http://www.geometrictools.com/Documentation/MethodOfSeparatingAxes.pdf
     
-    if (separate(lhs.m_faces.front(), rhs.vertices().front(), callback))
+    // Every candidate plane is tested against all vertices of both polyhedra, so their positions are gathered once.
+    PositionArray<T> lhsPositions(lhs.m_vertices.size());
+    lhs.getVertexPositions(std::back_inserter(lhsPositions));
+    PositionArray<T> rhsPositions(rhs.m_vertices.size());
+    rhs.getVertexPositions(std::back_inserter(rhsPositions));
+
+    if (separate(lhs.m_faces.front(), rhsPositions, callback))
         return false;
-    if (separate(rhs.faces().front(), lhs.m_vertices.front(), callback))
+    if (separate(rhs.faces().front(), lhsPositions, callback))
         return false;
     
     const Edge* lhsFirstEdge = lhs.m_edges.front();
@@ -383,9 +389,9 @@ bool Polyhedron<T,FP,VP>::polyhedronIntersectsPolyhedron(const Polyhedron& lhs,
             if (!direction.null()) {                
                 const Plane<T,3> plane(lhsEdgeOrigin, direction);
                 
-                const Math::PointStatus::Type lhsStatus = pointStatus(plane, lhs.m_vertices.front());
+                const Math::PointStatus::Type lhsStatus = lhsPositions.status(plane);
                 if (lhsStatus != Math::PointStatus::PSInside) {
-                    const Math::PointStatus::Type rhsStatus = pointStatus(plane, rhs.m_vertices.front());
+                    const Math::PointStatus::Type rhsStatus = rhsPositions.status(plane);
                     if (rhsStatus != Math::PointStatus::PSInside) {
                         if (lhsStatus != rhsStatus)
                             return false;
@@ -402,33 +408,15 @@ bool Polyhedron<T,FP,VP>::polyhedronIntersectsPolyhedron(const Polyhedron& lhs,
 }
 
 template <typename T, typename FP, typename VP>
-bool Polyhedron<T,FP,VP>::separate(const Face* firstFace, const Vertex* firstVertex, const Callback& callback) {
+bool Polyhedron<T,FP,VP>::separate(const Face* firstFace, const PositionArray<T>& positions, const Callback& callback) {
     const Face* currentFace = firstFace;
     do {
         const Plane<T,3> plane = callback.plane(currentFace);
-        if (pointStatus(plane, firstVertex) == Math::PointStatus::PSAbove)
+        if (positions.status(plane) == Math::PointStatus::PSAbove)
             return true;
         currentFace = currentFace->next();
     } while (currentFace != firstFace);
     return false;
 }
 
-template <typename T, typename FP, typename VP>
-Math::PointStatus::Type Polyhedron<T,FP,VP>::pointStatus(const Plane<T,3>& plane, const Vertex* firstVertex) {
-    size_t above = 0;
-    size_t below = 0;
-    const Vertex* currentVertex = firstVertex;
-    do {
-        const Math::PointStatus::Type status = plane.pointStatus(currentVertex->position());
-        if (status == Math::PointStatus::PSAbove)
-            ++above;
-        else if (status == Math::PointStatus::PSBelow)
-            ++below;
-        if (above > 0 && below > 0)
-            return Math::PointStatus::PSInside;
-        currentVertex = currentVertex->next();
-    } while (currentVertex != firstVertex);
-    return above > 0 ? Math::PointStatus::PSAbove : Math::PointStatus::PSBelow;
-}
-
 #endif /* Polyhedron_Queries_h */
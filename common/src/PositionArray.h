@@ -0,0 +1,216 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_PositionArray_h
+#define TrenchBroom_PositionArray_h
+
+#include "Algorithms.h"
+#include "Macros.h"
+#include "MathUtils.h"
+#include "Plane.h"
+#include "Vec.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/**
+ * Stores a set of positions as a structure of arrays so that they can be classified against a plane in tight loops
+ * which the compiler can vectorize. This pays off whenever the same set of points is tested against many planes, as
+ * in the separating axis tests of the polyhedron intersection code.
+ *
+ * Up to InlineCapacity positions are stored without allocating, which covers the vertices of almost every brush. The
+ * capacity is fixed when the array is created.
+ */
+template <typename T>
+class PositionArray {
+public:
+    typedef Vec<T,3> value_type;
+
+    struct Counts {
+        size_t above;
+        size_t below;
+        size_t inside;
+
+        Counts(const size_t i_above, const size_t i_below, const size_t i_inside) :
+        above(i_above),
+        below(i_below),
+        inside(i_inside) {}
+    };
+private:
+    static const size_t InlineCapacity = 64;
+    // The number of positions classified per loop before checking whether the status is already decided.
+    static const size_t BlockSize = 16;
+
+    T m_inline[3 * InlineCapacity];
+    std::vector<T> m_heap;
+    T* m_x;
+    T* m_y;
+    T* m_z;
+    size_t m_capacity;
+    size_t m_size;
+    // the largest absolute coordinate value per axis
+    Vec<T,3> m_magnitude;
+public:
+    explicit PositionArray(const size_t capacity) :
+    m_x(m_inline),
+    m_y(m_inline + InlineCapacity),
+    m_z(m_inline + 2 * InlineCapacity),
+    m_capacity(InlineCapacity),
+    m_size(0),
+    m_magnitude(Vec<T,3>::Null) {
+        if (capacity > InlineCapacity) {
+            m_heap.resize(3 * capacity);
+            m_x = m_heap.data();
+            m_y = m_x + capacity;
+            m_z = m_y + capacity;
+            m_capacity = capacity;
+        }
+    }
+
+    template <typename I, typename F = Identity>
+    PositionArray(I cur, I end, const F& getPosition = F()) :
+    PositionArray(static_cast<size_t>(std::distance(cur, end))) {
+        while (cur != end)
+            push_back(getPosition(*cur++));
+    }
+
+    deleteCopyAndAssignment(PositionArray)
+public:
+    // named like this so that positions can be added using std::back_inserter
+    void push_back(const Vec<T,3>& position) {
+        assert(m_size < m_capacity);
+        m_x[m_size] = position[0];
+        m_y[m_size] = position[1];
+        m_z[m_size] = position[2];
+        m_magnitude = max(m_magnitude, position.absolute());
+        ++m_size;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    Vec<T,3> operator[](const size_t index) const {
+        return Vec<T,3>(m_x[index], m_y[index], m_z[index]);
+    }
+
+    /**
+     * Counts the positions above, below and inside the given plane. Yields the same result as calling
+     * Plane::pointStatus for each position.
+     */
+    Counts classify(const Plane<T,3>& plane, const T epsilon = Math::Constants<T>::pointStatusEpsilon()) const {
+        size_t above = 0;
+        size_t below = 0;
+        size_t uncertain = 0;
+        classifyRange(plane, epsilon, 0, m_size, above, below, uncertain);
+
+        if (uncertain > 0)
+            return classifyExactly(plane, epsilon, 0, m_size);
+        return Counts(above, below, m_size - above - below);
+    }
+
+    /**
+     * Returns PSAbove if there are positions above the plane and none below it, PSBelow if there are positions
+     * below the plane and none above it, and PSInside otherwise. Positions inside the plane are ignored, and if all
+     * positions are inside the plane, the result is PSBelow.
+     *
+     * The positions are classified block by block, and no further blocks are examined once there are positions on
+     * both sides of the plane.
+     */
+    Math::PointStatus::Type status(const Plane<T,3>& plane, const T epsilon = Math::Constants<T>::pointStatusEpsilon()) const {
+        size_t above = 0;
+        size_t below = 0;
+        for (size_t first = 0; first < m_size; first += BlockSize) {
+            const size_t last = std::min(first + BlockSize, m_size);
+
+            size_t blockAbove = 0;
+            size_t blockBelow = 0;
+            size_t uncertain = 0;
+            classifyRange(plane, epsilon, first, last, blockAbove, blockBelow, uncertain);
+            if (uncertain > 0) {
+                const Counts counts = classifyExactly(plane, epsilon, first, last);
+                blockAbove = counts.above;
+                blockBelow = counts.below;
+            }
+
+            above += blockAbove;
+            below += blockBelow;
+            if (above > 0 && below > 0)
+                return Math::PointStatus::PSInside;
+        }
+        return above > 0 ? Math::PointStatus::PSAbove : Math::PointStatus::PSBelow;
+    }
+private:
+    /*
+     Branch free so that it can be vectorized. The distances are computed like in Math::Robust::pointStatus, but a
+     single error bound is used for all positions. It is derived from the largest coordinates and therefore at least as
+     large as the error bound of every individual position, so every status decided here agrees with
+     Plane::pointStatus. Positions whose status cannot be decided reliably in floating point are only counted here and
+     must be classified exactly by the caller.
+     */
+    void classifyRange(const Plane<T,3>& plane, const T epsilon, const size_t first, const size_t last, size_t& above, size_t& below, size_t& uncertain) const {
+        const T nx = plane.normal[0];
+        const T ny = plane.normal[1];
+        const T nz = plane.normal[2];
+        const T d = plane.distance;
+
+        const T magnitude = std::abs(nx) * m_magnitude[0] + std::abs(ny) * m_magnitude[1] + std::abs(nz) * m_magnitude[2] + std::abs(d);
+        const T errorBound = static_cast<T>(4.0) * std::numeric_limits<T>::epsilon() * magnitude;
+
+        const T* x = m_x;
+        const T* y = m_y;
+        const T* z = m_z;
+        for (size_t i = first; i < last; ++i) {
+            const T dist = ((x[i] * nx + y[i] * ny) + z[i] * nz) - d;
+
+            const bool isAbove = dist - epsilon > errorBound;
+            const bool isBelow = dist + epsilon < -errorBound;
+            const bool isInside = std::abs(dist) < epsilon - errorBound;
+
+            above += isAbove;
+            below += isBelow;
+            uncertain += !(isAbove | isBelow | isInside);
+        }
+    }
+
+    Counts classifyExactly(const Plane<T,3>& plane, const T epsilon, const size_t first, const size_t last) const {
+        size_t above = 0;
+        size_t below = 0;
+        size_t inside = 0;
+        for (size_t i = first; i < last; ++i) {
+            switch (plane.pointStatus((*this)[i], epsilon)) {
+                case Math::PointStatus::PSAbove:
+                    ++above;
+                    break;
+                case Math::PointStatus::PSBelow:
+                    ++below;
+                    break;
+                default:
+                    ++inside;
+                    break;
+            }
+        }
+        return Counts(above, below, inside);
+    }
+};
+
+#endif
@@ -150,5 +150,7 @@ namespace TrenchBroom {
         Preference<View::KeyboardShortcut> CameraFlyRight(IO::Path("Controls/Camera/Move right"), 'D');
         Preference<View::KeyboardShortcut> CameraFlyUp(IO::Path("Controls/Camera/Move up"), 'Q');
         Preference<View::KeyboardShortcut> CameraFlyDown(IO::Path("Controls/Camera/Move down"), 'X');
+
+        Preference<bool> EnableTracing(IO::Path("Debug/Enable tracing"), false);
     }
 }
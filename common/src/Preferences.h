@@ -143,6 +143,8 @@ namespace TrenchBroom {
         extern Preference<View::KeyboardShortcut> CameraFlyRight;
         extern Preference<View::KeyboardShortcut> CameraFlyUp;
         extern Preference<View::KeyboardShortcut> CameraFlyDown;
+
+        extern Preference<bool> EnableTracing;
     }
 }
 
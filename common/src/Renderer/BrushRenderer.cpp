@@ -28,6 +28,7 @@
 #include "Model/NodeVisitor.h"
 #include "Renderer/IndexArrayMapBuilder.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderProfiler.h"
 #include "Renderer/RenderUtils.h"
 #include "Renderer/TexturedIndexArrayBuilder.h"
 #include "Renderer/VertexSpec.h"
@@ -217,6 +218,17 @@ namespace TrenchBroom {
                     renderEdges(renderBatch);
             }
         }
+
+        void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch) {
+            if (!m_brushes.empty()) {
+                if (!m_valid)
+                    validate();
+                if (renderContext.showFaces())
+                    renderOpaqueFaces(faceBatch);
+                if (renderContext.showEdges() || m_showEdges)
+                    renderEdges(renderBatch);
+            }
+        }
         
         void BrushRenderer::renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_brushes.empty()) {
@@ -227,12 +239,28 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::renderTransparent(RenderContext& renderContext, FaceBatch& faceBatch) {
+            if (!m_brushes.empty()) {
+                if (!m_valid)
+                    validate();
+                if (renderContext.showFaces())
+                    renderTransparentFaces(faceBatch);
+            }
+        }
+
         void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
             m_opaqueFaceRenderer.setGrayscale(m_grayscale);
             m_opaqueFaceRenderer.setTint(m_tint);
             m_opaqueFaceRenderer.setTintColor(m_tintColor);
             m_opaqueFaceRenderer.render(renderBatch);
         }
+
+        void BrushRenderer::renderOpaqueFaces(FaceBatch& faceBatch) {
+            m_opaqueFaceRenderer.setGrayscale(m_grayscale);
+            m_opaqueFaceRenderer.setTint(m_tint);
+            m_opaqueFaceRenderer.setTintColor(m_tintColor);
+            m_opaqueFaceRenderer.render(faceBatch);
+        }
         
         void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch) {
             m_transparentFaceRenderer.setGrayscale(m_grayscale);
@@ -241,6 +269,14 @@ namespace TrenchBroom {
             m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
             m_transparentFaceRenderer.render(renderBatch);
         }
+
+        void BrushRenderer::renderTransparentFaces(FaceBatch& faceBatch) {
+            m_transparentFaceRenderer.setGrayscale(m_grayscale);
+            m_transparentFaceRenderer.setTint(m_tint);
+            m_transparentFaceRenderer.setTintColor(m_tintColor);
+            m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
+            m_transparentFaceRenderer.render(faceBatch);
+        }
         
         void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
             if (m_showOccludedEdges)
@@ -452,6 +488,7 @@ namespace TrenchBroom {
         
         void BrushRenderer::validate() {
             assert(!m_valid);
+            RenderProfiler::TimeSection timeSection(RenderProfiler::Section_ValidateBrushes);
             validateVertices();
             validateIndices();
             m_valid = true;
@@ -31,6 +31,7 @@ namespace TrenchBroom {
     }
     
     namespace Renderer {
+        class FaceBatch;
         class RenderBatch;
         class RenderContext;
         class Vbo;
@@ -165,10 +166,14 @@ namespace TrenchBroom {
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
+            void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+            void renderTransparent(RenderContext& renderContext, FaceBatch& faceBatch);
         private:
             void renderOpaqueFaces(RenderBatch& renderBatch);
+            void renderOpaqueFaces(FaceBatch& faceBatch);
             void renderTransparentFaces(RenderBatch& renderBatch);
+            void renderTransparentFaces(FaceBatch& faceBatch);
             void renderEdges(RenderBatch& renderBatch);
             
             void validate();
@@ -0,0 +1,294 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntityLinkGraph.h"
+
+#include "Macros.h"
+#include "Model/AttributableNode.h"
+#include "Renderer/VertexArray.h"
+#include "View/Selection.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        EntityLinkGraph::Link::Link(const Model::AttributableNode* i_source, const Model::AttributableNode* i_target) :
+        source(i_source),
+        target(i_target) {}
+
+        bool EntityLinkGraph::Link::operator<(const Link& other) const {
+            if (source < other.source)
+                return true;
+            if (source > other.source)
+                return false;
+            return target < other.target;
+        }
+
+        bool EntityLinkGraph::Link::operator==(const Link& other) const {
+            return source == other.source && target == other.target;
+        }
+
+        EntityLinkGraph::EntityLinkGraph() :
+        m_linkMode(Model::EditorContext::EntityLinkMode_None),
+        m_shownLinksChanged(false) {}
+
+        void EntityLinkGraph::clear(const Model::EditorContext::EntityLinkMode linkMode, const Color& defaultColor, const Color& selectedColor) {
+            m_linkMode = linkMode;
+            m_defaultColor = defaultColor;
+            m_selectedColor = selectedColor;
+
+            m_links.clear();
+            m_shownLinks.clear();
+            m_unusedLinks.clear();
+            m_linkIndex.clear();
+            m_vertices.clear();
+
+            m_changedLinks.clear();
+            m_shownLinksChanged = true;
+        }
+
+        void EntityLinkGraph::addLinks(const LinkList& links) {
+            m_links.reserve(m_links.size() + links.size());
+            m_shownLinks.reserve(m_links.size() + links.size());
+            m_vertices.reserve(2 * (m_links.size() + links.size()));
+
+            for (const Link& link : links)
+                addLink(link);
+
+            if (m_linkMode == Model::EditorContext::EntityLinkMode_Transitive)
+                updateTransitiveLinks();
+        }
+
+        void EntityLinkGraph::updateLinks(const Model::AttributableNode* node, const LinkList& links) {
+            LinkList addedLinks = links;
+            std::sort(std::begin(addedLinks), std::end(addedLinks));
+
+            const LinkIndex::const_iterator it = m_linkIndex.find(node);
+            if (it != std::end(m_linkIndex)) {
+                // copy the indices because removing a link modifies the index of the node
+                const IndexList indices = it->second;
+                for (const size_t index : indices) {
+                    const Link& link = m_links[index];
+                    const LinkList::iterator linkIt = std::lower_bound(std::begin(addedLinks), std::end(addedLinks), link);
+                    if (linkIt != std::end(addedLinks) && *linkIt == link) {
+                        addedLinks.erase(linkIt);
+                        updateLinkVertices(index);
+                    } else {
+                        removeLink(index);
+                    }
+                }
+            }
+
+            for (const Link& link : addedLinks) {
+                assert(link.source == node || link.target == node);
+                addLink(link);
+            }
+
+            if (m_linkMode == Model::EditorContext::EntityLinkMode_Transitive)
+                updateTransitiveLinks();
+        }
+
+        void EntityLinkGraph::selectionDidChange(const View::Selection& selection) {
+            updateNodeLinkColors(selection.selectedNodes());
+            updateNodeLinkColors(selection.deselectedNodes());
+            updateNodeLinkColors(selection.partiallySelectedNodes());
+            updateNodeLinkColors(selection.partiallyDeselectedNodes());
+
+            if (m_linkMode == Model::EditorContext::EntityLinkMode_Transitive)
+                updateTransitiveLinks();
+        }
+
+        const EntityLinkGraph::Vertex::List& EntityLinkGraph::vertices() const {
+            return m_vertices;
+        }
+
+        IndexRangeMap EntityLinkGraph::shownLinks() const {
+            IndexRangeMap result;
+            for (size_t i = 0; i < m_links.size(); ++i) {
+                if (m_shownLinks[i])
+                    result.add(GL_LINES, 2 * i, 2);
+            }
+            return result;
+        }
+
+        bool EntityLinkGraph::shownLinksChanged() const {
+            return m_shownLinksChanged;
+        }
+
+        void EntityLinkGraph::updateVertices(VertexArray& vertexArray) const {
+            assert(vertexArray.vertexCount() == m_vertices.size());
+
+            // write consecutive changed links at once
+            std::set<size_t>::const_iterator it = std::begin(m_changedLinks);
+            while (it != std::end(m_changedLinks)) {
+                const size_t first = *it;
+                size_t count = 1;
+                while (++it != std::end(m_changedLinks) && *it == first + count)
+                    ++count;
+                vertexArray.update(2 * first, 2 * count);
+            }
+        }
+
+        void EntityLinkGraph::clearChanges() {
+            m_changedLinks.clear();
+            m_shownLinksChanged = false;
+        }
+
+        void EntityLinkGraph::addLink(const Link& link) {
+            assert(link.source != nullptr && link.target != nullptr);
+
+            size_t index;
+            if (!m_unusedLinks.empty()) {
+                index = m_unusedLinks.back();
+                m_unusedLinks.pop_back();
+                m_links[index] = link;
+                updateLinkVertices(index);
+            } else {
+                index = m_links.size();
+                m_links.push_back(link);
+                m_shownLinks.push_back(false);
+                m_vertices.push_back(Vertex(link.source->linkSourceAnchor(), m_defaultColor));
+                m_vertices.push_back(Vertex(link.target->linkTargetAnchor(), m_defaultColor));
+                updateLinkColor(index);
+            }
+
+            m_linkIndex[link.source].push_back(index);
+            if (link.target != link.source)
+                m_linkIndex[link.target].push_back(index);
+
+            setLinkShown(index, linkShown(link));
+        }
+
+        void EntityLinkGraph::removeLink(const size_t index) {
+            const Link& link = m_links[index];
+            assert(link.source != nullptr);
+
+            unindexLink(link.source, index);
+            if (link.target != link.source)
+                unindexLink(link.target, index);
+
+            setLinkShown(index, false);
+            m_links[index] = Link(nullptr, nullptr);
+            m_unusedLinks.push_back(index);
+        }
+
+        void EntityLinkGraph::unindexLink(const Model::Node* node, const size_t index) {
+            LinkIndex::iterator it = m_linkIndex.find(node);
+            assert(it != std::end(m_linkIndex));
+
+            IndexList& indices = it->second;
+            indices.erase(std::remove(std::begin(indices), std::end(indices), index), std::end(indices));
+            if (indices.empty())
+                m_linkIndex.erase(it);
+        }
+
+        void EntityLinkGraph::updateLinkVertices(const size_t index) {
+            const Link& link = m_links[index];
+            m_vertices[2 * index].v1 = link.source->linkSourceAnchor();
+            m_vertices[2 * index + 1].v1 = link.target->linkTargetAnchor();
+            updateLinkColor(index);
+            m_changedLinks.insert(index);
+        }
+
+        void EntityLinkGraph::updateLinkColor(const size_t index) {
+            const Color& color = linkSelected(m_links[index]) ? m_selectedColor : m_defaultColor;
+            if (m_vertices[2 * index].v2 != color) {
+                m_vertices[2 * index].v2 = color;
+                m_vertices[2 * index + 1].v2 = color;
+                m_changedLinks.insert(index);
+            }
+        }
+
+        void EntityLinkGraph::updateNodeLinkColors(const Model::NodeList& nodes) {
+            for (const Model::Node* node : nodes) {
+                const LinkIndex::const_iterator it = m_linkIndex.find(node);
+                if (it != std::end(m_linkIndex)) {
+                    for (const size_t index : it->second) {
+                        updateLinkColor(index);
+                        if (m_linkMode == Model::EditorContext::EntityLinkMode_Direct)
+                            setLinkShown(index, linkShown(m_links[index]));
+                    }
+                }
+            }
+        }
+
+        static bool nodeSelected(const Model::Node* node) {
+            return node->selected() || node->descendantSelected();
+        }
+
+        bool EntityLinkGraph::linkSelected(const Link& link) const {
+            return nodeSelected(link.source) || nodeSelected(link.target);
+        }
+
+        bool EntityLinkGraph::linkShown(const Link& link) const {
+            switch (m_linkMode) {
+                case Model::EditorContext::EntityLinkMode_All:
+                    return true;
+                case Model::EditorContext::EntityLinkMode_Direct:
+                    return linkSelected(link);
+                case Model::EditorContext::EntityLinkMode_Transitive:
+                    // determined by updateTransitiveLinks
+                    return false;
+                case Model::EditorContext::EntityLinkMode_None:
+                    return false;
+                switchDefault()
+            }
+        }
+
+        void EntityLinkGraph::setLinkShown(const size_t index, const bool shown) {
+            if (m_shownLinks[index] != shown) {
+                m_shownLinks[index] = shown;
+                m_shownLinksChanged = true;
+            }
+        }
+
+        void EntityLinkGraph::updateTransitiveLinks() {
+            // show every link that is connected to a selected node by a chain of links
+            std::vector<bool> shownLinks(m_links.size(), false);
+
+            std::set<const Model::Node*> visited;
+            std::vector<const Model::Node*> stack;
+            for (const auto& entry : m_linkIndex) {
+                if (nodeSelected(entry.first))
+                    stack.push_back(entry.first);
+            }
+
+            while (!stack.empty()) {
+                const Model::Node* node = stack.back();
+                stack.pop_back();
+
+                const LinkIndex::const_iterator it = m_linkIndex.find(node);
+                assert(it != std::end(m_linkIndex));
+                for (const size_t index : it->second) {
+                    if (!shownLinks[index]) {
+                        shownLinks[index] = true;
+                        const Link& link = m_links[index];
+                        const Model::Node* other = link.source == node ? link.target : link.source;
+                        if (!nodeSelected(other) && visited.insert(other).second)
+                            stack.push_back(other);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < m_links.size(); ++i)
+                setLinkShown(i, shownLinks[i]);
+        }
+    }
+}
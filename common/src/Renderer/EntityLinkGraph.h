@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EntityLinkGraph
+#define TrenchBroom_EntityLinkGraph
+
+#include "Color.h"
+#include "Model/EditorContext.h"
+#include "Model/ModelTypes.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/Vertex.h"
+#include "Renderer/VertexSpec.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        class Selection;
+    }
+
+    namespace Renderer {
+        class VertexArray;
+
+        /**
+         * Stores the entity links of a map together with their vertices. Every link occupies two consecutive
+         * vertices at a fixed position, so that a change to a link only touches its own vertices. The links of
+         * a node can be replaced and recolored without collecting all links again, and the changed vertices can
+         * be written into the vertex buffer in place.
+         *
+         * The graph always contains all visible links. The link mode only determines which of them are shown.
+         */
+        class EntityLinkGraph {
+        public:
+            typedef VertexSpecs::P3C4::Vertex Vertex;
+
+            struct Link {
+                const Model::AttributableNode* source;
+                const Model::AttributableNode* target;
+
+                Link(const Model::AttributableNode* i_source, const Model::AttributableNode* i_target);
+
+                bool operator<(const Link& other) const;
+                bool operator==(const Link& other) const;
+            };
+
+            typedef std::vector<Link> LinkList;
+        private:
+            typedef std::vector<size_t> IndexList;
+            typedef std::map<const Model::Node*, IndexList> LinkIndex;
+
+            Model::EditorContext::EntityLinkMode m_linkMode;
+            Color m_defaultColor;
+            Color m_selectedColor;
+
+            LinkList m_links; // a link without a source is unused and can be replaced by a new link
+            std::vector<bool> m_shownLinks;
+            IndexList m_unusedLinks;
+            LinkIndex m_linkIndex; // the indices of the links of every node that is the source or target of a link
+            Vertex::List m_vertices;
+
+            std::set<size_t> m_changedLinks; // the links whose vertices must be written into the vertex buffer
+            bool m_shownLinksChanged;
+        public:
+            EntityLinkGraph();
+
+            void clear(Model::EditorContext::EntityLinkMode linkMode, const Color& defaultColor, const Color& selectedColor);
+
+            void addLinks(const LinkList& links);
+
+            /**
+             * Replaces the links of the given node with the given links, which must contain every link whose source
+             * or target is the given node. Links that still exist keep their vertices, but their anchors are updated.
+             */
+            void updateLinks(const Model::AttributableNode* node, const LinkList& links);
+
+            /**
+             * Updates the colors and visibility of the links whose source or target was selected or deselected.
+             */
+            void selectionDidChange(const View::Selection& selection);
+
+            const Vertex::List& vertices() const;
+
+            /**
+             * Returns the vertex ranges of the links that are shown.
+             */
+            IndexRangeMap shownLinks() const;
+            bool shownLinksChanged() const;
+
+            /**
+             * Writes the vertices of the links that changed since the last call to clearChanges into the given vertex
+             * array, which must refer to the vertices of this graph.
+             */
+            void updateVertices(VertexArray& vertexArray) const;
+            void clearChanges();
+        private:
+            void addLink(const Link& link);
+            void removeLink(size_t index);
+            void unindexLink(const Model::Node* node, size_t index);
+            void updateLinkVertices(size_t index);
+            void updateLinkColor(size_t index);
+            void updateNodeLinkColors(const Model::NodeList& nodes);
+
+            bool linkSelected(const Link& link) const;
+            bool linkShown(const Link& link) const;
+            void setLinkShown(size_t index, bool shown);
+            void updateTransitiveLinks();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityLinkGraph) */
@@ -19,9 +19,7 @@
 
 #include "EntityLinkRenderer.h"
 
-#include "Macros.h"
 #include "Model/AttributableNode.h"
-#include "Model/CollectMatchingNodesVisitor.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Model/NodeVisitor.h"
@@ -41,7 +39,8 @@ namespace TrenchBroom {
         m_document(document),
         m_defaultColor(0.5f, 1.0f, 0.5f, 1.0f),
         m_selectedColor(1.0f, 0.0f, 0.0f, 1.0f),
-        m_valid(false) {}
+        m_valid(false),
+        m_prepared(false) {}
         
         void EntityLinkRenderer::setDefaultColor(const Color& color) {
             if (color == m_defaultColor)
@@ -65,11 +64,27 @@ namespace TrenchBroom {
             m_valid = false;
         }
 
+        void EntityLinkRenderer::selectionDidChange(const View::Selection& selection) {
+            if (m_valid)
+                m_links.selectionDidChange(selection);
+        }
+
         void EntityLinkRenderer::doPrepareVertices(Vbo& vertexVbo) {
-            if (!m_valid) {
+            if (!m_valid)
                 validate();
+            
+            // the vertices are only written again if links were added
+            if (!m_prepared || m_entityLinks.vertexCount() != m_links.vertices().size()) {
+                m_entityLinks = VertexArray::ref(m_links.vertices());
                 m_entityLinks.prepare(vertexVbo);
+                m_shownLinks = m_links.shownLinks();
+                m_prepared = true;
+            } else {
+                m_links.updateVertices(m_entityLinks);
+                if (m_links.shownLinksChanged())
+                    m_shownLinks = m_links.shownLinks();
             }
+            m_links.clearChanges();
         }
 
         void EntityLinkRenderer::doRender(RenderContext& renderContext) {
@@ -81,40 +96,35 @@ namespace TrenchBroom {
 
             glAssert(glDisable(GL_DEPTH_TEST));
             shader.set("Alpha", 0.4f);
-            m_entityLinks.render(GL_LINES);
+            m_shownLinks.render(m_entityLinks);
             
             glAssert(glEnable(GL_DEPTH_TEST));
             shader.set("Alpha", 1.0f);
-            m_entityLinks.render(GL_LINES);
+            m_shownLinks.render(m_entityLinks);
         }
 
         void EntityLinkRenderer::validate() {
-            Vertex::List links;
-            getLinks(links);
-            m_entityLinks = VertexArray::swap(links);
+            View::MapDocumentSPtr document = lock(m_document);
+            const Model::EditorContext::EntityLinkMode linkMode = document->editorContext().entityLinkMode();
+            
+            m_links.clear(linkMode, m_defaultColor, m_selectedColor);
+            if (linkMode != Model::EditorContext::EntityLinkMode_None) {
+                LinkList links;
+                getAllLinks(links);
+                m_links.addLinks(links);
+            }
+            
             m_valid = true;
+            m_prepared = false;
         }
         
-        class EntityLinkRenderer::MatchEntities {
-        public:
-            bool operator()(const Model::Entity* entity) { return true; }
-            bool operator()(const Model::Node* node) { return false; }
-        };
-        
-        class EntityLinkRenderer::CollectEntitiesVisitor : public Model::CollectMatchingNodesVisitor<MatchEntities, Model::UniqueNodeCollectionStrategy> {};
-
         class EntityLinkRenderer::CollectLinksVisitor : public Model::NodeVisitor {
-        protected:
-            const Model::EditorContext& m_editorContext;
         private:
-            const Color& m_defaultColor;
-            const Color& m_selectedColor;
-            Vertex::List& m_links;
-        protected:
-            CollectLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) :
+            const Model::EditorContext& m_editorContext;
+            LinkList& m_links;
+        public:
+            CollectLinksVisitor(const Model::EditorContext& editorContext, LinkList& links) :
             m_editorContext(editorContext),
-            m_defaultColor(defaultColor),
-            m_selectedColor(selectedColor),
             m_links(links) {}
         private:
             void doVisit(Model::World* world) override   {}
@@ -122,165 +132,108 @@ namespace TrenchBroom {
             void doVisit(Model::Group* group) override   {}
             void doVisit(Model::Brush* brush) override   {}
             void doVisit(Model::Entity* entity) override {
-                if (m_editorContext.visible(entity))
-                    visitEntity(entity);
-                stopRecursion();
-            }
-            
-            virtual void visitEntity(Model::Entity* entity) = 0;
-        protected:
-            void addLink(const Model::AttributableNode* source, const Model::AttributableNode* target) {
-                const bool anySelected = source->selected() || source->descendantSelected() || target->selected() || target->descendantSelected();
-                const Color& sourceColor = anySelected ? m_selectedColor : m_defaultColor;
-                Color targetColor = anySelected ? m_selectedColor : m_defaultColor;
-                
-                m_links.push_back(Vertex(source->linkSourceAnchor(), sourceColor));
-                m_links.push_back(Vertex(target->linkTargetAnchor(), targetColor));
-            }
-        };
-        
-        class EntityLinkRenderer::CollectAllLinksVisitor : public CollectLinksVisitor {
-        public:
-            CollectAllLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) :
-            CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
-        private:
-            void visitEntity(Model::Entity* entity) override {
                 if (m_editorContext.visible(entity)) {
                     addTargets(entity, entity->linkTargets());
                     addTargets(entity, entity->killTargets());
                 }
+                stopRecursion();
             }
             
             void addTargets(Model::Entity* source, const Model::AttributableNodeList& targets) {
                 for (const Model::AttributableNode* target : targets) {
                     if (m_editorContext.visible(target))
-                        addLink(source, target);
+                        m_links.push_back(Link(source, target));
                 }
             }
         };
         
-        class EntityLinkRenderer::CollectTransitiveSelectedLinksVisitor : public CollectLinksVisitor {
+        class EntityLinkRenderer::UpdateLinksVisitor : public Model::NodeVisitor {
         private:
-            Model::NodeSet m_visited;
+            const Model::EditorContext& m_editorContext;
+            EntityLinkGraph& m_links;
         public:
-            CollectTransitiveSelectedLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) :
-            CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
+            UpdateLinksVisitor(const Model::EditorContext& editorContext, EntityLinkGraph& links) :
+            m_editorContext(editorContext),
+            m_links(links) {}
         private:
-            void visitEntity(Model::Entity* entity) override {
+            void doVisit(Model::World* world) override   {}
+            void doVisit(Model::Layer* layer) override   {}
+            void doVisit(Model::Group* group) override   {}
+            void doVisit(Model::Brush* brush) override   {}
+            void doVisit(Model::Entity* entity) override {
+                LinkList links;
+                
+                CollectLinksVisitor collectLinks(m_editorContext, links);
+                entity->accept(collectLinks);
+                
                 if (m_editorContext.visible(entity)) {
-                    const bool visited = !m_visited.insert(entity).second;
-                    if (!visited) {
-                        addSources(entity->linkSources(), entity);
-                        addSources(entity->killSources(), entity);
-                        addTargets(entity, entity->linkTargets());
-                        addTargets(entity, entity->killTargets());
-                    }
-                }
-            }
-
-            void addSources(const Model::AttributableNodeList& sources, Model::Entity* target) {
-                for (Model::AttributableNode* source : sources) {
-                    if (m_editorContext.visible(source)) {
-                        addLink(source, target);
-                        source->accept(*this);
-                    }
-                }
-            }
-            
-            void addTargets(Model::Entity* source, const Model::AttributableNodeList& targets) {
-                for (Model::AttributableNode* target : targets) {
-                    if (m_editorContext.visible(target)) {
-                        addLink(source, target);
-                        target->accept(*this);
+                    // the links from other entities to this entity, a link to itself was already collected
+                    Model::AttributableNodeSet sources;
+                    sources.insert(std::begin(entity->linkSources()), std::end(entity->linkSources()));
+                    sources.insert(std::begin(entity->killSources()), std::end(entity->killSources()));
+                    sources.erase(entity);
+                    
+                    LinkList sourceLinks;
+                    CollectLinksVisitor collectSourceLinks(m_editorContext, sourceLinks);
+                    Model::Node::accept(std::begin(sources), std::end(sources), collectSourceLinks);
+                    
+                    for (const Link& link : sourceLinks) {
+                        if (link.target == entity)
+                            links.push_back(link);
                     }
                 }
+                
+                m_links.updateLinks(entity, links);
             }
         };
         
-        class EntityLinkRenderer::CollectDirectSelectedLinksVisitor : public CollectLinksVisitor {
-        public:
-            CollectDirectSelectedLinksVisitor(const Model::EditorContext& editorContext, const Color& defaultColor, const Color& selectedColor, Vertex::List& links) :
-            CollectLinksVisitor(editorContext, defaultColor, selectedColor, links) {}
+        class EntityLinkRenderer::CollectChangedEntitiesVisitor : public Model::NodeVisitor {
         private:
-            void visitEntity(Model::Entity* entity) override {
-                if (entity->selected() || entity->descendantSelected()) {
-                    addSources(entity->linkSources(), entity);
-                    addSources(entity->killSources(), entity);
-                    addTargets(entity, entity->linkTargets());
-                    addTargets(entity, entity->killTargets());
-                }
-            }
-            
-            void addSources(const Model::AttributableNodeList& sources, Model::Entity* target) {
-                for (const Model::AttributableNode* source : sources) {
-                    if (!source->selected() && !source->descendantSelected() && m_editorContext.visible(source))
-                        addLink(source, target);
-                }
+            Model::NodeList m_entities;
+            Model::NodeSet m_visited;
+        public:
+            const Model::NodeList& entities() const {
+                return m_entities;
             }
-            
-            void addTargets(Model::Entity* source, const Model::AttributableNodeList& targets) {
-                for (const Model::AttributableNode* target : targets) {
-                    if (m_editorContext.visible(target))
-                        addLink(source, target);
-                }
+        private:
+            // the document also reports the parents of changed nodes, so the world and the layers must not be searched
+            void doVisit(Model::World* world) override   { stopRecursion(); }
+            void doVisit(Model::Layer* layer) override   { stopRecursion(); }
+            void doVisit(Model::Group* group) override   {}
+            void doVisit(Model::Brush* brush) override   {}
+            void doVisit(Model::Entity* entity) override {
+                if (m_visited.insert(entity).second)
+                    m_entities.push_back(entity);
+                stopRecursion();
             }
         };
         
-        void EntityLinkRenderer::getLinks(Vertex::List& links) const {
+        void EntityLinkRenderer::nodesDidChange(const Model::NodeList& nodes) {
+            if (!m_valid)
+                return;
+            
             View::MapDocumentSPtr document = lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
-            switch (editorContext.entityLinkMode()) {
-                case Model::EditorContext::EntityLinkMode_All:
-                    getAllLinks(links);
-                    break;
-                case Model::EditorContext::EntityLinkMode_Transitive:
-                    getTransitiveSelectedLinks(links);
-                    break;
-                case Model::EditorContext::EntityLinkMode_Direct:
-                    getDirectSelectedLinks(links);
-                    break;
-                case Model::EditorContext::EntityLinkMode_None:
-                    break;
-                switchDefault()
-            }
+            if (editorContext.entityLinkMode() == Model::EditorContext::EntityLinkMode_None)
+                return;
+            
+            CollectChangedEntitiesVisitor collectEntities;
+            Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), collectEntities);
+            
+            const Model::NodeList& entities = collectEntities.entities();
+            UpdateLinksVisitor updateLinks(editorContext, m_links);
+            Model::Node::accept(std::begin(entities), std::end(entities), updateLinks);
         }
         
-        void EntityLinkRenderer::getAllLinks(Vertex::List& links) const {
+        void EntityLinkRenderer::getAllLinks(LinkList& links) const {
             View::MapDocumentSPtr document = lock(m_document);
             const Model::EditorContext& editorContext = document->editorContext();
             
-            CollectAllLinksVisitor collectLinks(editorContext, m_defaultColor, m_selectedColor, links);
+            CollectLinksVisitor collectLinks(editorContext, links);
             
             Model::World* world = document->world();
             if (world != nullptr)
                 world->acceptAndRecurse(collectLinks);
         }
-        
-        void EntityLinkRenderer::getTransitiveSelectedLinks(Vertex::List& links) const {
-            View::MapDocumentSPtr document = lock(m_document);
-            const Model::EditorContext& editorContext = document->editorContext();
-            
-            CollectTransitiveSelectedLinksVisitor visitor(editorContext, m_defaultColor, m_selectedColor, links);
-            collectSelectedLinks(visitor);
-        }
-        
-        void EntityLinkRenderer::getDirectSelectedLinks(Vertex::List& links) const {
-            View::MapDocumentSPtr document = lock(m_document);
-            const Model::EditorContext& editorContext = document->editorContext();
-            
-            CollectDirectSelectedLinksVisitor visitor(editorContext, m_defaultColor, m_selectedColor, links);
-            collectSelectedLinks(visitor);
-        }
-
-        void EntityLinkRenderer::collectSelectedLinks(CollectLinksVisitor& collectLinks) const {
-            View::MapDocumentSPtr document = lock(m_document);
-            
-            const Model::NodeList& selectedNodes = document->selectedNodes().nodes();
-            CollectEntitiesVisitor collectEntities;
-            Model::Node::acceptAndEscalate(std::begin(selectedNodes), std::end(selectedNodes), collectEntities);
-            
-            const Model::NodeList& selectedEntities = collectEntities.nodes();
-            Model::Node::accept(std::begin(selectedEntities), std::end(selectedEntities), collectLinks);
-        }
     }
 }
@@ -22,14 +22,15 @@
 
 #include "Color.h"
 #include "Model/ModelTypes.h"
+#include "Renderer/EntityLinkGraph.h"
+#include "Renderer/IndexRangeMap.h"
 #include "Renderer/Renderable.h"
-#include "Renderer/Vertex.h"
 #include "Renderer/VertexArray.h"
 #include "View/ViewTypes.h"
 
 namespace TrenchBroom {
-    namespace Model {
-        class EditorContext;
+    namespace View {
+        class Selection;
     }
     
     namespace Renderer {
@@ -38,15 +39,19 @@ namespace TrenchBroom {
         
         class EntityLinkRenderer : public DirectRenderable {
         private:
-            typedef VertexSpecs::P3C4::Vertex Vertex;
+            typedef EntityLinkGraph::Link Link;
+            typedef EntityLinkGraph::LinkList LinkList;
             
             View::MapDocumentWPtr m_document;
             
             Color m_defaultColor;
             Color m_selectedColor;
             
+            EntityLinkGraph m_links;
             VertexArray m_entityLinks;
+            IndexRangeMap m_shownLinks;
             bool m_valid;
+            bool m_prepared;
         public:
             EntityLinkRenderer(View::MapDocumentWPtr document);
             
@@ -55,25 +60,24 @@ namespace TrenchBroom {
             
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void invalidate();
+            
+            /**
+             * Replaces the links of the changed entities and of the entities in changed groups, and moves the
+             * anchors of their links.
+             */
+            void nodesDidChange(const Model::NodeList& nodes);
+            void selectionDidChange(const View::Selection& selection);
         private:
             void doPrepareVertices(Vbo& vertexVbo);
             void doRender(RenderContext& renderContext);
         private:
             void validate();
             
-            class MatchEntities;
-            class CollectEntitiesVisitor;
-            
             class CollectLinksVisitor;
-            class CollectAllLinksVisitor;
-            class CollectTransitiveSelectedLinksVisitor;
-            class CollectDirectSelectedLinksVisitor;
+            class UpdateLinksVisitor;
+            class CollectChangedEntitiesVisitor;
 
-            void getLinks(Vertex::List& links) const;
-            void getAllLinks(Vertex::List& links) const;
-            void getTransitiveSelectedLinks(Vertex::List& links) const;
-            void getDirectSelectedLinks(Vertex::List& links) const;
-            void collectSelectedLinks(CollectLinksVisitor& collectLinks) const;
+            void getAllLinks(LinkList& links) const;
             
             EntityLinkRenderer(const EntityLinkRenderer& other);
             EntityLinkRenderer& operator=(const EntityLinkRenderer& other);
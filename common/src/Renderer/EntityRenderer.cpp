@@ -34,6 +34,7 @@
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderProfiler.h"
 #include "Renderer/RenderService.h"
 #include "Renderer/RenderUtils.h"
 #include "Renderer/ShaderManager.h"
@@ -151,6 +152,7 @@ namespace TrenchBroom {
 
         void EntityRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_entities.empty()) {
+                RenderProfiler::TimeSection timeSection(RenderProfiler::Section_RenderEntities);
                 renderBounds(renderContext, renderBatch);
                 renderModels(renderContext, renderBatch);
                 renderClassnames(renderContext, renderBatch);
@@ -0,0 +1,242 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FaceBatch.h"
+
+#include "Macros.h"
+#include "Renderer/GL.h"
+#include "Preferences.h"
+#include "PreferenceManager.h"
+#include "Assets/Texture.h"
+#include "Renderer/Camera.h"
+#include "Renderer/FaceRenderer.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/RenderUtils.h"
+#include "Renderer/Shaders.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/ShaderProgram.h"
+
+#include <cassert>
+#include <map>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        FaceBatch::RenderFunc::~RenderFunc() {}
+
+        /**
+         * Passes the textures of one renderer on to the batch's render function, skipping a texture that is
+         * already bound. Untextured faces are always passed on because their color depends on the renderer.
+         */
+        class FaceBatch::TextureFunc : public TextureRenderFunc {
+        private:
+            RenderFunc& m_func;
+            const FaceRenderer& m_renderer;
+            const Assets::Texture*& m_boundTexture;
+        public:
+            TextureFunc(RenderFunc& func, const FaceRenderer& renderer, const Assets::Texture*& boundTexture) :
+            m_func(func),
+            m_renderer(renderer),
+            m_boundTexture(boundTexture) {}
+
+            void before(const Assets::Texture* texture) override {
+                if (texture != nullptr && texture == m_boundTexture)
+                    return;
+                if (texture == nullptr && m_boundTexture != nullptr)
+                    m_func.unbindTexture(m_boundTexture);
+                m_func.bindTexture(texture, m_renderer);
+                m_boundTexture = texture;
+            }
+        };
+
+        class FaceBatch::ShaderRenderFunc : public RenderFunc {
+        private:
+            ActiveShader& m_shader;
+            bool m_applyTexture;
+            const FaceRenderer* m_previous;
+        public:
+            ShaderRenderFunc(ActiveShader& shader, const bool applyTexture) :
+            m_shader(shader),
+            m_applyTexture(applyTexture),
+            m_previous(nullptr) {}
+
+            void before(const FaceRenderer& renderer) override {
+                if (m_previous == nullptr || m_previous->m_tint != renderer.m_tint || (renderer.m_tint && m_previous->m_tintColor != renderer.m_tintColor)) {
+                    m_shader.set("ApplyTinting", renderer.m_tint);
+                    if (renderer.m_tint)
+                        m_shader.set("TintColor", renderer.m_tintColor);
+                }
+                if (m_previous == nullptr || m_previous->m_grayscale != renderer.m_grayscale)
+                    m_shader.set("GrayScale", renderer.m_grayscale);
+                if (m_previous == nullptr || m_previous->m_alpha != renderer.m_alpha)
+                    m_shader.set("Alpha", renderer.m_alpha);
+                m_previous = &renderer;
+
+                if (renderer.m_alpha < 1.0f)
+                    glAssert(glDepthMask(GL_FALSE));
+            }
+
+            void bindTexture(const Assets::Texture* texture, const FaceRenderer& renderer) override {
+                if (texture != nullptr) {
+                    texture->activate();
+                    m_shader.set("ApplyTexture", m_applyTexture);
+                    m_shader.set("Color", texture->averageColor());
+                } else {
+                    m_shader.set("ApplyTexture", false);
+                    m_shader.set("Color", renderer.m_faceColor);
+                }
+            }
+
+            void unbindTexture(const Assets::Texture* texture) override {
+                texture->deactivate();
+            }
+
+            void after(const FaceRenderer& renderer) override {
+                if (renderer.m_alpha < 1.0f)
+                    glAssert(glDepthMask(GL_TRUE));
+            }
+        };
+
+        FaceBatch::FaceBatch(const Order order) :
+        m_order(order) {}
+
+        void FaceBatch::add(FaceRenderer* renderer) {
+            assert(renderer != nullptr);
+            m_renderers.push_back(renderer);
+        }
+
+        bool FaceBatch::empty() const {
+            return m_renderers.empty();
+        }
+
+        void FaceBatch::renderFaces(RenderContext& context) {
+            ShaderManager& shaderManager = context.shaderManager();
+            ActiveShader shader(shaderManager, Shaders::FaceShader);
+            PreferenceManager& prefs = PreferenceManager::instance();
+
+            const bool applyTexture = context.showTextures();
+            const bool shadeFaces = context.shadeFaces();
+            const bool showFog = context.showFog();
+
+            glAssert(glEnable(GL_TEXTURE_2D));
+            glAssert(glActiveTexture(GL_TEXTURE0));
+            shader.set("Brightness", prefs.get(Preferences::Brightness));
+            shader.set("RenderGrid", context.showGrid());
+            shader.set("GridSize", static_cast<float>(context.gridSize()));
+            shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
+            shader.set("Texture", 0);
+            shader.set("CameraPosition", context.camera().position());
+            shader.set("ShadeFaces", shadeFaces);
+            shader.set("ShowFog", showFog);
+
+            ShaderRenderFunc func(shader, applyTexture);
+            renderFaces(func);
+        }
+
+        void FaceBatch::renderFaces(RenderFunc& func) {
+            switch (m_order) {
+                case Order_Renderers:
+                    renderInRendererOrder(func);
+                    break;
+                case Order_Textures:
+                    renderInTextureOrder(func);
+                    break;
+                switchDefault()
+            }
+        }
+
+        void FaceBatch::renderInRendererOrder(RenderFunc& func) {
+            const Assets::Texture* boundTexture = nullptr;
+
+            for (FaceRenderer* renderer : m_renderers) {
+                if (renderer->m_meshRenderer.empty() || !renderer->m_vertexArray.setup())
+                    continue;
+
+                func.before(*renderer);
+                TextureFunc textureFunc(func, *renderer, boundTexture);
+                renderer->m_meshRenderer.render(textureFunc);
+                func.after(*renderer);
+
+                renderer->m_vertexArray.cleanup();
+            }
+
+            if (boundTexture != nullptr)
+                func.unbindTexture(boundTexture);
+        }
+
+        void FaceBatch::renderInTextureOrder(RenderFunc& func) {
+            typedef std::map<const Assets::Texture*, FaceRendererList> TextureToRenderers;
+            TextureToRenderers textureToRenderers;
+
+            for (FaceRenderer* renderer : m_renderers) {
+                if (!renderer->m_meshRenderer.empty()) {
+                    for (const Assets::Texture* texture : renderer->m_meshRenderer.textures())
+                        textureToRenderers[texture].push_back(renderer);
+                }
+            }
+
+            // the renderer whose vertex array is currently set up
+            FaceRenderer* setupRenderer = nullptr;
+            for (const auto& entry : textureToRenderers) {
+                const Assets::Texture* texture = entry.first;
+                const FaceRendererList& renderers = entry.second;
+
+                bool bound = false;
+                for (FaceRenderer* renderer : renderers) {
+                    if (renderer != setupRenderer) {
+                        if (setupRenderer != nullptr)
+                            setupRenderer->m_vertexArray.cleanup();
+                        setupRenderer = renderer->m_vertexArray.setup() ? renderer : nullptr;
+                        if (setupRenderer == nullptr)
+                            continue;
+                    }
+
+                    func.before(*renderer);
+                    // untextured faces are always passed on because their color depends on the renderer
+                    if (!bound || texture == nullptr) {
+                        func.bindTexture(texture, *renderer);
+                        bound = true;
+                    }
+                    renderer->m_meshRenderer.render(texture);
+                    func.after(*renderer);
+                }
+
+                if (bound && texture != nullptr)
+                    func.unbindTexture(texture);
+            }
+
+            if (setupRenderer != nullptr)
+                setupRenderer->m_vertexArray.cleanup();
+        }
+
+        void FaceBatch::doPrepareVertices(Vbo& vertexVbo) {
+            for (FaceRenderer* renderer : m_renderers)
+                renderer->prepareVertices(vertexVbo);
+        }
+
+        void FaceBatch::doPrepareIndices(Vbo& indexVbo) {
+            for (FaceRenderer* renderer : m_renderers)
+                renderer->prepareIndices(indexVbo);
+        }
+
+        void FaceBatch::doRender(RenderContext& context) {
+            renderFaces(context);
+        }
+    }
+}
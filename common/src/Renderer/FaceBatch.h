@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_FaceBatch
+#define TrenchBroom_FaceBatch
+
+#include "Renderer/Renderable.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace Renderer {
+        class FaceRenderer;
+        class RenderContext;
+        class Vbo;
+
+        /**
+         * Collects face renderers and renders them with a single activation of the face shader. Each renderer's
+         * vertex array is set up only when the previous faces belong to a different renderer, the uniforms that
+         * depend on the renderers' settings are only changed if they differ from the previous renderer, and a
+         * texture is not bound again if it is already bound.
+         *
+         * In renderer order, the renderers are rendered in the order in which they were added, and the faces of each
+         * renderer are rendered in the order of its textures, so the result is the same as rendering the renderers
+         * individually. This is required for transparent faces. In texture order, the faces of all renderers are
+         * grouped by texture so that each texture is bound only once. Within each group, the renderers are rendered
+         * in the order in which they were added.
+         *
+         * The collected renderers must remain valid until the batch is rendered.
+         */
+        class FaceBatch : public IndexedRenderable {
+        public:
+            typedef enum {
+                Order_Renderers,
+                Order_Textures
+            } Order;
+
+            class RenderFunc {
+            public:
+                virtual ~RenderFunc();
+
+                virtual void before(const FaceRenderer& renderer) = 0;
+                virtual void bindTexture(const Assets::Texture* texture, const FaceRenderer& renderer) = 0;
+                virtual void unbindTexture(const Assets::Texture* texture) = 0;
+                virtual void after(const FaceRenderer& renderer) = 0;
+            };
+        private:
+            class TextureFunc;
+            class ShaderRenderFunc;
+
+            typedef std::vector<FaceRenderer*> FaceRendererList;
+            Order m_order;
+            FaceRendererList m_renderers;
+        public:
+            explicit FaceBatch(Order order = Order_Renderers);
+
+            void add(FaceRenderer* renderer);
+            bool empty() const;
+
+            void renderFaces(RenderContext& context);
+            void renderFaces(RenderFunc& func);
+        private:
+            void renderInRendererOrder(RenderFunc& func);
+            void renderInTextureOrder(RenderFunc& func);
+
+            void doPrepareVertices(Vbo& vertexVbo) override;
+            void doPrepareIndices(Vbo& indexVbo) override;
+            void doRender(RenderContext& context) override;
+        private:
+            FaceBatch(const FaceBatch& other);
+            FaceBatch& operator=(const FaceBatch& other);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_FaceBatch) */
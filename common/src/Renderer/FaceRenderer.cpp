@@ -19,46 +19,11 @@
 
 #include "FaceRenderer.h"
 
-#include "Renderer/GL.h"
-#include "Preferences.h"
-#include "PreferenceManager.h"
-#include "Assets/Texture.h"
-#include "Renderer/Camera.h"
-#include "Renderer/RenderContext.h"
-#include "Renderer/RenderUtils.h"
-#include "Renderer/Shaders.h"
-#include "Renderer/ShaderProgram.h"
-#include "Renderer/ShaderManager.h"
+#include "Renderer/FaceBatch.h"
+#include "Renderer/RenderBatch.h"
 
 namespace TrenchBroom {
     namespace Renderer {
-        struct FaceRenderer::RenderFunc : public TextureRenderFunc {
-            ActiveShader& shader;
-            bool applyTexture;
-            const Color& defaultColor;
-            
-            RenderFunc(ActiveShader& i_shader, const bool i_applyTexture, const Color& i_defaultColor) :
-            shader(i_shader),
-            applyTexture(i_applyTexture),
-            defaultColor(i_defaultColor) {}
-            
-            void before(const Assets::Texture* texture) override {
-                if (texture != nullptr) {
-                    texture->activate();
-                    shader.set("ApplyTexture", applyTexture);
-                    shader.set("Color", texture->averageColor());
-                } else {
-                    shader.set("ApplyTexture", false);
-                    shader.set("Color", defaultColor);
-                }
-            }
-            
-            void after(const Assets::Texture* texture) override {
-                if (texture != nullptr)
-                    texture->deactivate();
-            }
-        };
-        
         FaceRenderer::FaceRenderer() :
         m_grayscale(false),
         m_tint(false),
@@ -118,6 +83,10 @@ namespace TrenchBroom {
             renderBatch.add(this);
         }
 
+        void FaceRenderer::render(FaceBatch& faceBatch) {
+            faceBatch.add(this);
+        }
+
         void FaceRenderer::doPrepareVertices(Vbo& vertexVbo) {
             m_vertexArray.prepare(vertexVbo);
         }
@@ -127,45 +96,9 @@ namespace TrenchBroom {
         }
         
         void FaceRenderer::doRender(RenderContext& context) {
-            if (m_meshRenderer.empty())
-                return;
-            
-            if (m_vertexArray.setup()) {
-                ShaderManager& shaderManager = context.shaderManager();
-                ActiveShader shader(shaderManager, Shaders::FaceShader);
-                PreferenceManager& prefs = PreferenceManager::instance();
-                
-                const bool applyTexture = context.showTextures();
-                const bool shadeFaces = context.shadeFaces();
-                const bool showFog = context.showFog();
-                
-                glAssert(glEnable(GL_TEXTURE_2D));
-                glAssert(glActiveTexture(GL_TEXTURE0));
-                shader.set("Brightness", prefs.get(Preferences::Brightness));
-                shader.set("RenderGrid", context.showGrid());
-                shader.set("GridSize", static_cast<float>(context.gridSize()));
-                shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-                shader.set("ApplyTexture", applyTexture);
-                shader.set("Texture", 0);
-                shader.set("ApplyTinting", m_tint);
-                if (m_tint)
-                    shader.set("TintColor", m_tintColor);
-                shader.set("GrayScale", m_grayscale);
-                shader.set("CameraPosition", context.camera().position());
-                shader.set("ShadeFaces", shadeFaces);
-                shader.set("ShowFog", showFog);
-                shader.set("Alpha", m_alpha);
-                
-                RenderFunc func(shader, applyTexture, m_faceColor);
-                if (m_alpha < 1.0f) {
-                    glAssert(glDepthMask(GL_FALSE));
-                    m_meshRenderer.render(func);
-                    glAssert(glDepthMask(GL_TRUE));
-                } else {
-                    m_meshRenderer.render(func);
-                }
-                m_vertexArray.cleanup();
-            }
+            FaceBatch faceBatch;
+            faceBatch.add(this);
+            faceBatch.renderFaces(context);
         }
     }
 }
@@ -31,7 +31,7 @@
 
 namespace TrenchBroom {
     namespace Renderer {
-        class ActiveShader;
+        class FaceBatch;
         class RenderBatch;
         class RenderContext;
         class TexturedIndexArrayMap;
@@ -39,8 +39,8 @@ namespace TrenchBroom {
         
         class FaceRenderer : public IndexedRenderable {
         private:
-            struct RenderFunc;
-            
+            friend class FaceBatch;
+
             VertexArray m_vertexArray;
             TexturedIndexArrayRenderer m_meshRenderer;
             Color m_faceColor;
@@ -62,6 +62,7 @@ namespace TrenchBroom {
             void setAlpha(float alpha);
             
             void render(RenderBatch& renderBatch);
+            void render(FaceBatch& faceBatch);
         private:
             void doPrepareVertices(Vbo& vertexVbo);
             void doPrepareIndices(Vbo& indexVbo);
@@ -27,6 +27,9 @@ namespace TrenchBroom {
         FontManager::FontManager() :
         m_factory(new FreeTypeFontFactory()) {}
         
+        FontManager::FontManager(FontFactory* factory) :
+        m_factory(factory) {}
+        
         FontManager::~FontManager() {
             MapUtils::clearAndDelete(m_cache);
             delete m_factory;
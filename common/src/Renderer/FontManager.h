@@ -37,6 +37,11 @@ namespace TrenchBroom {
             FontCache m_cache;
         public:
             FontManager();
+            
+            /**
+             * Creates a font manager that creates its fonts using the given factory, which it takes ownership of.
+             */
+            explicit FontManager(FontFactory* factory);
             ~FontManager();
             
             TextureFont& font(const FontDescriptor& fontDescriptor);
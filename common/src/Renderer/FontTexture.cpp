@@ -19,6 +19,8 @@
 
 #include "FontTexture.h"
 
+#include "Renderer/RenderProfiler.h"
+
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -84,6 +86,7 @@ namespace TrenchBroom {
             
             assert(m_textureId > 0);
             glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+            RenderProfiler::instance().countTextureBind();
         }
         
         void FontTexture::deactivate() {
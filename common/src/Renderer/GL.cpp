@@ -177,6 +177,11 @@ namespace TrenchBroom {
     
     Func2<GLint, GLuint, const GLchar*> glGetUniformLocation;
     
+    Func2<void, GLsizei, GLuint*> glGenQueries;
+    Func2<void, GLenum, GLuint> glBeginQuery;
+    Func1<void, GLenum> glEndQuery;
+    Func3<void, GLuint, GLenum, GLuint*> glGetQueryObjectuiv;
+    
 #ifdef __APPLE__
     Func2<void, GLenum, GLint> glFinishObjectAPPLE;
 #endif
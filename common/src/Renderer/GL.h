@@ -166,6 +166,10 @@ namespace TrenchBroom {
 #define GL_DYNAMIC_READ 0x88E9
 #define GL_DYNAMIC_COPY 0x88EA
 
+#define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#define GL_TIME_ELAPSED 0x88BF
+
 #define GL_FRAGMENT_SHADER 0x8B30
 #define GL_VERTEX_SHADER 0x8B31
 #define GL_COMPILE_STATUS 0x8B81
@@ -365,6 +369,11 @@ namespace TrenchBroom {
     extern Func4<void, GLint, GLsizei, GLboolean, const GLfloat*> glUniformMatrix4x3fv;
     
     extern Func2<GLint, GLuint, const GLchar*> glGetUniformLocation;
+    
+    extern Func2<void, GLsizei, GLuint*> glGenQueries;
+    extern Func2<void, GLenum, GLuint> glBeginQuery;
+    extern Func1<void, GLenum> glEndQuery;
+    extern Func3<void, GLuint, GLenum, GLuint*> glGetQueryObjectuiv;
 
 #ifdef __APPLE__
     extern Func2<void, GLenum, GLint> glFinishObjectAPPLE;
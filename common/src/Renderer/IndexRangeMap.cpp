@@ -45,9 +45,9 @@ namespace TrenchBroom {
                 case GL_LINES:
                 case GL_TRIANGLES:
                 case GL_QUADS: {
-                    if (size() == 1) {
-                        const GLint myIndex = indices.front();
-                        GLsizei& myCount = counts.front();
+                    if (size() > 0) {
+                        const GLint myIndex = indices.back();
+                        GLsizei& myCount = counts.back();
                         
                         if (index == static_cast<size_t>(myIndex) + static_cast<size_t>(myCount)) {
                             myCount += count;
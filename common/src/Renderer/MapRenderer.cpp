@@ -32,14 +32,17 @@
 #include "Model/Layer.h"
 #include "Model/Node.h"
 #include "Model/NodeVisitor.h"
+#include "Model/ParallelNodeVisitor.h"
 #include "Model/Tutorial.h"
 #include "Model/World.h"
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/Camera.h"
 #include "Renderer/EntityLinkRenderer.h"
+#include "Renderer/FaceBatch.h"
 #include "Renderer/ObjectRenderer.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderProfiler.h"
 #include "Renderer/RenderService.h"
 #include "Renderer/RenderUtils.h"
 #include "View/Selection.h"
@@ -207,19 +210,29 @@ namespace TrenchBroom {
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             commitPendingChanges();
             setupGL(renderBatch);
-            renderDefaultOpaque(renderContext, renderBatch);
-            renderLockedOpaque(renderContext, renderBatch);
-            renderSelectionOpaque(renderContext, renderBatch);
+
+            // the opaque faces of all renderers are grouped by texture so that each texture is bound only once; the
+            // batch is added before the renderers add their edges, entities and groups, so those are still rendered
+            // after the faces
+            FaceBatch* opaqueFaces = new FaceBatch(FaceBatch::Order_Textures);
+            renderBatch.addOneShot(opaqueFaces);
+            renderDefaultOpaque(renderContext, renderBatch, *opaqueFaces);
+            renderLockedOpaque(renderContext, renderBatch, *opaqueFaces);
+            renderSelectionOpaque(renderContext, renderBatch, *opaqueFaces);
             
-            renderDefaultTransparent(renderContext, renderBatch);
-            renderLockedTransparent(renderContext, renderBatch);
-            renderSelectionTransparent(renderContext, renderBatch);
+            // the transparent faces of the renderers are rendered one after the other, so they can share a batch
+            FaceBatch* transparentFaces = new FaceBatch();
+            renderBatch.addOneShot(transparentFaces);
+            renderDefaultTransparent(renderContext, *transparentFaces);
+            renderLockedTransparent(renderContext, *transparentFaces);
+            renderSelectionTransparent(renderContext, *transparentFaces);
             
             renderEntityLinks(renderContext, renderBatch);
             renderTutorialMessages(renderContext, renderBatch);
         }
         
         void MapRenderer::commitPendingChanges() {
+            RenderProfiler::TimeSection timeSection(RenderProfiler::Section_CommitPendingChanges);
             View::MapDocumentSPtr document = lock(m_document);
             document->commitPendingAssets();
         }
@@ -239,36 +252,36 @@ namespace TrenchBroom {
             renderBatch.addOneShot(new SetupGL());
         }
         
-        void MapRenderer::renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch) {
             m_defaultRenderer->setShowOverlays(renderContext.render3D());
-            m_defaultRenderer->renderOpaque(renderContext, renderBatch);
+            m_defaultRenderer->renderOpaque(renderContext, renderBatch, faceBatch);
         }
         
-        void MapRenderer::renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderDefaultTransparent(RenderContext& renderContext, FaceBatch& faceBatch) {
             m_defaultRenderer->setShowOverlays(renderContext.render3D());
-            m_defaultRenderer->renderTransparent(renderContext, renderBatch);
+            m_defaultRenderer->renderTransparent(renderContext, faceBatch);
         }
         
-        void MapRenderer::renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch) {
             if (!renderContext.hideSelection()) {
-                m_selectionRenderer->renderOpaque(renderContext, renderBatch);
+                m_selectionRenderer->renderOpaque(renderContext, renderBatch, faceBatch);
             }
         }
         
-        void MapRenderer::renderSelectionTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderSelectionTransparent(RenderContext& renderContext, FaceBatch& faceBatch) {
             if (!renderContext.hideSelection()) {
-                m_selectionRenderer->renderTransparent(renderContext, renderBatch);
+                m_selectionRenderer->renderTransparent(renderContext, faceBatch);
             }
         }
         
-        void MapRenderer::renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch) {
             m_lockedRenderer->setShowOverlays(renderContext.render3D());
-            m_lockedRenderer->renderOpaque(renderContext, renderBatch);
+            m_lockedRenderer->renderOpaque(renderContext, renderBatch, faceBatch);
         }
         
-        void MapRenderer::renderLockedTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
+        void MapRenderer::renderLockedTransparent(RenderContext& renderContext, FaceBatch& faceBatch) {
             m_lockedRenderer->setShowOverlays(renderContext.render3D());
-            m_lockedRenderer->renderTransparent(renderContext, renderBatch);
+            m_lockedRenderer->renderTransparent(renderContext, faceBatch);
         }
         
         void MapRenderer::renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch) {
@@ -398,6 +411,12 @@ namespace TrenchBroom {
             const Model::NodeCollection& defaultNodes() const  { return m_defaultNodes;  }
             const Model::NodeCollection& selectedNodes() const { return m_selectedNodes; }
             const Model::NodeCollection& lockedNodes() const   { return m_lockedNodes;   }
+            
+            void merge(const CollectRenderableNodes& other) {
+                m_defaultNodes.addNodes(other.m_defaultNodes.nodes());
+                m_selectedNodes.addNodes(other.m_selectedNodes.nodes());
+                m_lockedNodes.addNodes(other.m_lockedNodes.nodes());
+            }
         private:
             void doVisit(Model::World* world) override   {}
             void doVisit(Model::Layer* layer) override   {}
@@ -447,7 +466,8 @@ namespace TrenchBroom {
             Model::World* world = document->world();
             
             CollectRenderableNodes collect(renderers);
-            world->acceptAndRecurse(collect);
+            for (const CollectRenderableNodes& visitor : Model::acceptAndRecurseParallel<CollectRenderableNodes>(world, [renderers]() { return CollectRenderableNodes(renderers); }))
+                collect.merge(visitor);
             
             if ((renderers & Renderer_Default) != 0) {
                 m_defaultRenderer->setObjects(collect.defaultNodes().groups(),
@@ -464,7 +484,6 @@ namespace TrenchBroom {
                                              collect.lockedNodes().entities(),
                                              collect.lockedNodes().brushes());
             }
-            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::invalidateRenderers(Renderer renderers) {
@@ -544,35 +563,42 @@ namespace TrenchBroom {
         void MapRenderer::documentWasNewedOrLoaded(View::MapDocument* document) {
             clear();
             updateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodesWereAdded(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodesWereRemoved(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodesDidChange(const Model::NodeList& nodes) {
             invalidateRenderers(Renderer_Selection);
-            invalidateEntityLinkRenderer();
+            m_entityLinkRenderer->nodesDidChange(nodes);
         }
         
         void MapRenderer::nodeVisibilityDidChange(const Model::NodeList& nodes) {
             updateRenderers(Renderer_All);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::nodeLockingDidChange(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default_Locked);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::groupWasOpened(Model::Group* group) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
         
         void MapRenderer::groupWasClosed(Model::Group* group) {
             updateRenderers(Renderer_Default_Selection);
+            invalidateEntityLinkRenderer();
         }
 
         void MapRenderer::brushFacesDidChange(const Model::BrushFaceList& faces) {
@@ -581,6 +607,7 @@ namespace TrenchBroom {
         
         void MapRenderer::selectionDidChange(const View::Selection& selection) {
             updateRenderers(Renderer_All); // need to update locked objects also because a selected object may have been reparented into a locked layer before deselection
+            m_entityLinkRenderer->selectionDidChange(selection);
         }
         
         Model::BrushSet MapRenderer::collectBrushes(const Model::BrushFaceList& faces) {
@@ -37,6 +37,7 @@ namespace TrenchBroom {
     
     namespace Renderer {
         class EntityLinkRenderer;
+        class FaceBatch;
         class FontManager;
         class ObjectRenderer;
         class RenderBatch;
@@ -72,12 +73,12 @@ namespace TrenchBroom {
         private:
             void commitPendingChanges();
             void setupGL(RenderBatch& renderBatch);
-            void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderDefaultTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderSelectionTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderLockedTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+            void renderDefaultOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch);
+            void renderDefaultTransparent(RenderContext& renderContext, FaceBatch& faceBatch);
+            void renderSelectionOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch);
+            void renderSelectionTransparent(RenderContext& renderContext, FaceBatch& faceBatch);
+            void renderLockedOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch);
+            void renderLockedTransparent(RenderContext& renderContext, FaceBatch& faceBatch);
             void renderEntityLinks(RenderContext& renderContext, RenderBatch& renderBatch);
             
             class MatchTutorialEntities;
@@ -131,14 +131,14 @@ namespace TrenchBroom {
             m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
         }
 
-        void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
-            m_brushRenderer.renderOpaque(renderContext, renderBatch);
+        void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch) {
+            m_brushRenderer.renderOpaque(renderContext, renderBatch, faceBatch);
             m_entityRenderer.render(renderContext, renderBatch);
             m_groupRenderer.render(renderContext, renderBatch);
         }
         
-        void ObjectRenderer::renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch) {
-            m_brushRenderer.renderTransparent(renderContext, renderBatch);
+        void ObjectRenderer::renderTransparent(RenderContext& renderContext, FaceBatch& faceBatch) {
+            m_brushRenderer.renderTransparent(renderContext, faceBatch);
         }
     }
 }
@@ -32,6 +32,7 @@ namespace TrenchBroom {
     }
     
     namespace Renderer {
+        class FaceBatch;
         class FontManager;
         class RenderBatch;
         
@@ -79,8 +80,8 @@ namespace TrenchBroom {
             
             void setShowHiddenObjects(bool showHiddenObjects);
         public: // rendering
-            void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
-            void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
+            void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch, FaceBatch& faceBatch);
+            void renderTransparent(RenderContext& renderContext, FaceBatch& faceBatch);
         private:
             ObjectRenderer(const ObjectRenderer&);
             ObjectRenderer& operator=(const ObjectRenderer&);
@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/RenderProfiler.h"
 #include "Renderer/Vbo.h"
 
 namespace TrenchBroom {
@@ -94,6 +95,7 @@ namespace TrenchBroom {
         }
         
         void RenderBatch::render(RenderContext& renderContext) {
+            RenderProfiler::TimeSection timeSection(RenderProfiler::Section_RenderBatch);
             ActivateVbo activate(m_vertexVbo);
 
             prepareRenderables();
@@ -0,0 +1,258 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "RenderProfiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static const char* SectionLabels[RenderProfiler::Section_Count] = {
+            "Render batch",
+            "Commit changes",
+            "Validate brushes",
+            "Render entities",
+            "Render text",
+            "Pick"
+        };
+
+        static const char* SectionColumns[RenderProfiler::Section_Count] = {
+            "render_batch_ms",
+            "commit_pending_changes_ms",
+            "validate_brushes_ms",
+            "render_entities_ms",
+            "render_text_ms",
+            "pick_ms"
+        };
+
+        const size_t RenderProfiler::Capacity;
+
+        RenderProfiler::Frame::Frame() :
+        cpuMs(0.0),
+        gpuMs(-1.0),
+        drawCalls(0),
+        textureBinds(0),
+        uploadedBytes(0) {
+            std::fill(std::begin(sectionMs), std::end(sectionMs), 0.0);
+        }
+
+        RenderProfiler::TimeSection::TimeSection(const Section section) :
+        m_section(section),
+        m_enabled(RenderProfiler::instance().enabled()) {
+            if (m_enabled)
+                m_start = Clock::now();
+        }
+
+        RenderProfiler::TimeSection::~TimeSection() {
+            if (m_enabled) {
+                const std::chrono::duration<double, std::milli> duration = Clock::now() - m_start;
+                RenderProfiler::instance().addTime(m_section, duration.count());
+            }
+        }
+
+        RenderProfiler::GPUTimer::GPUTimer() :
+        m_current(0),
+        m_initialized(false),
+        m_running(false) {
+            std::fill(std::begin(m_queryIds), std::end(m_queryIds), 0);
+            std::fill(std::begin(m_frameNumbers), std::end(m_frameNumbers), 0);
+            std::fill(std::begin(m_pending), std::end(m_pending), false);
+        }
+
+        void RenderProfiler::GPUTimer::begin(RenderProfiler& profiler) {
+            assert(!m_running);
+            if (!glGenQueries.bound())
+                return;
+
+            if (!m_initialized) {
+                glAssert(glGenQueries(static_cast<GLsizei>(QueryCount), m_queryIds));
+                m_initialized = true;
+            }
+
+            collect(profiler);
+            if (!m_pending[m_current]) {
+                glAssert(glBeginQuery(GL_TIME_ELAPSED, m_queryIds[m_current]));
+                m_frameNumbers[m_current] = profiler.nextFrameNumber();
+                m_running = true;
+            }
+        }
+
+        void RenderProfiler::GPUTimer::end(RenderProfiler& profiler) {
+            if (m_running) {
+                glAssert(glEndQuery(GL_TIME_ELAPSED));
+                m_pending[m_current] = true;
+                m_current = (m_current + 1) % QueryCount;
+                m_running = false;
+            }
+        }
+
+        void RenderProfiler::GPUTimer::collect(RenderProfiler& profiler) {
+            for (size_t i = 0; i < QueryCount; ++i) {
+                if (m_pending[i]) {
+                    GLuint available = 0;
+                    glAssert(glGetQueryObjectuiv(m_queryIds[i], GL_QUERY_RESULT_AVAILABLE, &available));
+                    if (available != 0) {
+                        GLuint nanoseconds = 0;
+                        glAssert(glGetQueryObjectuiv(m_queryIds[i], GL_QUERY_RESULT, &nanoseconds));
+                        profiler.setGPUTime(m_frameNumbers[i], static_cast<double>(nanoseconds) / 1000000.0);
+                        m_pending[i] = false;
+                    }
+                }
+            }
+        }
+
+        RenderProfiler& RenderProfiler::instance() {
+            static RenderProfiler profiler;
+            return profiler;
+        }
+
+        RenderProfiler::RenderProfiler() :
+        m_enabled(false),
+        m_frames(Capacity),
+        m_frameCount(0),
+        m_inFrame(false) {}
+
+        bool RenderProfiler::enabled() const {
+            return m_enabled;
+        }
+
+        void RenderProfiler::setEnabled(const bool enabled) {
+            if (enabled == m_enabled)
+                return;
+            m_enabled = enabled;
+            m_current = Frame();
+            m_inFrame = false;
+        }
+
+        void RenderProfiler::clear() {
+            m_frameCount = 0;
+            m_current = Frame();
+        }
+
+        void RenderProfiler::beginFrame(GPUTimer& gpuTimer) {
+            if (!m_enabled)
+                return;
+
+            m_inFrame = true;
+            m_frameStart = Clock::now();
+            gpuTimer.begin(*this);
+        }
+
+        void RenderProfiler::endFrame(GPUTimer& gpuTimer) {
+            gpuTimer.end(*this);
+            if (!m_inFrame)
+                return;
+
+            const std::chrono::duration<double, std::milli> duration = Clock::now() - m_frameStart;
+            m_current.cpuMs = duration.count();
+
+            m_frames[m_frameCount % Capacity] = m_current;
+            ++m_frameCount;
+
+            m_current = Frame();
+            m_inFrame = false;
+        }
+
+        void RenderProfiler::addTime(const Section section, const double ms) {
+            assert(section < Section_Count);
+            if (m_enabled)
+                m_current.sectionMs[section] += ms;
+        }
+
+        size_t RenderProfiler::frameCount() const {
+            return std::min(m_frameCount, Capacity);
+        }
+
+        const RenderProfiler::Frame& RenderProfiler::frame(const size_t index) const {
+            assert(index < frameCount());
+            return m_frames[(m_frameCount - frameCount() + index) % Capacity];
+        }
+
+        String RenderProfiler::summary() const {
+            const size_t count = frameCount();
+            if (count == 0)
+                return "No frames recorded";
+
+            Frame average;
+            double gpuMs = 0.0;
+            size_t gpuCount = 0;
+            for (size_t i = 0; i < count; ++i) {
+                const Frame& current = frame(i);
+                average.cpuMs += current.cpuMs;
+                if (current.gpuMs >= 0.0) {
+                    gpuMs += current.gpuMs;
+                    ++gpuCount;
+                }
+                for (size_t j = 0; j < Section_Count; ++j)
+                    average.sectionMs[j] += current.sectionMs[j];
+                average.drawCalls += current.drawCalls;
+                average.textureBinds += current.textureBinds;
+                average.uploadedBytes += current.uploadedBytes;
+            }
+
+            const double n = static_cast<double>(count);
+            StringStream str;
+            str << std::fixed << std::setprecision(2);
+            str << "Average of " << count << " frames" << std::endl;
+            str << "Frame: " << average.cpuMs / n << " ms CPU, ";
+            if (gpuCount > 0)
+                str << gpuMs / static_cast<double>(gpuCount) << " ms GPU" << std::endl;
+            else
+                str << "GPU n/a" << std::endl;
+            for (size_t i = 0; i < Section_Count; ++i)
+                str << SectionLabels[i] << ": " << average.sectionMs[i] / n << " ms" << std::endl;
+            str << "Draw calls: " << static_cast<double>(average.drawCalls) / n;
+            str << ", texture binds: " << static_cast<double>(average.textureBinds) / n;
+            str << ", uploaded: " << static_cast<double>(average.uploadedBytes) / n / 1024.0 << " KiB";
+            return str.str();
+        }
+
+        void RenderProfiler::writeCSV(std::ostream& stream) const {
+            stream << "frame,cpu_ms,gpu_ms";
+            for (size_t i = 0; i < Section_Count; ++i)
+                stream << "," << SectionColumns[i];
+            stream << ",draw_calls,texture_binds,uploaded_bytes" << std::endl;
+
+            const size_t count = frameCount();
+            const size_t first = m_frameCount - count;
+            for (size_t i = 0; i < count; ++i) {
+                const Frame& current = frame(i);
+                stream << first + i << "," << current.cpuMs << ",";
+                if (current.gpuMs >= 0.0)
+                    stream << current.gpuMs;
+                for (size_t j = 0; j < Section_Count; ++j)
+                    stream << "," << current.sectionMs[j];
+                stream << "," << current.drawCalls << "," << current.textureBinds << "," << current.uploadedBytes << std::endl;
+            }
+        }
+
+        size_t RenderProfiler::nextFrameNumber() const {
+            return m_frameCount;
+        }
+
+        void RenderProfiler::setGPUTime(const size_t frameNumber, const double ms) {
+            if (frameNumber < m_frameCount && frameNumber + frameCount() >= m_frameCount)
+                m_frames[frameNumber % Capacity].gpuMs = ms;
+        }
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_RenderProfiler
+#define TrenchBroom_RenderProfiler
+
+#include "StringUtils.h"
+#include "Renderer/GL.h"
+
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Records timings and counters for the most recently rendered frames in a ring buffer. The profiler is
+         * disabled by default, and all recording functions return immediately while it is disabled.
+         *
+         * The sections are timed independently of each other and may be nested, e.g. the text renderer is timed
+         * while the render batch is rendered. Work that is done between two frames, such as picking, is attributed
+         * to the following frame.
+         */
+        class RenderProfiler {
+        public:
+            typedef enum {
+                Section_RenderBatch = 0,
+                Section_CommitPendingChanges = 1,
+                Section_ValidateBrushes = 2,
+                Section_RenderEntities = 3,
+                Section_RenderText = 4,
+                Section_Pick = 5,
+                Section_Count = 6
+            } Section;
+
+            struct Frame {
+                double cpuMs;
+                double gpuMs; // negative if no timer query result is available
+                double sectionMs[Section_Count];
+                size_t drawCalls;
+                size_t textureBinds;
+                size_t uploadedBytes;
+
+                Frame();
+            };
+
+            /**
+             * Adds the time spent between its construction and destruction to the given section.
+             */
+            class TimeSection {
+            private:
+                Section m_section;
+                bool m_enabled;
+                std::chrono::steady_clock::time_point m_start;
+            public:
+                TimeSection(Section section);
+                ~TimeSection();
+            private:
+                TimeSection(const TimeSection& other);
+                TimeSection& operator=(const TimeSection& other);
+            };
+
+            /**
+             * Measures the GPU time of frames using timer queries. Query objects are not shared between OpenGL
+             * contexts, so every view that renders frames needs its own timer. Results are read back one frame
+             * later to avoid stalling the pipeline. If the context does not support timer queries, the timer does
+             * nothing.
+             *
+             * The query objects are not deleted explicitly because the context is not necessarily current when the
+             * timer is destroyed. They are released together with the context.
+             */
+            class GPUTimer {
+            private:
+                static const size_t QueryCount = 2;
+                GLuint m_queryIds[QueryCount];
+                size_t m_frameNumbers[QueryCount];
+                bool m_pending[QueryCount];
+                size_t m_current;
+                bool m_initialized;
+                bool m_running;
+            public:
+                GPUTimer();
+
+                void begin(RenderProfiler& profiler);
+                void end(RenderProfiler& profiler);
+            private:
+                void collect(RenderProfiler& profiler);
+
+                GPUTimer(const GPUTimer& other);
+                GPUTimer& operator=(const GPUTimer& other);
+            };
+
+            static const size_t Capacity = 240;
+        private:
+            typedef std::chrono::steady_clock Clock;
+            typedef std::vector<Frame> FrameList;
+
+            bool m_enabled;
+            FrameList m_frames;
+            size_t m_frameCount;
+            Frame m_current;
+            bool m_inFrame;
+            Clock::time_point m_frameStart;
+        public:
+            static RenderProfiler& instance();
+
+            RenderProfiler();
+
+            bool enabled() const;
+            void setEnabled(bool enabled);
+            void clear();
+
+            void beginFrame(GPUTimer& gpuTimer);
+            void endFrame(GPUTimer& gpuTimer);
+
+            void addTime(Section section, double ms);
+            void countDrawCall() {
+                if (m_enabled)
+                    ++m_current.drawCalls;
+            }
+
+            void countTextureBind() {
+                if (m_enabled)
+                    ++m_current.textureBinds;
+            }
+
+            void countUpload(const size_t bytes) {
+                if (m_enabled)
+                    m_current.uploadedBytes += bytes;
+            }
+
+            /**
+             * Returns the number of recorded frames, which is at most Capacity.
+             */
+            size_t frameCount() const;
+
+            /**
+             * Returns the recorded frame with the given index, where the oldest frame has index 0.
+             */
+            const Frame& frame(size_t index) const;
+
+            /**
+             * Returns the average values of the recorded frames formatted for the on-screen overlay.
+             */
+            String summary() const;
+
+            /**
+             * Writes the recorded frames as comma separated values with a header line, oldest frame first.
+             */
+            void writeCSV(std::ostream& stream) const;
+        private:
+            size_t nextFrameNumber() const;
+            void setGPUTime(size_t frameNumber, double ms);
+        private:
+            RenderProfiler(const RenderProfiler& other);
+            RenderProfiler& operator=(const RenderProfiler& other);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_RenderProfiler) */
@@ -24,6 +24,7 @@
 #include "Renderer/Camera.h"
 #include "Renderer/FontManager.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderProfiler.h"
 #include "Renderer/RenderUtils.h"
 #include "Renderer/ShaderManager.h"
 #include "Renderer/Shaders.h"
@@ -38,14 +39,11 @@ namespace TrenchBroom {
         const size_t TextRenderer::RectCornerSegments = 3;
         const float TextRenderer::RectCornerRadius = 3.0f;
         
-        TextRenderer::Entry::Entry(Vec2f::List& i_vertices, const Vec2f& i_size, const Vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
-        size(i_size),
+        TextRenderer::Entry::Entry(TextureFont::LayoutPtr i_layout, const Vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor) :
+        layout(i_layout),
         offset(i_offset),
         textColor(i_textColor),
-        backgroundColor(i_backgroundColor) {
-            using std::swap;
-            swap(vertices, i_vertices);
-        }
+        backgroundColor(i_backgroundColor) {}
 
         TextRenderer::EntryCollection::EntryCollection() :
         textVertexCount(0),
@@ -66,47 +64,49 @@ namespace TrenchBroom {
         }
 
         void TextRenderer::renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, const bool onTop) {
+            RenderProfiler::TimeSection timeSection(RenderProfiler::Section_RenderText);
             
             const Camera& camera = renderContext.camera();
             const float distance = camera.perpendicularDistanceTo(position.position(camera));
             if (distance <= 0.0f)
                 return;
             
-            if (!isVisible(renderContext, string, position, distance, onTop))
+            // cull by distance and zoom before the string is laid out
+            if (!isInViewRange(renderContext, distance, onTop))
                 return;
             
             FontManager& fontManager = renderContext.fontManager();
             TextureFont& font = fontManager.font(m_fontDescriptor);
+            TextureFont::LayoutPtr layout = font.layout(string);
+
+            if (!isVisible(renderContext, layout->size, position))
+                return;
 
-            Vec2f::List vertices = font.quads(string, true);
             const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-            const Vec2f size = font.measure(string);
-            const Vec3f offset = position.offset(camera, size);
+            const Vec3f offset = position.offset(camera, layout->size);
             
+            addEntry(onTop ? m_entriesOnTop : m_entries, Entry(layout, offset,
+                                                               Color(textColor, alphaFactor * textColor.a()),
+                                                               Color(backgroundColor, alphaFactor * backgroundColor.a())));
+        }
+
+        bool TextRenderer::isInViewRange(RenderContext& renderContext, const float distance, const bool onTop) const {
             if (onTop)
-                addEntry(m_entriesOnTop, Entry(vertices, size, offset,
-                                               Color(textColor, alphaFactor * textColor.a()),
-                                               Color(backgroundColor, alphaFactor * backgroundColor.a())));
-            else
-                addEntry(m_entries, Entry(vertices, size, offset,
-                                          Color(textColor, alphaFactor * textColor.a()),
-                                          Color(backgroundColor, alphaFactor * backgroundColor.a())));
+                return true;
+            if (renderContext.render3D() && distance > m_maxViewDistance)
+                return false;
+            if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
+                return false;
+            return true;
         }
 
-        bool TextRenderer::isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, const float distance, const bool onTop) const {
-            if (!onTop) {
-                if (renderContext.render3D() && distance > m_maxViewDistance)
-                    return false;
-                if (renderContext.render2D() && renderContext.camera().zoom() < m_minZoomFactor)
-                    return false;
-            }
-            
+        bool TextRenderer::isVisible(RenderContext& renderContext, const Vec2f& size, const TextAnchor& position) const {
             const Camera& camera = renderContext.camera();
             const Camera::Viewport& viewport = camera.unzoomedViewport();
             
-            const Vec2f size = stringSize(renderContext, string);
-            const Vec2f offset = Vec2f(position.offset(camera, size)) - m_inset;
-            const Vec2f actualSize = size + 2.0f * m_inset;
+            const Vec2f roundedSize = size.rounded();
+            const Vec2f offset = Vec2f(position.offset(camera, roundedSize)) - m_inset;
+            const Vec2f actualSize = roundedSize + 2.0f * m_inset;
             
             return viewport.contains(offset.x(), offset.y(), actualSize.x(), actualSize.y());
         }
@@ -131,17 +131,12 @@ namespace TrenchBroom {
         
         void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry) {
             collection.entries.push_back(entry);
-            collection.textVertexCount += entry.vertices.size();
+            collection.textVertexCount += entry.layout->vertices.size() / 2;
             collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
         }
         
-        Vec2f TextRenderer::stringSize(RenderContext& renderContext, const AttrString& string) const {
-            FontManager& fontManager = renderContext.fontManager();
-            TextureFont& font = fontManager.font(m_fontDescriptor);
-            return font.measure(string).rounded();
-        }
-
         void TextRenderer::doPrepareVertices(Vbo& vertexVbo) {
+            RenderProfiler::TimeSection timeSection(RenderProfiler::Section_RenderText);
             prepare(m_entries, false, vertexVbo);
             prepare(m_entriesOnTop, true, vertexVbo);
         }
@@ -153,8 +148,17 @@ namespace TrenchBroom {
             RectVertex::List rectVertices;
             rectVertices.reserve(collection.rectVertexCount);
             
-            for (const Entry& entry : collection.entries)
-                addEntry(entry, onTop, textVertices, rectVertices);
+            // labels of the same string share their layout and thus their background shape
+            const TextureFont::Layout* lastLayout = nullptr;
+            Vec2f::List rect;
+            for (const Entry& entry : collection.entries) {
+                if (entry.layout.get() != lastLayout) {
+                    if (lastLayout == nullptr || entry.layout->size != lastLayout->size)
+                        rect = roundedRect2D(entry.layout->size + 2.0f * m_inset, RectCornerRadius, RectCornerSegments);
+                    lastLayout = entry.layout.get();
+                }
+                addEntry(entry, rect, textVertices, rectVertices);
+            }
             
             collection.textArray = VertexArray::swap(textVertices);
             collection.rectArray = VertexArray::swap(rectVertices);
@@ -163,9 +167,9 @@ namespace TrenchBroom {
             collection.rectArray.prepare(vbo);
         }
 
-        void TextRenderer::addEntry(const Entry& entry, const bool onTop, TextVertex::List& textVertices, RectVertex::List& rectVertices) {
-            const Vec2f::List& stringVertices = entry.vertices;
-            const Vec2f& stringSize = entry.size;
+        void TextRenderer::addEntry(const Entry& entry, const Vec2f::List& rect, TextVertex::List& textVertices, RectVertex::List& rectVertices) {
+            const Vec2f::List& stringVertices = entry.layout->vertices;
+            const Vec2f& stringSize = entry.layout->size;
             
             const Vec3f& offset = entry.offset;
             
@@ -178,7 +182,6 @@ namespace TrenchBroom {
                 textVertices.push_back(TextVertex(Vec3f(position2 + offset, -offset.z()), texCoords, textColor));
             }
 
-            const Vec2f::List rect = roundedRect2D(stringSize + 2.0f * m_inset, RectCornerRadius, RectCornerSegments);
             for (size_t i = 0; i < rect.size(); ++i) {
                 const Vec2f& vertex = rect[i];
                 rectVertices.push_back(RectVertex(Vec3f(vertex + offset + stringSize / 2.0f, -offset.z()), rectColor));
@@ -186,6 +189,7 @@ namespace TrenchBroom {
         }
 
         void TextRenderer::doRender(RenderContext& renderContext) {
+            RenderProfiler::TimeSection timeSection(RenderProfiler::Section_RenderText);
             const Camera::Viewport& viewport = renderContext.camera().unzoomedViewport();
             const Mat4x4f projection = orthoMatrix(0.0f, 1.0f,
                                                    static_cast<float>(viewport.x),
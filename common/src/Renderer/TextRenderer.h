@@ -24,6 +24,7 @@
 #include "Color.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/TextureFont.h"
 #include "Renderer/VertexArray.h"
 #include "Renderer/VertexSpec.h"
 
@@ -46,13 +47,12 @@ namespace TrenchBroom {
             static const float RectCornerRadius;
             
             struct Entry {
-                Vec2f::List vertices;
-                Vec2f size;
+                TextureFont::LayoutPtr layout;
                 Vec3f offset;
                 Color textColor;
                 Color backgroundColor;
 
-                Entry(Vec2f::List& i_vertices, const Vec2f& i_size, const Vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
+                Entry(TextureFont::LayoutPtr i_layout, const Vec3f& i_offset, const Color& i_textColor, const Color& i_backgroundColor);
             };
             
             typedef std::vector<Entry> EntryList;
@@ -86,16 +86,15 @@ namespace TrenchBroom {
         private:
             void renderString(RenderContext& renderContext, const Color& textColor, const Color& backgroundColor, const AttrString& string, const TextAnchor& position, bool onTop);
             
-            bool isVisible(RenderContext& renderContext, const AttrString& string, const TextAnchor& position, float distance, bool onTop) const;
+            bool isInViewRange(RenderContext& renderContext, float distance, bool onTop) const;
+            bool isVisible(RenderContext& renderContext, const Vec2f& size, const TextAnchor& position) const;
             float computeAlphaFactor(const RenderContext& renderContext, float distance, bool onTop) const;
             void addEntry(EntryCollection& collection, const Entry& entry);
-            
-            Vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
         private:
             void doPrepareVertices(Vbo& vertexVbo);
             void prepare(EntryCollection& collection, bool onTop, Vbo& vbo);
             
-            void addEntry(const Entry& entry, bool onTop, TextVertex::List& textVertices, RectVertex::List& rectVertices);
+            void addEntry(const Entry& entry, const Vec2f::List& rect, TextVertex::List& textVertices, RectVertex::List& rectVertices);
             
             void doRender(RenderContext& renderContext);
             void render(EntryCollection& collection, RenderContext& renderContext);
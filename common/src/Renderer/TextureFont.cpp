@@ -166,6 +166,26 @@ namespace TrenchBroom {
             return measureString.size();
         }
 
+        TextureFont::LayoutPtr TextureFont::layout(const AttrString& string) {
+            LayoutCache::iterator it = m_layoutCache.find(string);
+            if (it != std::end(m_layoutCache))
+                return it->second;
+
+            if (m_layoutCache.size() >= MaxCachedLayouts)
+                m_layoutCache.clear();
+
+            std::shared_ptr<Layout> layout(new Layout());
+            layout->vertices = quads(string, true);
+            layout->size = measure(string);
+
+            m_layoutCache.insert(std::make_pair(string, layout));
+            return layout;
+        }
+
+        size_t TextureFont::cachedLayoutCount() const {
+            return m_layoutCache.size();
+        }
+
         Vec2f::List TextureFont::quads(const String& string, const bool clockwise, const Vec2f& offset) {
             Vec2f::List result;
             result.reserve(string.length() * 4 * 2);
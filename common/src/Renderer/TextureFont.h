@@ -26,6 +26,8 @@
 #include "Renderer/FontGlyph.h"
 #include "Renderer/FontGlyphBuilder.h"
 
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -34,13 +36,28 @@ namespace TrenchBroom {
         
         class TextureFont {
         public:
+            /**
+             * The clockwise quads of a string laid out at the origin, given as alternating positions and texture
+             * coordinates, and the size of the string.
+             */
+            struct Layout {
+                Vec2f::List vertices;
+                Vec2f size;
+            };
+
+            typedef std::shared_ptr<const Layout> LayoutPtr;
         private:
+            typedef std::map<AttrString, LayoutPtr> LayoutCache;
+            static const size_t MaxCachedLayouts = 4096;
+
             FontTexture* m_texture;
             FontGlyph::List m_glyphs;
             size_t m_lineHeight;
             
             unsigned char m_firstChar;
             unsigned char m_charCount;
+
+            LayoutCache m_layoutCache;
         public:
             TextureFont(FontTexture* texture, const FontGlyph::List& glyphs, size_t lineHeight, unsigned char firstChar, unsigned char charCount);
             ~TextureFont();
@@ -48,6 +65,14 @@ namespace TrenchBroom {
             Vec2f::List quads(const AttrString& string, bool clockwise, const Vec2f& offset = Vec2f::Null);
             Vec2f measure(const AttrString& string);
 
+            /**
+             * Returns the layout of the given string. Layouts are cached per string, so that labels which are
+             * rendered every frame are only laid out once. Once the cache is full, it is cleared, which does not
+             * affect the layouts that are still referenced.
+             */
+            LayoutPtr layout(const AttrString& string);
+            size_t cachedLayoutCount() const;
+
             Vec2f::List quads(const String& string, bool clockwise, const Vec2f& offset = Vec2f::Null);
             Vec2f measure(const String& string);
             
@@ -84,6 +84,14 @@ namespace TrenchBroom {
             return current.add(primType, count);
         }
 
+        TexturedIndexArrayMap::TextureList TexturedIndexArrayMap::textures() const {
+            TextureList result;
+            result.reserve(m_ranges->size());
+            for (const auto& entry : *m_ranges)
+                result.push_back(entry.first);
+            return result;
+        }
+
         void TexturedIndexArrayMap::render(IndexArray& indexArray) {
             DefaultTextureRenderFunc func;
             render(indexArray, func);
@@ -100,6 +108,12 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexArrayMap::render(IndexArray& indexArray, const Texture* texture) {
+            const auto it = m_ranges->find(texture);
+            if (it != m_ranges->end())
+                it->second.render(indexArray);
+        }
+
         IndexArrayMap& TexturedIndexArrayMap::findCurrent(const Texture* texture) {
             if (!isCurrent(texture))
                 m_current = m_ranges->find(texture);
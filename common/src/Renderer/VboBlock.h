@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_VboBlock
 #define TrenchBroom_VboBlock
 
+#include "Renderer/RenderProfiler.h"
 #include "Renderer/Vbo.h"
 
 #include <cstring>
@@ -66,15 +67,21 @@ namespace TrenchBroom {
             
             template <typename T>
             size_t writeBuffer(const size_t address, const std::vector<T>& buffer) {
+                return writeBuffer(address, &(buffer[0]), buffer.size());
+            }
+            
+            template <typename T>
+            size_t writeBuffer(const size_t address, const T* elements, const size_t count) {
                 assert(mapped());
                 
-                const size_t size = buffer.size() * sizeof(T);
+                const size_t size = count * sizeof(T);
                 assert(address + size <= m_capacity);
                 
-                const GLvoid* ptr = static_cast<const GLvoid*>(&(buffer[0]));
+                const GLvoid* ptr = static_cast<const GLvoid*>(elements);
                 const GLintptr offset = static_cast<GLintptr>(m_offset + address);
                 const GLsizeiptr sizei = static_cast<GLsizeiptr>(size);
                 glAssert(glBufferSubData(m_vbo.type(), offset, sizei, ptr));
+                RenderProfiler::instance().countUpload(size);
                 
                 return size;
             }
@@ -19,6 +19,8 @@
 
 #include "VertexArray.h"
 
+#include "Renderer/RenderProfiler.h"
+
 #include <cassert>
 #include <limits>
 
@@ -67,6 +69,12 @@ namespace TrenchBroom {
                 m_holder->prepare(vbo);
             m_prepared = true;
         }
+        
+        void VertexArray::update(const size_t index, const size_t count) {
+            assert(prepared());
+            if (count > 0)
+                m_holder->update(index, count);
+        }
 
         bool VertexArray::setup() {
             if (empty())
@@ -97,10 +105,12 @@ namespace TrenchBroom {
             if (!m_setup) {
                 if (setup()) {
                     glAssert(glDrawArrays(primType, index, count));
+                    RenderProfiler::instance().countDrawCall();
                     cleanup();
                 }
             } else {
                 glAssert(glDrawArrays(primType, index, count));
+                RenderProfiler::instance().countDrawCall();
             }
         }
 
@@ -108,17 +118,12 @@ namespace TrenchBroom {
             assert(prepared());
             if (!m_setup) {
                 if (setup()) {
-                    const GLint* indexArray   = indices.data();
-                    const GLsizei* countArray = counts.data();
-                    glAssert(glMultiDrawArrays(primType, indexArray, countArray, primCount));
+                    drawArrays(primType, indices, counts, primCount);
                     cleanup();
                 }
             } else {
-                const GLint* indexArray   = indices.data();
-                const GLsizei* countArray = counts.data();
-                glAssert(glMultiDrawArrays(primType, indexArray, countArray, primCount));
+                drawArrays(primType, indices, counts, primCount);
             }
-            
         }
 
         void VertexArray::render(const PrimType primType, const GLIndices& indices, const GLsizei count) {
@@ -127,11 +132,33 @@ namespace TrenchBroom {
                 if (setup()) {
                     const GLint* indexArray = indices.data();
                     glAssert(glDrawElements(primType, count, GL_UNSIGNED_INT, indexArray));
+                    RenderProfiler::instance().countDrawCall();
                     cleanup();
                 }
             } else {
                 const GLint* indexArray = indices.data();
                 glAssert(glDrawElements(primType, count, GL_UNSIGNED_INT, indexArray));
+                RenderProfiler::instance().countDrawCall();
+            }
+        }
+
+        void VertexArray::drawArrays(const PrimType primType, const GLIndices& indices, const GLCounts& counts, const GLint primCount) {
+            assert(indices.size() >= static_cast<size_t>(primCount));
+            assert(counts.size() >= static_cast<size_t>(primCount));
+            
+            if (primCount == 1) {
+                glAssert(glDrawArrays(primType, indices.front(), counts.front()));
+                RenderProfiler::instance().countDrawCall();
+            } else if (primCount > 1) {
+                if (glMultiDrawArrays.bound()) {
+                    glAssert(glMultiDrawArrays(primType, indices.data(), counts.data(), primCount));
+                    RenderProfiler::instance().countDrawCall();
+                } else {
+                    for (GLint i = 0; i < primCount; ++i) {
+                        glAssert(glDrawArrays(primType, indices[static_cast<size_t>(i)], counts[static_cast<size_t>(i)]));
+                        RenderProfiler::instance().countDrawCall();
+                    }
+                }
             }
         }
 
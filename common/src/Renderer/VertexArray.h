@@ -41,6 +41,7 @@ namespace TrenchBroom {
                 virtual size_t sizeInBytes() const = 0;
                 
                 virtual void prepare(Vbo& vbo) = 0;
+                virtual void update(size_t index, size_t count) = 0;
                 virtual void setup() = 0;
                 virtual void cleanup() = 0;
             };
@@ -71,6 +72,18 @@ namespace TrenchBroom {
                     }
                 }
                 
+                virtual void update(const size_t index, const size_t count) {
+                    ensure(m_block != nullptr, "block is null");
+                    assert(index + count <= m_vertexCount);
+                    
+                    const VertexList& vertices = doGetVertices();
+                    assert(vertices.size() == m_vertexCount);
+                    
+                    ActivateVbo activate(m_block->vbo());
+                    MapVboBlock map(m_block);
+                    m_block->writeBuffer(VertexSpec::Size * index, &vertices[index], count);
+                }
+                
                 virtual void setup() {
                     ensure(m_block != nullptr, "block is null");
                     VertexSpec::setup(m_block->offset());
@@ -262,6 +275,13 @@ namespace TrenchBroom {
             bool prepared() const;
             void prepare(Vbo& vbo);
             
+            /**
+             * Writes the given range of vertices into the vertex buffer again. Only vertex arrays that refer to
+             * their vertices can be updated, since the other vertex arrays discard their vertices once they are
+             * prepared.
+             */
+            void update(size_t index, size_t count);
+            
             bool setup();
             void render(PrimType primType);
             void render(PrimType primType, GLint index, GLsizei count);
@@ -269,6 +289,12 @@ namespace TrenchBroom {
             void render(PrimType primType, const GLIndices& indices, GLsizei count);
             void cleanup();
         private:
+            /**
+             * Issues a single draw call for a single range and one multi draw call for several ranges. If the
+             * context does not provide glMultiDrawArrays, the ranges are drawn one by one.
+             */
+            static void drawArrays(PrimType primType, const GLIndices& indices, const GLCounts& counts, GLint primCount);
+            
             VertexArray(BaseHolder::Ptr holder);
         };
     }
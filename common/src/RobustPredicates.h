@@ -0,0 +1,190 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_RobustPredicates_h
+#define TrenchBroom_RobustPredicates_h
+
+#include "MathUtils.h"
+#include "Vec.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+/*
+ Filtered geometric predicates in the style of Shewchuk's adaptive predicates. Each predicate first evaluates the
+ plain floating point expression together with a bound on its rounding error. Only if the result is too close to a
+ decision boundary to be trusted, the expression is evaluated again using exact expansion arithmetic.
+
+ Note that these predicates decide exactly how a point relates to a plane *as given*, including the epsilon band
+ around it. They do not remove the epsilon, which the geometry code relies on to merge nearly coplanar points.
+ */
+namespace Math {
+    namespace Robust {
+        /**
+         * An exact sum of up to MaxSize doubles, represented as a nonoverlapping expansion ordered by increasing
+         * magnitude. The sign of the sum is the sign of the largest nonzero component.
+         */
+        template <size_t MaxSize>
+        class Expansion {
+        private:
+            double m_components[MaxSize];
+            size_t m_size;
+        public:
+            Expansion() :
+            m_size(0) {}
+
+            // Grow-Expansion, see Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates"
+            void add(const double b) {
+                assert(m_size < MaxSize);
+                double q = b;
+                for (size_t i = 0; i < m_size; ++i) {
+                    const double e = m_components[i];
+                    const double sum = q + e;
+                    const double bVirtual = sum - q;
+                    const double aVirtual = sum - bVirtual;
+                    const double error = (q - aVirtual) + (e - bVirtual);
+                    m_components[i] = error;
+                    q = sum;
+                }
+                m_components[m_size++] = q;
+            }
+
+            // Adds the exact product a * b, using a fused multiply add to obtain the rounding error of the product.
+            void addProduct(const double a, const double b) {
+                const double product = a * b;
+                const double error = std::fma(a, b, -product);
+                add(error);
+                add(product);
+            }
+
+            int sign() const {
+                for (size_t i = m_size; i > 0; --i) {
+                    if (m_components[i - 1] > 0.0)
+                        return 1;
+                    if (m_components[i - 1] < 0.0)
+                        return -1;
+                }
+                return 0;
+            }
+        };
+
+        /**
+         * Determines the status of the given point relative to the plane with the given normal and distance. The
+         * point is considered inside the plane if its distance to the plane is within [-epsilon, epsilon].
+         */
+        template <typename T, size_t S>
+        PointStatus::Type pointStatus(const Vec<T,S>& normal, const T distance, const Vec<T,S>& point, const T epsilon) {
+            const T dist = point.dot(normal) - distance;
+            if (dist >  epsilon)
+                return PointStatus::PSAbove;
+            if (dist < -epsilon)
+                return PointStatus::PSBelow;
+            return PointStatus::PSInside;
+        }
+
+        inline PointStatus::Type pointStatus(const Vec<double,3>& normal, const double distance, const Vec<double,3>& point, const double epsilon) {
+            const double xx = point[0] * normal[0];
+            const double yy = point[1] * normal[1];
+            const double zz = point[2] * normal[2];
+            const double dist = ((xx + yy) + zz) - distance;
+
+            // Each of the four roundings in computing dist contributes at most one unit roundoff relative to the
+            // magnitude of the summands, so this bound is generous.
+            const double magnitude = std::abs(xx) + std::abs(yy) + std::abs(zz) + std::abs(distance);
+            const double errorBound = 4.0 * std::numeric_limits<double>::epsilon() * magnitude;
+
+            if (dist - epsilon > errorBound)
+                return PointStatus::PSAbove;
+            if (dist + epsilon < -errorBound)
+                return PointStatus::PSBelow;
+            if (std::abs(dist) < epsilon - errorBound)
+                return PointStatus::PSInside;
+
+            // The fast filter failed, fall back to exact arithmetic.
+            Expansion<8> exact;
+            exact.addProduct(point[0], normal[0]);
+            exact.addProduct(point[1], normal[1]);
+            exact.addProduct(point[2], normal[2]);
+            exact.add(-distance);
+
+            Expansion<8> above = exact;
+            above.add(-epsilon);
+            if (above.sign() > 0)
+                return PointStatus::PSAbove;
+
+            Expansion<8> below = exact;
+            below.add(epsilon);
+            if (below.sign() < 0)
+                return PointStatus::PSBelow;
+            return PointStatus::PSInside;
+        }
+
+        /**
+         * Determines the status of the given point relative to the plane with the given normal that contains the
+         * given anchor point.
+         */
+        template <typename T, size_t S>
+        PointStatus::Type pointStatus(const Vec<T,S>& normal, const Vec<T,S>& anchor, const Vec<T,S>& point, const T epsilon) {
+            const T dist = (point - anchor).dot(normal);
+            if (dist >  epsilon)
+                return PointStatus::PSAbove;
+            if (dist < -epsilon)
+                return PointStatus::PSBelow;
+            return PointStatus::PSInside;
+        }
+
+        inline PointStatus::Type pointStatus(const Vec<double,3>& normal, const Vec<double,3>& anchor, const Vec<double,3>& point, const double epsilon) {
+            const double xx = (point[0] - anchor[0]) * normal[0];
+            const double yy = (point[1] - anchor[1]) * normal[1];
+            const double zz = (point[2] - anchor[2]) * normal[2];
+            const double dist = (xx + yy) + zz;
+
+            // Every term is subject to one rounding for the difference, one for the product and two for the sums.
+            const double magnitude = std::abs(xx) + std::abs(yy) + std::abs(zz);
+            const double errorBound = 4.0 * std::numeric_limits<double>::epsilon() * magnitude;
+
+            if (dist - epsilon > errorBound)
+                return PointStatus::PSAbove;
+            if (dist + epsilon < -errorBound)
+                return PointStatus::PSBelow;
+            if (std::abs(dist) < epsilon - errorBound)
+                return PointStatus::PSInside;
+
+            Expansion<16> exact;
+            for (size_t i = 0; i < 3; ++i) {
+                exact.addProduct( point[i], normal[i]);
+                exact.addProduct(-anchor[i], normal[i]);
+            }
+
+            Expansion<16> above = exact;
+            above.add(-epsilon);
+            if (above.sign() > 0)
+                return PointStatus::PSAbove;
+
+            Expansion<16> below = exact;
+            below.add(epsilon);
+            if (below.sign() < 0)
+                return PointStatus::PSBelow;
+            return PointStatus::PSInside;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Trace.h"
+
+#include <cassert>
+#include <ostream>
+
+namespace TrenchBroom {
+    Tracer::Chunk::Chunk() :
+    count(0),
+    next(nullptr) {}
+
+    Tracer::ThreadBuffer::ThreadBuffer(const size_t i_threadId) :
+    threadId(i_threadId),
+    head(new Chunk()),
+    tail(head),
+    chunkCount(1) {}
+
+    Tracer::ThreadBuffer::~ThreadBuffer() {
+        Chunk* chunk = head;
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+    }
+
+    Tracer& Tracer::instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    static size_t nextTracerId() {
+        static std::atomic<size_t> id(0);
+        return ++id;
+    }
+
+    Tracer::Tracer() :
+    m_id(nextTracerId()),
+    m_enabled(false),
+    m_epoch(Clock::now()) {}
+
+    Tracer::~Tracer() {
+        for (ThreadBuffer* buffer : m_buffers)
+            delete buffer;
+    }
+
+    void Tracer::setEnabled(const bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    Tracer::Timestamp Tracer::now() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_epoch).count();
+    }
+
+    void Tracer::record(const char* name, const String& detail, const Timestamp start, const Timestamp end) {
+        assert(name != nullptr);
+
+        ThreadBuffer& buffer = threadBuffer();
+        Chunk* chunk = buffer.tail;
+        size_t count = chunk->count.load(std::memory_order_relaxed);
+        if (count == Chunk::Size) {
+            if (buffer.chunkCount == MaxChunksPerThread)
+                return;
+
+            Chunk* next = new Chunk();
+            chunk->next.store(next, std::memory_order_release);
+            buffer.tail = chunk = next;
+            ++buffer.chunkCount;
+            count = 0;
+        }
+
+        Event& event = chunk->events[count];
+        event.name = name;
+        event.detail = detail;
+        event.start = start;
+        event.duration = end - start;
+
+        // publish the event to writeJSON
+        chunk->count.store(count + 1, std::memory_order_release);
+    }
+
+    size_t Tracer::eventCount() const {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+
+        size_t result = 0;
+        for (const ThreadBuffer* buffer : m_buffers) {
+            for (const Chunk* chunk = buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire))
+                result += chunk->count.load(std::memory_order_acquire);
+        }
+        return result;
+    }
+
+    void Tracer::writeJSON(std::ostream& stream) const {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+
+        stream << "{\"traceEvents\":[";
+        bool first = true;
+        for (const ThreadBuffer* buffer : m_buffers) {
+            for (const Chunk* chunk = buffer->head; chunk != nullptr; chunk = chunk->next.load(std::memory_order_acquire)) {
+                const size_t count = chunk->count.load(std::memory_order_acquire);
+                for (size_t i = 0; i < count; ++i) {
+                    const Event& event = chunk->events[i];
+                    if (!first)
+                        stream << ",";
+                    first = false;
+
+                    stream << "\n{\"name\":";
+                    writeString(stream, event.name);
+                    stream << ",\"cat\":\"TrenchBroom\",\"ph\":\"X\"";
+                    stream << ",\"ts\":" << event.start << ",\"dur\":" << event.duration;
+                    stream << ",\"pid\":1,\"tid\":" << buffer->threadId;
+                    if (!event.detail.empty()) {
+                        stream << ",\"args\":{\"detail\":";
+                        writeString(stream, event.detail);
+                        stream << "}";
+                    }
+                    stream << "}";
+                }
+            }
+        }
+        stream << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+    }
+
+    Tracer::ThreadBuffer& Tracer::threadBuffer() {
+        // Caches the buffer of the calling thread. The id distinguishes the global tracer from the ones created in
+        // tests.
+        static thread_local size_t cachedTracerId = 0;
+        static thread_local ThreadBuffer* cachedBuffer = nullptr;
+
+        if (cachedTracerId != m_id) {
+            std::lock_guard<std::mutex> lock(m_buffersMutex);
+            cachedBuffer = new ThreadBuffer(m_buffers.size() + 1);
+            cachedTracerId = m_id;
+            m_buffers.push_back(cachedBuffer);
+        }
+        return *cachedBuffer;
+    }
+
+    void Tracer::writeString(std::ostream& stream, const String& str) {
+        static const char* HexDigits = "0123456789abcdef";
+
+        stream << "\"";
+        for (const char c : str) {
+            switch (c) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+                case '\\':
+                    stream << "\\\\";
+                    break;
+                case '\n':
+                    stream << "\\n";
+                    break;
+                case '\r':
+                    stream << "\\r";
+                    break;
+                case '\t':
+                    stream << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20)
+                        stream << "\\u00" << HexDigits[(c >> 4) & 0xF] << HexDigits[c & 0xF];
+                    else
+                        stream << c;
+                    break;
+            }
+        }
+        stream << "\"";
+    }
+
+    TraceSpan::TraceSpan(const char* name) :
+    m_name(name),
+    m_enabled(Tracer::instance().enabled()),
+    m_start(m_enabled ? Tracer::instance().now() : 0) {}
+
+    TraceSpan::TraceSpan(const char* name, const String& detail) :
+    m_name(name),
+    m_enabled(Tracer::instance().enabled()),
+    m_start(0) {
+        if (m_enabled) {
+            m_detail = detail;
+            m_start = Tracer::instance().now();
+        }
+    }
+
+    TraceSpan::~TraceSpan() {
+        if (m_enabled) {
+            Tracer& tracer = Tracer::instance();
+            tracer.record(m_name, m_detail, m_start, tracer.now());
+        }
+    }
+}
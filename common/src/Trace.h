@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_Trace_h
+#define TrenchBroom_Trace_h
+
+#include "StringUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <vector>
+
+namespace TrenchBroom {
+    /**
+     * Records spans of time on any thread and writes them as JSON in the Chrome trace event format, which can be
+     * loaded by chrome://tracing or similar tools. The tracer is disabled by default, in which case creating a
+     * span costs a single atomic load.
+     *
+     * Every thread records its spans into its own buffer, so recording a span never takes a lock. A buffer is
+     * made up of fixed size chunks which are never moved or freed while the tracer exists, and the number of
+     * events in a chunk is published atomically, so the trace can be written while other threads are still
+     * recording.
+     */
+    class Tracer {
+    public:
+        typedef int64_t Timestamp;
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Event {
+            const char* name;
+            String detail;
+            Timestamp start;
+            Timestamp duration;
+        };
+
+        struct Chunk {
+            static const size_t Size = 1024;
+            Event events[Size];
+            std::atomic<size_t> count;
+            std::atomic<Chunk*> next;
+
+            Chunk();
+        };
+
+        struct ThreadBuffer {
+            size_t threadId;
+            Chunk* head;
+            Chunk* tail;
+            size_t chunkCount;
+
+            ThreadBuffer(size_t i_threadId);
+            ~ThreadBuffer();
+        };
+
+        typedef std::vector<ThreadBuffer*> ThreadBufferList;
+
+        // Limits the number of events recorded per thread to roughly one million.
+        static const size_t MaxChunksPerThread = 1024;
+
+        size_t m_id;
+        std::atomic<bool> m_enabled;
+        Clock::time_point m_epoch;
+
+        mutable std::mutex m_buffersMutex;
+        ThreadBufferList m_buffers;
+    public:
+        static Tracer& instance();
+
+        Tracer();
+        ~Tracer();
+
+        bool enabled() const {
+            return m_enabled.load(std::memory_order_relaxed);
+        }
+
+        void setEnabled(bool enabled);
+
+        /**
+         * Returns the number of microseconds since this tracer was created.
+         */
+        Timestamp now() const;
+
+        /**
+         * Records a span on the calling thread. The given name must outlive the tracer, e.g. be a string literal.
+         * The detail is shown as an argument of the span and may be empty.
+         */
+        void record(const char* name, const String& detail, Timestamp start, Timestamp end);
+
+        /**
+         * Returns the number of events recorded so far.
+         */
+        size_t eventCount() const;
+
+        void writeJSON(std::ostream& stream) const;
+    private:
+        ThreadBuffer& threadBuffer();
+        static void writeString(std::ostream& stream, const String& str);
+    private:
+        Tracer(const Tracer& other);
+        Tracer& operator=(const Tracer& other);
+    };
+
+    /**
+     * Records the time between its construction and destruction as a span of the global tracer. The given name
+     * must be a string literal.
+     */
+    class TraceSpan {
+    private:
+        const char* m_name;
+        String m_detail;
+        bool m_enabled;
+        Tracer::Timestamp m_start;
+    public:
+        explicit TraceSpan(const char* name);
+        TraceSpan(const char* name, const String& detail);
+        ~TraceSpan();
+    private:
+        TraceSpan(const TraceSpan& other);
+        TraceSpan& operator=(const TraceSpan& other);
+    };
+}
+
+#endif
@@ -24,7 +24,10 @@
 
 #include "GLInit.h"
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "RecoverableExceptions.h"
+#include "Trace.h"
 #include "TrenchBroomAppTraits.h"
 #include "TrenchBroomStackWalker.h"
 #include "IO/Path.h"
@@ -310,8 +313,36 @@ namespace TrenchBroom {
             SetVendorDisplayName("Kristian Duske");
             SetVendorName("Kristian Duske");
 
+            m_tracePath = tracePath();
+            if (!m_tracePath.isEmpty())
+                Tracer::instance().setEnabled(true);
+
             return true;
         }
+
+        // Tracing is enabled by setting TB_TRACE_FILE to the path of the file to write the trace to, or by the
+        // tracing preference, in which case the trace is written to the user data directory.
+        IO::Path TrenchBroomApp::tracePath() {
+            wxString value;
+            if (wxGetEnv("TB_TRACE_FILE", &value) && !value.IsEmpty())
+                return IO::Path(value.ToStdString());
+
+            PreferenceManager& prefs = PreferenceManager::instance();
+            if (prefs.get(Preferences::EnableTracing))
+                return IO::SystemPaths::userDataDirectory() + IO::Path("trace.json");
+            return IO::Path();
+        }
+
+        void TrenchBroomApp::writeTrace() const {
+            if (m_tracePath.isEmpty())
+                return;
+
+            std::ofstream stream(m_tracePath.asString().c_str());
+            if (stream.is_open())
+                Tracer::instance().writeJSON(stream);
+            else
+                wxLogWarning("Could not write trace to %s", m_tracePath.asString());
+        }
         
         static String makeCrashReport(const String &stacktrace, const String &reason) {
             StringStream ss;
@@ -474,6 +505,7 @@ namespace TrenchBroom {
 
         int TrenchBroomApp::OnRun() {
             const int result = wxApp::OnRun();
+            writeTrace();
             wxConfigBase* config = wxConfig::Get(false);
             if (config != nullptr)
                 config->Flush();
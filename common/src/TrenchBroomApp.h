@@ -42,6 +42,7 @@ namespace TrenchBroom {
             FrameManager* m_frameManager;
             RecentDocuments<TrenchBroomApp>* m_recentDocuments;
             wxLongLong m_lastActivation;
+            IO::Path m_tracePath;
         public:
             Notifier0 recentDocumentsDidChangeNotifier;
         public:
@@ -68,6 +69,10 @@ namespace TrenchBroom {
             void openAbout();
 
             bool OnInit();
+        private:
+            static IO::Path tracePath();
+            void writeTrace() const;
+        public:
             
             bool OnExceptionInMainLoop();
             void OnUnhandledException();
@@ -270,6 +270,9 @@ namespace TrenchBroom {
             viewMenu->addModifiableCheckItem(CommandIds::Menu::ViewToggleInspector, "Toggle Inspector", KeyboardShortcut('5', WXK_CONTROL));
             viewMenu->addSeparator();
             viewMenu->addModifiableCheckItem(CommandIds::Menu::ViewToggleMaximizeCurrentView, "Maximize Current View", KeyboardShortcut(WXK_SPACE, WXK_CONTROL));
+            viewMenu->addSeparator();
+            viewMenu->addModifiableCheckItem(CommandIds::Menu::ViewToggleRenderProfiler, "Show Render Profiler");
+            viewMenu->addModifiableActionItem(CommandIds::Menu::ViewSaveRenderProfile, "Save Render Profile...");
             
             Menu* runMenu = m_menuBar->addMenu("Run");
             runMenu->addModifiableActionItem(CommandIds::Menu::RunCompile, "Compile...");
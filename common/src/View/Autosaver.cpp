@@ -21,6 +21,7 @@
 
 #include "StringUtils.h"
 #include "SetAny.h"
+#include "Trace.h"
 #include "IO/DiskFileSystem.h"
 #include "View/MapDocument.h"
 
@@ -69,6 +70,7 @@ namespace TrenchBroom {
         }
         
         void Autosaver::autosave(MapDocumentSPtr document) {
+            const TraceSpan span("Autosaver::autosave");
             const IO::Path& mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
             
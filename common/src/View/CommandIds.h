@@ -67,6 +67,8 @@ namespace TrenchBroom {
                 const int ViewToggleMaximizeCurrentView      = Lowest +  89;
                 const int ViewToggleInfoPanel                = Lowest +  90;
                 const int ViewToggleInspector                = Lowest +  91;
+                const int ViewToggleRenderProfiler           = Lowest +  92;
+                const int ViewSaveRenderProfile              = Lowest +  93;
                 
                 const int FileOpenRecent                     = Lowest +  96;
                 const int FileExportObj                      = Lowest +  97;
@@ -21,6 +21,7 @@
 
 #include "Exceptions.h"
 #include "SetAny.h"
+#include "Trace.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <wx/time.h>
@@ -247,6 +248,7 @@ namespace TrenchBroom {
         }
         
         bool CommandProcessor::doCommand(Command::Ptr command) {
+            const TraceSpan span("CommandProcessor::doCommand", command->name());
             try {
                 commandDoNotifier(command);
                 if (command->performDo(m_document)) {
@@ -261,6 +263,7 @@ namespace TrenchBroom {
         }
         
         bool CommandProcessor::undoCommand(UndoableCommand::Ptr command) {
+            const TraceSpan span("CommandProcessor::undoCommand", command->name());
             try {
                 commandUndoNotifier(command);
                 if (command->performUndo(m_document)) {
@@ -49,8 +49,10 @@ namespace TrenchBroom {
                 const BBox3& worldBounds = document->worldBounds();
                 m_previouslySelectedNodes = document->selectedNodes().nodes();
                 
-                for (const Model::Node* original : m_previouslySelectedNodes) {
-                    Model::Node* clone = original->cloneRecursively(worldBounds);
+                const Model::NodeList clones = Model::Node::cloneRecursively(worldBounds, m_previouslySelectedNodes);
+                for (size_t i = 0; i < m_previouslySelectedNodes.size(); ++i) {
+                    const Model::Node* original = m_previouslySelectedNodes[i];
+                    Model::Node* clone = clones[i];
                     
                     Model::Node* parent = original->parent();
                     if (cloneParent(parent)) {
@@ -0,0 +1,368 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HandleIndex_h
+#define HandleIndex_h
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        inline BBox3 handleBounds(const Vec3& handle) {
+            return BBox3(handle, handle);
+        }
+
+        inline BBox3 handleBounds(const Edge3& handle) {
+            return BBox3(handle.start(), handle.start()).mergeWith(handle.end());
+        }
+
+        inline BBox3 handleBounds(const Polygon3& handle) {
+            return BBox3(handle.vertices());
+        }
+
+        /**
+         * A uniform grid over the bounds of vertex, edge and face handles. Every handle is stored in the cell which
+         * contains the center of its bounds, and every cell keeps the union of the bounds of its handles, so a query
+         * only has to look at the handles of the cells whose bounds it touches. Handles that are larger than a cell
+         * are kept in a separate list instead, so that the bounds of a cell never reach further than half the cell
+         * size beyond the cell.
+         */
+        template <typename H>
+        class HandleIndex {
+        public:
+            typedef std::vector<H> HandleList;
+        private:
+            struct Cell {
+                // contains the bounds of all handles, but may be larger after handles were removed
+                mutable BBox3 bounds;
+                mutable bool boundsValid;
+                HandleList handles;
+
+                Cell() : boundsValid(true) {}
+            };
+
+            typedef std::map<Vec3i, Cell> CellMap;
+
+            FloatType m_cellSize;
+            CellMap m_cells;
+            HandleList m_largeHandles;
+            size_t m_size;
+
+            // the range of cell keys that contains all cells, may be larger after cells were removed
+            Vec3i m_minKey;
+            Vec3i m_maxKey;
+        public:
+            explicit HandleIndex(const FloatType cellSize = 256.0) :
+            m_cellSize(cellSize),
+            m_size(0) {
+                assert(m_cellSize > 0.0);
+            }
+
+            size_t size() const {
+                return m_size;
+            }
+
+            bool empty() const {
+                return m_size == 0;
+            }
+
+            void insert(const H& handle) {
+                const BBox3 bounds = handleBounds(handle);
+                ++m_size;
+
+                if (isLarge(bounds)) {
+                    m_largeHandles.push_back(handle);
+                    return;
+                }
+
+                const Vec3i key = cellKey(bounds);
+                if (m_cells.empty()) {
+                    m_minKey = m_maxKey = key;
+                } else {
+                    for (size_t i = 0; i < 3; ++i) {
+                        m_minKey[i] = std::min(m_minKey[i], key[i]);
+                        m_maxKey[i] = std::max(m_maxKey[i], key[i]);
+                    }
+                }
+
+                Cell& cell = m_cells[key];
+                if (cell.handles.empty())
+                    cell.bounds = bounds;
+                else
+                    cell.bounds.mergeWith(bounds);
+                cell.handles.push_back(handle);
+            }
+
+            /**
+             * Removes the given handle, which must compare exactly equal to the handle that was inserted. The bounds
+             * of its cell are only recomputed when the cell is queried next.
+             */
+            bool remove(const H& handle) {
+                const BBox3 bounds = handleBounds(handle);
+                if (isLarge(bounds)) {
+                    if (!removeHandle(m_largeHandles, handle))
+                        return false;
+                    --m_size;
+                    return true;
+                }
+
+                const auto cellIt = m_cells.find(cellKey(bounds));
+                if (cellIt == std::end(m_cells))
+                    return false;
+
+                Cell& cell = cellIt->second;
+                if (!removeHandle(cell.handles, handle))
+                    return false;
+                --m_size;
+
+                if (cell.handles.empty())
+                    m_cells.erase(cellIt);
+                else
+                    cell.boundsValid = false;
+                return true;
+            }
+
+            void clear() {
+                m_cells.clear();
+                m_largeHandles.clear();
+                m_size = 0;
+            }
+
+            /**
+             * Passes every handle whose bounds intersect the given bounds to the given output iterator.
+             */
+            template <typename O>
+            void findHandles(const BBox3& bounds, O out) const {
+                for (const auto& entry : m_cells) {
+                    const Cell& cell = entry.second;
+                    if (cellBounds(cell).intersects(bounds)) {
+                        for (const H& handle : cell.handles) {
+                            if (handleBounds(handle).intersects(bounds))
+                                out = handle;
+                        }
+                    }
+                }
+
+                for (const H& handle : m_largeHandles) {
+                    if (handleBounds(handle).intersects(bounds))
+                        out = handle;
+                }
+            }
+
+            /**
+             * Calls the given function for every handle in a cell whose bounds, expanded by the radius returned by
+             * the given function for them, are hit by the given ray. The radius must not be smaller than the pick
+             * radius of any handle within the given bounds, so that no handle which could be hit is skipped, and it
+             * must not shrink when the bounds grow.
+             *
+             * Only the cells near the cells which the ray passes through are visited, unless there are so few cells
+             * that looking at all of them is cheaper.
+             */
+            template <typename R, typename F>
+            void findHandles(const Ray3& ray, const R& radius, F func) const {
+                for (const H& handle : m_largeHandles) {
+                    const BBox3 bounds = handleBounds(handle);
+                    if (hits(ray, BBox3(bounds).expand(radius(bounds))))
+                        func(handle);
+                }
+
+                if (m_cells.empty())
+                    return;
+
+                // The bounds of a cell reach at most half the cell size beyond the cell, and the radius of the bounds
+                // of all cells is at least as large as the radius of the bounds of any cell. A cell can therefore only
+                // be hit if the ray passes within this reach of it.
+                const BBox3 allBounds = BBox3(cellMin(m_minKey), cellMin(m_maxKey + Vec3i(1, 1, 1))).expand(m_cellSize / 2.0);
+                const FloatType reach = m_cellSize / 2.0 + radius(allBounds);
+                const int k = static_cast<int>(std::ceil(reach / m_cellSize));
+                const Vec3i minKey = m_minKey - Vec3i(k, k, k);
+                const Vec3i maxKey = m_maxKey + Vec3i(k, k, k);
+
+                std::vector<Vec3i> keys;
+                if (!findKeysNearRay(ray, minKey, maxKey, k, keys)) {
+                    for (const auto& entry : m_cells)
+                        visitCell(entry.second, ray, radius, func);
+                    return;
+                }
+
+                std::sort(std::begin(keys), std::end(keys));
+                keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+                for (const Vec3i& key : keys) {
+                    const auto it = m_cells.find(key);
+                    if (it != std::end(m_cells))
+                        visitCell(it->second, ray, radius, func);
+                }
+            }
+        private:
+            bool isLarge(const BBox3& bounds) const {
+                const Vec3 size = bounds.size();
+                return size.x() > m_cellSize || size.y() > m_cellSize || size.z() > m_cellSize;
+            }
+
+            static bool removeHandle(HandleList& handles, const H& handle) {
+                const auto it = std::find_if(std::begin(handles), std::end(handles), [&handle](const H& candidate) {
+                    return candidate.compare(handle) == 0;
+                });
+                if (it == std::end(handles))
+                    return false;
+                handles.erase(it);
+                return true;
+            }
+
+            Vec3i cellKey(const BBox3& bounds) const {
+                return pointKey(bounds.center());
+            }
+
+            Vec3i pointKey(const Vec3& point) const {
+                const Vec3 scaled = point / m_cellSize;
+                return Vec3i(static_cast<int>(std::floor(scaled.x())),
+                             static_cast<int>(std::floor(scaled.y())),
+                             static_cast<int>(std::floor(scaled.z())));
+            }
+
+            Vec3 cellMin(const Vec3i& key) const {
+                return Vec3(static_cast<FloatType>(key.x()) * m_cellSize,
+                            static_cast<FloatType>(key.y()) * m_cellSize,
+                            static_cast<FloatType>(key.z()) * m_cellSize);
+            }
+
+            static const BBox3& cellBounds(const Cell& cell) {
+                if (!cell.boundsValid) {
+                    assert(!cell.handles.empty());
+                    cell.bounds = handleBounds(cell.handles.front());
+                    for (const H& handle : cell.handles)
+                        cell.bounds.mergeWith(handleBounds(handle));
+                    cell.boundsValid = true;
+                }
+                return cell.bounds;
+            }
+
+            static bool hits(const Ray3& ray, const BBox3& bounds) {
+                return !Math::isnan(bounds.intersectWithRay(ray));
+            }
+
+            template <typename R, typename F>
+            static void visitCell(const Cell& cell, const Ray3& ray, const R& radius, F& func) {
+                const BBox3& bounds = cellBounds(cell);
+                if (hits(ray, BBox3(bounds).expand(radius(bounds)))) {
+                    for (const H& handle : cell.handles)
+                        func(handle);
+                }
+            }
+
+            /**
+             * Walks the cells between the given keys which the given ray passes through and collects the keys of the
+             * cells within k cells of them. Returns false without collecting all keys if there would be more of
+             * them than there are cells in this index.
+             */
+            bool findKeysNearRay(const Ray3& ray, const Vec3i& minKey, const Vec3i& maxKey, const int k, std::vector<Vec3i>& keys) const {
+                static const FloatType Infinity = std::numeric_limits<FloatType>::max();
+
+                // clip the ray to the cells between the keys
+                const Vec3 min = cellMin(minKey);
+                const Vec3 max = cellMin(maxKey + Vec3i(1, 1, 1));
+                FloatType tEntry = 0.0;
+                FloatType tExit = Infinity;
+                for (size_t i = 0; i < 3; ++i) {
+                    if (ray.direction[i] == 0.0) {
+                        if (ray.origin[i] < min[i] || ray.origin[i] > max[i])
+                            return true;
+                    } else {
+                        const FloatType t1 = (min[i] - ray.origin[i]) / ray.direction[i];
+                        const FloatType t2 = (max[i] - ray.origin[i]) / ray.direction[i];
+                        tEntry = std::max(tEntry, std::min(t1, t2));
+                        tExit = std::min(tExit, std::max(t1, t2));
+                    }
+                }
+                if (tEntry > tExit)
+                    return true;
+
+                const Vec3i entryKey = clampKey(pointKey(ray.pointAtDistance(tEntry)), minKey, maxKey);
+                const Vec3i exitKey = clampKey(pointKey(ray.pointAtDistance(tExit)), minKey, maxKey);
+                const size_t neighbours = static_cast<size_t>((2 * k + 1) * (2 * k + 1) * (2 * k + 1));
+                size_t steps = 1;
+                for (size_t i = 0; i < 3; ++i)
+                    steps += static_cast<size_t>(std::abs(exitKey[i] - entryKey[i]));
+                if (steps * neighbours > m_cells.size())
+                    return false;
+
+                // step from cell to cell along the ray, see Amanatides and Woo, "A Fast Voxel Traversal Algorithm"
+                Vec3i key = entryKey;
+                int step[3];
+                FloatType tMax[3], tDelta[3];
+                for (size_t i = 0; i < 3; ++i) {
+                    if (ray.direction[i] > 0.0) {
+                        step[i] = 1;
+                        tMax[i] = (static_cast<FloatType>(key[i] + 1) * m_cellSize - ray.origin[i]) / ray.direction[i];
+                        tDelta[i] = m_cellSize / ray.direction[i];
+                    } else if (ray.direction[i] < 0.0) {
+                        step[i] = -1;
+                        tMax[i] = (static_cast<FloatType>(key[i]) * m_cellSize - ray.origin[i]) / ray.direction[i];
+                        tDelta[i] = -m_cellSize / ray.direction[i];
+                    } else {
+                        step[i] = 0;
+                        tMax[i] = Infinity;
+                        tDelta[i] = Infinity;
+                    }
+                }
+
+                while (true) {
+                    for (int x = -k; x <= k; ++x) {
+                        for (int y = -k; y <= k; ++y) {
+                            for (int z = -k; z <= k; ++z)
+                                keys.push_back(key + Vec3i(x, y, z));
+                        }
+                    }
+
+                    size_t axis = 0;
+                    if (tMax[1] < tMax[axis])
+                        axis = 1;
+                    if (tMax[2] < tMax[axis])
+                        axis = 2;
+                    if (tMax[axis] > tExit)
+                        break;
+
+                    key[axis] += step[axis];
+                    if (key[axis] < minKey[axis] || key[axis] > maxKey[axis])
+                        break;
+                    tMax[axis] += tDelta[axis];
+                }
+                return true;
+            }
+
+            static Vec3i clampKey(const Vec3i& key, const Vec3i& minKey, const Vec3i& maxKey) {
+                return Vec3i(std::max(minKey.x(), std::min(maxKey.x(), key.x())),
+                             std::max(minKey.y(), std::min(maxKey.y(), key.y())),
+                             std::max(minKey.z(), std::min(maxKey.z(), key.z())));
+            }
+        };
+    }
+}
+
+#endif /* HandleIndex_h */
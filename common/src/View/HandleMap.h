@@ -0,0 +1,263 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HandleMap_h
+#define HandleMap_h
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        template <typename F>
+        void eachHandleVertex(const Vec3& handle, F func) {
+            func(handle);
+        }
+
+        template <typename F>
+        void eachHandleVertex(const Edge3& handle, F func) {
+            func(handle.start());
+            func(handle.end());
+        }
+
+        template <typename F>
+        void eachHandleVertex(const Polygon3& handle, F func) {
+            for (const Vec3& vertex : handle)
+                func(vertex);
+        }
+
+        /**
+         * Maps handles to values, treating two handles as identical if they compare equal within an epsilon.
+         *
+         * The coordinates of a handle are quantized to a grid whose cells are much larger than the epsilon, and
+         * the handles are stored in buckets keyed by a hash of the quantized coordinates. Two handles which are
+         * equal within the epsilon can only end up in different buckets if one of their coordinates lies within
+         * the epsilon of a cell boundary, so a lookup first checks the bucket of the given handle, and then the
+         * buckets of the neighboring cells across every such boundary.
+         */
+        template <typename H, typename V>
+        class HandleMap {
+        public:
+            struct Entry {
+                H handle;
+                V value;
+
+                Entry(const H& i_handle, const V& i_value) :
+                handle(i_handle),
+                value(i_value) {}
+            };
+        private:
+            typedef std::vector<Entry> Bucket;
+            typedef std::unordered_map<uint64_t, Bucket> BucketMap;
+
+            /**
+             * The maximum number of coordinates near a cell boundary for which the neighboring buckets are
+             * probed. If a handle has more such coordinates, all handles are searched instead.
+             */
+            static const size_t MaxNeighbors = 8;
+
+            struct Key {
+                uint64_t hash;
+                uint64_t neighborDeltas[MaxNeighbors];
+                size_t neighborCount;
+                bool overflow;
+
+                Key() :
+                hash(0),
+                neighborCount(0),
+                overflow(false) {}
+            };
+
+            FloatType m_epsilon;
+            FloatType m_cellSize;
+            BucketMap m_buckets;
+            size_t m_size;
+        public:
+            explicit HandleMap(const FloatType epsilon = 0.1, const FloatType cellSize = 8.0) :
+            m_epsilon(epsilon),
+            m_cellSize(cellSize),
+            m_size(0) {
+                assert(m_cellSize > 2.0 * m_epsilon + 1.0);
+            }
+
+            size_t size() const {
+                return m_size;
+            }
+
+            bool empty() const {
+                return m_size == 0;
+            }
+
+            void clear() {
+                m_buckets.clear();
+                m_size = 0;
+            }
+
+            Entry* find(const H& handle) {
+                typename BucketMap::iterator bucketIt;
+                size_t index;
+                if (!locate(handle, bucketIt, index))
+                    return nullptr;
+                return &bucketIt->second[index];
+            }
+
+            const Entry* find(const H& handle) const {
+                return const_cast<HandleMap<H,V>*>(this)->find(handle);
+            }
+
+            /**
+             * Returns the entry for the given handle, inserting it with the given value if no handle equal to it
+             * exists. The returned reference is invalidated by the next modification.
+             */
+            Entry& findOrInsert(const H& handle, const V& value) {
+                Entry* entry = find(handle);
+                if (entry != nullptr)
+                    return *entry;
+
+                Bucket& bucket = m_buckets[key(handle).hash];
+                bucket.push_back(Entry(handle, value));
+                ++m_size;
+                return bucket.back();
+            }
+
+            bool erase(const H& handle) {
+                typename BucketMap::iterator bucketIt;
+                size_t index;
+                if (!locate(handle, bucketIt, index))
+                    return false;
+
+                Bucket& bucket = bucketIt->second;
+                if (index < bucket.size() - 1)
+                    std::swap(bucket[index], bucket.back());
+                bucket.pop_back();
+                if (bucket.empty())
+                    m_buckets.erase(bucketIt);
+                --m_size;
+                return true;
+            }
+
+            template <typename F>
+            void forEach(F func) const {
+                for (const auto& bucket : m_buckets) {
+                    for (const Entry& entry : bucket.second)
+                        func(entry);
+                }
+            }
+
+            template <typename F>
+            void forEach(F func) {
+                for (auto& bucket : m_buckets) {
+                    for (Entry& entry : bucket.second)
+                        func(entry);
+                }
+            }
+        private:
+            bool locate(const H& handle, typename BucketMap::iterator& bucketIt, size_t& index) {
+                const Key k = key(handle);
+                if (k.overflow)
+                    return locateAnywhere(handle, bucketIt, index);
+
+                // try every combination of the neighboring cells of the coordinates near a cell boundary
+                const size_t combinations = static_cast<size_t>(1) << k.neighborCount;
+                for (size_t mask = 0; mask < combinations; ++mask) {
+                    uint64_t hash = k.hash;
+                    for (size_t i = 0; i < k.neighborCount; ++i) {
+                        if (mask & (static_cast<size_t>(1) << i))
+                            hash += k.neighborDeltas[i];
+                    }
+
+                    bucketIt = m_buckets.find(hash);
+                    if (bucketIt != std::end(m_buckets) && locateInBucket(handle, bucketIt->second, index))
+                        return true;
+                }
+                return false;
+            }
+
+            bool locateAnywhere(const H& handle, typename BucketMap::iterator& bucketIt, size_t& index) {
+                for (bucketIt = std::begin(m_buckets); bucketIt != std::end(m_buckets); ++bucketIt) {
+                    if (locateInBucket(handle, bucketIt->second, index))
+                        return true;
+                }
+                return false;
+            }
+
+            bool locateInBucket(const H& handle, const Bucket& bucket, size_t& index) const {
+                for (index = 0; index < bucket.size(); ++index) {
+                    if (bucket[index].handle.compare(handle, m_epsilon) == 0)
+                        return true;
+                }
+                return false;
+            }
+
+            /**
+             * The hash of a handle is the sum of the hashes of its quantized coordinates, so that the hash of a
+             * neighboring cell is obtained by adding the difference of the hashes of the changed coordinate. The
+             * cell boundaries are shifted to lie halfway between integers so that the usual on grid coordinates are
+             * never near them.
+             */
+            Key key(const H& handle) const {
+                Key result;
+                size_t position = 0;
+                eachHandleVertex(handle, [this, &result, &position](const Vec3& vertex) {
+                    for (size_t i = 0; i < 3; ++i) {
+                        const FloatType value = (vertex[i] + m_cellSize / 2.0 + 0.5) / m_cellSize;
+                        const FloatType cell = std::floor(value);
+                        const int64_t coord = static_cast<int64_t>(cell);
+                        const uint64_t hash = hashCoord(coord, position);
+                        result.hash += hash;
+
+                        const FloatType epsilon = m_epsilon / m_cellSize;
+                        if (value - cell <= epsilon)
+                            addNeighbor(result, hashCoord(coord - 1, position) - hash);
+                        else if (cell + 1.0 - value <= epsilon)
+                            addNeighbor(result, hashCoord(coord + 1, position) - hash);
+                        ++position;
+                    }
+                });
+                return result;
+            }
+
+            static void addNeighbor(Key& key, const uint64_t delta) {
+                if (key.neighborCount < MaxNeighbors)
+                    key.neighborDeltas[key.neighborCount++] = delta;
+                else
+                    key.overflow = true;
+            }
+
+            static uint64_t hashCoord(const int64_t coord, const size_t position) {
+                uint64_t hash = static_cast<uint64_t>(coord) ^ (static_cast<uint64_t>(position) * 0x9E3779B97F4A7C15ull);
+                hash ^= hash >> 33;
+                hash *= 0xFF51AFD7ED558CCDull;
+                hash ^= hash >> 33;
+                hash *= 0xC4CEB9FE1A85EC53ull;
+                hash ^= hash >> 33;
+                return hash;
+            }
+        };
+    }
+}
+
+#endif /* HandleMap_h */
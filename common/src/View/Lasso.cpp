@@ -22,11 +22,14 @@
 #include "Renderer/Camera.h"
 #include "Renderer/RenderService.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace View {
         Lasso::Lasso(const Renderer::Camera& camera, const FloatType distance, const Vec3& point) :
         m_camera(camera),
         m_distance(distance),
+        m_orthographic(m_camera.orthographicProjection()),
         m_transform(coordinateSystemMatrix(m_camera.right(), m_camera.up(), -m_camera.direction(),
                                            m_camera.defaultPoint(static_cast<float>(m_distance)))),
         m_start(point),
@@ -37,6 +40,13 @@ namespace TrenchBroom {
         }
 
         bool Lasso::selects(const Vec3& point, const Plane3& plane, const BBox2& box) const {
+            if (m_orthographic) {
+                // The pick ray is parallel to the plane normal and thus to the z axis of the lasso's coordinate
+                // system, so the point's projection onto the plane only differs from the point in z.
+                const Vec3 projected = m_transform * point;
+                return box.contains(projected);
+            }
+            
             const Ray3 ray(m_camera.pickRay(point));
             const FloatType hitDistance = plane.intersectWithRay(ray);
             if (Math::isnan(hitDistance))
@@ -55,6 +65,54 @@ namespace TrenchBroom {
             return selects(polygon.center(), plane, box);
         }
         
+        BBox3 Lasso::bounds(const BBox3& extent) const {
+            const BBox2 box = this->box();
+            const Mat4x4 inverted = invertedMatrix(m_transform);
+            
+            const Vec3 corners[] = {
+                inverted * Vec3(box.min.x(), box.min.y(), 0.0),
+                inverted * Vec3(box.min.x(), box.max.y(), 0.0),
+                inverted * Vec3(box.max.x(), box.max.y(), 0.0),
+                inverted * Vec3(box.max.x(), box.min.y(), 0.0)
+            };
+            
+            BBox3 result = extent;
+            if (m_orthographic) {
+                // The selected volume is the lasso rectangle swept along the view direction, so it is only bounded
+                // along the axes which are orthogonal to the view direction.
+                const Vec3 direction(m_camera.direction());
+                for (size_t i = 0; i < 3; ++i) {
+                    if (direction[i] == 0.0) {
+                        FloatType min = corners[0][i];
+                        FloatType max = corners[0][i];
+                        for (const Vec3& corner : corners) {
+                            min = std::min(min, corner[i]);
+                            max = std::max(max, corner[i]);
+                        }
+                        result.min[i] = std::max(result.min[i], min);
+                        result.max[i] = std::min(result.max[i], max);
+                    }
+                }
+            } else {
+                // The selected volume is the cone from the camera position through the lasso rectangle, so it lies
+                // on one side of the camera position along every axis on which all of its edges point the same way.
+                const Vec3 position(m_camera.position());
+                for (size_t i = 0; i < 3; ++i) {
+                    bool positive = true;
+                    bool negative = true;
+                    for (const Vec3& corner : corners) {
+                        positive &= corner[i] >= position[i];
+                        negative &= corner[i] <= position[i];
+                    }
+                    if (positive)
+                        result.min[i] = std::max(result.min[i], position[i]);
+                    if (negative)
+                        result.max[i] = std::min(result.max[i], position[i]);
+                }
+            }
+            return result;
+        }
+        
         Vec3 Lasso::project(const Vec3& point, const Plane3& plane) const {
             const Ray3 ray(m_camera.pickRay(point));
             const FloatType hitDistance = plane.intersectWithRay(ray);
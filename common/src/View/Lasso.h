@@ -20,9 +20,13 @@
 #ifndef TrenchBroom_Lasso
 #define TrenchBroom_Lasso
 
+#include "ParallelUtils.h"
 #include "TrenchBroom.h"
 #include "VecMath.h"
 
+#include <iterator>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         class Camera;
@@ -33,8 +37,12 @@ namespace TrenchBroom {
     namespace View {
         class Lasso {
         private:
+            // below this number of candidates, testing them concurrently does not pay off
+            static const size_t ParallelThreshold = 1024;
+            
             const Renderer::Camera& m_camera;
             const FloatType m_distance;
+            const bool m_orthographic;
             const Mat4x4 m_transform;
             const Vec3 m_start;
             Vec3 m_cur;
@@ -43,14 +51,34 @@ namespace TrenchBroom {
             
             void update(const Vec3& point);
             
+            /**
+             * Writes the elements of the given random access range which are selected by this lasso to the given
+             * output iterator, in the order in which they appear in the range. Large ranges are tested
+             * concurrently.
+             */
             template <typename I, typename O>
             void selected(I cur, I end, O out) const {
                 const Plane3 plane = this->plane();
                 const BBox2 box = this->box();
-                while (cur != end) {
-                    if (selects(*cur, plane, box))
-                        out = *cur;
-                    ++cur;
+                
+                const size_t count = static_cast<size_t>(std::distance(cur, end));
+                if (count < ParallelThreshold) {
+                    while (cur != end) {
+                        if (selects(*cur, plane, box))
+                            out = *cur;
+                        ++cur;
+                    }
+                } else {
+                    std::vector<char> flags(count, 0);
+                    ParallelUtils::forEachIndex(count, [&](const size_t i) {
+                        flags[i] = selects(*(cur + static_cast<typename std::iterator_traits<I>::difference_type>(i)), plane, box) ? 1 : 0;
+                    });
+                    
+                    for (size_t i = 0; i < count; ++i) {
+                        if (flags[i] != 0)
+                            out = *cur;
+                        ++cur;
+                    }
                 }
             }
             
@@ -58,6 +86,12 @@ namespace TrenchBroom {
             bool selects(const H& h) const {
                 return selects(h, plane(), box());
             }
+            
+            /**
+             * Returns bounds within the given extent that contain every point of the extent which this lasso
+             * selects, so that spatial indices can be queried for the candidates of a selection.
+             */
+            BBox3 bounds(const BBox3& extent) const;
         private:
             bool selects(const Vec3& point, const Plane3& plane, const BBox2& box) const;
             bool selects(const Edge3& edge, const Plane3& plane, const BBox2& box) const;
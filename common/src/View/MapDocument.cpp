@@ -22,6 +22,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Polyhedron.h"
+#include "Trace.h"
 #include "Assets/EntityDefinitionManager.h"
 #include "Assets/EntityModelManager.h"
 #include "Assets/Texture.h"
@@ -71,10 +72,12 @@
 #include "Model/NodeVisitor.h"
 #include "Model/NonIntegerPlanePointsIssueGenerator.h"
 #include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/ParallelNodeVisitor.h"
 #include "Model/WorldBoundsIssueGenerator.h"
 #include "Model/PointEntityWithBrushesIssueGenerator.h"
 #include "Model/PointFile.h"
 #include "Model/World.h"
+#include "Renderer/RenderProfiler.h"
 #include "View/AddBrushVerticesCommand.h"
 #include "View/AddRemoveNodesCommand.h"
 #include "View/ChangeBrushFaceAttributesCommand.h"
@@ -91,6 +94,7 @@
 #include "View/MoveBrushFacesCommand.h"
 #include "View/MoveBrushVerticesCommand.h"
 #include "View/MoveTexturesCommand.h"
+#include "View/NodeClipboardCache.h"
 #include "View/RemoveBrushEdgesCommand.h"
 #include "View/RemoveBrushFacesCommand.h"
 #include "View/RemoveBrushVerticesCommand.h"
@@ -133,7 +137,8 @@ namespace TrenchBroom {
         m_currentTextureName(Model::BrushFace::NoTextureName),
         m_lastSelectionBounds(0.0, 32.0),
         m_selectionBoundsValid(true),
-        m_viewEffectsService(nullptr) {
+        m_viewEffectsService(nullptr),
+        m_clipboardCache(new NodeClipboardCache()) {
             bindObservers();
         }
         
@@ -144,6 +149,7 @@ namespace TrenchBroom {
                 unloadPointFile();
             clearWorld();
             
+            delete m_clipboardCache;
             delete m_grid;
             delete m_mapViewConfig;
             delete m_textureManager;
@@ -240,6 +246,7 @@ namespace TrenchBroom {
         }
         
         void MapDocument::loadDocument(const Model::MapFormat::Type mapFormat, const BBox3& worldBounds, Model::GameSPtr game, const IO::Path& path) {
+            const TraceSpan span("MapDocument::loadDocument", path.asString());
             info("Loading document from " + path.asString());
             
             clearDocument();
@@ -293,7 +300,10 @@ namespace TrenchBroom {
         String MapDocument::serializeSelectedNodes() {
             StringStream stream;
             m_game->writeNodesToStream(m_world, m_selectedNodes.nodes(), stream);
-            return stream.str();
+
+            const String result = stream.str();
+            m_clipboardCache->store(result, m_selectedNodes.nodes(), m_worldBounds);
+            return result;
         }
         
         String MapDocument::serializeSelectedBrushFaces() {
@@ -303,6 +313,17 @@ namespace TrenchBroom {
         }
         
         PasteType MapDocument::paste(const String& str) {
+            if (m_clipboardCache->contains(str)) {
+                try {
+                    const Model::NodeList nodes = m_clipboardCache->cloneNodes(m_worldBounds);
+                    if (pasteNodes(nodes))
+                        return PT_Node;
+                    return PT_Failed;
+                } catch (const GeometryException&) {
+                    // parse the text instead, which skips the brushes that cannot be built
+                }
+            }
+
             try {
                 const Model::NodeList nodes = m_game->parseNodes(str, m_world, m_worldBounds, this);
                 if (!nodes.empty() && pasteNodes(nodes))
@@ -454,10 +475,16 @@ namespace TrenchBroom {
         void MapDocument::selectTouching(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
             
-            Model::CollectTouchingNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
+            // Only the nodes within the bounds of the selected brushes can touch them. The bounds are expanded a
+            // little since the touching test is not exact either.
+            const BBox3 bounds = Model::computeBounds(std::begin(brushes), std::end(brushes)).expanded(Math::Constants<FloatType>::almostZero());
+            const Model::NodeList candidates = m_world->findLayerChildren(bounds);
             
-            const Model::NodeList nodes = visitor.nodes();
+            typedef Model::CollectTouchingNodesVisitor<Model::BrushList::const_iterator> Visitor;
+            const Model::EditorContext& context = editorContext();
+            const Model::NodeList nodes = Model::collectNodesParallel<Visitor>(candidates, [&brushes, &context]() {
+                return Visitor(std::begin(brushes), std::end(brushes), context);
+            });
             
             Transaction transaction(this, "Select Touching");
             if (del)
@@ -470,10 +497,16 @@ namespace TrenchBroom {
         void MapDocument::selectInside(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
 
-            Model::CollectContainedNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-            
-            const Model::NodeList nodes = visitor.nodes();
+            // Only the nodes within the bounds of the selected brushes can be contained in them. The bounds are
+            // expanded a little since the containment test is not exact either.
+            const BBox3 bounds = Model::computeBounds(std::begin(brushes), std::end(brushes)).expanded(Math::Constants<FloatType>::almostZero());
+            const Model::NodeList candidates = m_world->findLayerChildren(bounds);
+
+            typedef Model::CollectContainedNodesVisitor<Model::BrushList::const_iterator> Visitor;
+            const Model::EditorContext& context = editorContext();
+            const Model::NodeList nodes = Model::collectNodesParallel<Visitor>(candidates, [&brushes, &context]() {
+                return Visitor(std::begin(brushes), std::end(brushes), context);
+            });
 
             Transaction transaction(this, "Select Inside");
             if (del)
@@ -932,6 +965,7 @@ namespace TrenchBroom {
         }
         
         bool MapDocument::csgSubtract() {
+            const TraceSpan span("MapDocument::csgSubtract");
             const Model::BrushList brushes = selectedNodes().brushes();
             if (brushes.size() < 2)
                 return false;
@@ -943,6 +977,7 @@ namespace TrenchBroom {
             Model::NodeList toRemove;
             toRemove.push_back(subtrahend);
             
+            // minuends that do not overlap the subtrahend are skipped by their bounds
             for (Model::Brush* minuend : minuends) {
                 const Model::BrushList result = minuend->subtract(*m_world, m_worldBounds, currentTextureName(), subtrahend);
                 if (!result.empty()) {
@@ -1117,6 +1152,7 @@ namespace TrenchBroom {
         }
         
         bool MapDocument::snapVertices(const size_t snapTo) {
+            const TraceSpan span("MapDocument::snapVertices");
             assert(m_selectedNodes.hasOnlyBrushes());
             return submitAndStore(SnapBrushVerticesCommand::snap(snapTo));
         }
@@ -1236,6 +1272,7 @@ namespace TrenchBroom {
         }
         
         void MapDocument::pick(const Ray3& pickRay, Model::PickResult& pickResult) const {
+            Renderer::RenderProfiler::TimeSection timeSection(Renderer::RenderProfiler::Section_Pick);
             if (m_world != nullptr)
                 m_world->pick(pickRay, pickResult);
         }
@@ -1268,6 +1305,7 @@ namespace TrenchBroom {
         }
         
         void MapDocument::clearWorld() {
+            m_clipboardCache->clear();
             delete m_world;
             m_world = nullptr;
             m_currentLayer = nullptr;
@@ -1304,6 +1342,7 @@ namespace TrenchBroom {
         }
 
         void MapDocument::loadAssets() {
+            const TraceSpan span("MapDocument::loadAssets");
             loadEntityDefinitions();
             setEntityDefinitions();
             loadEntityModels();
@@ -1361,6 +1400,7 @@ namespace TrenchBroom {
         }
         
         void MapDocument::reloadTextures() {
+            const TraceSpan span("MapDocument::reloadTextures");
             unsetTextures();
             loadTextures();
             setTextures();
@@ -57,6 +57,7 @@ namespace TrenchBroom {
         class Command;
         class Grid;
         class MapViewConfig;
+        class NodeClipboardCache;
         class Selection;
         class UndoableCommand;
         class ViewEffectsService;
@@ -94,6 +95,7 @@ namespace TrenchBroom {
             mutable bool m_selectionBoundsValid;
             
             ViewEffectsService* m_viewEffectsService;
+            NodeClipboardCache* m_clipboardCache;
         public: // notification
             Notifier1<Command::Ptr> commandDoNotifier;
             Notifier1<Command::Ptr> commandDoneNotifier;
@@ -20,6 +20,7 @@
 #include "MapDocumentCommandFacade.h"
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
 #include "Preferences.h"
 #include "PreferenceManager.h"
 #include "Assets/EntityDefinitionFileSpec.h"
@@ -37,6 +38,7 @@
 #include "Model/Group.h"
 #include "Model/Issue.h"
 #include "Model/ModelUtils.h"
+#include "Model/ParallelNodeVisitor.h"
 #include "Model/Snapshot.h"
 #include "Model/TransformObjectVisitor.h"
 #include "Model/World.h"
@@ -44,6 +46,27 @@
 
 namespace TrenchBroom {
     namespace View {
+        /**
+         * Computes the new geometries of the brushes in the given map concurrently, then applies them one after
+         * another on the calling thread, which is where all node change notifications and texture usage updates
+         * must happen.
+         */
+        template <typename M, typename F>
+        static void setNewGeometries(const BBox3& worldBounds, const M& brushMap, F computeNewGeometry) {
+            std::vector<typename M::const_iterator> entries;
+            entries.reserve(brushMap.size());
+            for (auto it = std::begin(brushMap); it != std::end(brushMap); ++it)
+                entries.push_back(it);
+
+            std::vector<Model::Brush::NewGeometry> newGeometries(entries.size());
+            ParallelUtils::forEachIndex(entries.size(), [&](const size_t i) {
+                newGeometries[i] = computeNewGeometry(entries[i]->first, entries[i]->second);
+            });
+
+            for (size_t i = 0; i < entries.size(); ++i)
+                entries[i]->first->setNewGeometry(worldBounds, newGeometries[i]);
+        }
+
         MapDocumentSPtr MapDocumentCommandFacade::newMapDocument() {
             return MapDocumentSPtr(new MapDocumentCommandFacade());
         }
@@ -118,9 +141,11 @@ namespace TrenchBroom {
         void MapDocumentCommandFacade::performSelectAllNodes() {
             performDeselectAll();
             
-            Model::CollectSelectableNodesVisitor visitor(*m_editorContext);
-            m_world->acceptAndRecurse(visitor);
-            performSelect(visitor.nodes());
+            const Model::EditorContext& editorContext = *m_editorContext;
+            const Model::NodeList nodes = Model::collectNodesParallel<Model::CollectSelectableNodesVisitor>(m_world, [&editorContext]() {
+                return Model::CollectSelectableNodesVisitor(editorContext);
+            });
+            performSelect(nodes);
         }
         
         void MapDocumentCommandFacade::performSelectAllBrushFaces() {
@@ -685,9 +710,13 @@ namespace TrenchBroom {
             size_t succeededBrushCount = 0;
             size_t failedBrushCount = 0;
 
-            for (Model::Brush* brush : brushes) {
-                if (brush->canSnapVertices(m_worldBounds, snapTo)) {
-                    brush->snapVertices(m_worldBounds, snapTo);
+            std::vector<Model::Brush::NewGeometry> newGeometries = ParallelUtils::transform<Model::Brush::NewGeometry>(brushes, [snapTo](const Model::Brush* brush) {
+                return brush->computeSnappedVertices(snapTo);
+            });
+
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if (newGeometries[i].geometry.polyhedron()) {
+                    brushes[i]->setNewGeometry(m_worldBounds, newGeometries[i]);
                     succeededBrushCount += 1;
                 } else {
                     failedBrushCount += 1;
@@ -717,12 +746,19 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
+            setNewGeometries(m_worldBounds, vertices, [&delta](const Model::Brush* brush, const Vec3::List& oldPositions) {
+                return brush->computeMovedVertices(oldPositions, delta);
+            });
+
+            // vertices that were merged with others or that became redundant are gone now
             Vec3::List newVertexPositions;
             for (const auto& entry : vertices) {
-                Model::Brush* brush = entry.first;
-                const Vec3::List& oldPositions = entry.second;
-                const Vec3::List newPositions = brush->moveVertices(m_worldBounds, oldPositions, delta);
-                VectorUtils::append(newVertexPositions, newPositions);
+                const Model::Brush* brush = entry.first;
+                for (const Vec3& oldPosition : entry.second) {
+                    const Vec3 newPosition = oldPosition + delta;
+                    if (brush->hasVertex(newPosition))
+                        newVertexPositions.push_back(newPosition);
+                }
             }
             
             invalidateSelectionBounds();
@@ -738,12 +774,14 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
+            setNewGeometries(m_worldBounds, edges, [&delta](const Model::Brush* brush, const Edge3::List& oldPositions) {
+                return brush->computeMovedVertices(Edge3::asVertexList(oldPositions), delta);
+            });
+
             Edge3::List newEdgePositions;
             for (const auto& entry : edges) {
-                Model::Brush* brush = entry.first;
-                const Edge3::List& oldPositions = entry.second;
-                const Edge3::List newPositions = brush->moveEdges(m_worldBounds, oldPositions, delta);
-                VectorUtils::append(newEdgePositions, newPositions);
+                for (const Edge3& oldPosition : entry.second)
+                    newEdgePositions.push_back(Edge3(oldPosition.start() + delta, oldPosition.end() + delta));
             }
 
             invalidateSelectionBounds();
@@ -759,12 +797,14 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
+            setNewGeometries(m_worldBounds, faces, [&delta](const Model::Brush* brush, const Polygon3::List& oldPositions) {
+                return brush->computeMovedVertices(Polygon3::asVertexList(oldPositions), delta);
+            });
+
             Polygon3::List newFacePositions;
             for (const auto& entry : faces) {
-                Model::Brush* brush = entry.first;
-                const Polygon3::List& oldPositions = entry.second;
-                const Polygon3::List newPositions = brush->moveFaces(m_worldBounds, oldPositions, delta);
-                VectorUtils::append(newFacePositions, newPositions);
+                for (const Polygon3& oldPosition : entry.second)
+                    newFacePositions.push_back(Polygon3(oldPosition.vertices() + delta));
             }
             
             invalidateSelectionBounds();
@@ -780,12 +820,17 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
+            Model::BrushVerticesMap brushVertices;
             for (const auto& entry : vertices) {
                 const Vec3& position = entry.first;
                 const Model::BrushSet& brushes = entry.second;
                 for (Model::Brush* brush : brushes)
-                    brush->addVertex(m_worldBounds, position);
+                    brushVertices[brush].push_back(position);
             }
+
+            setNewGeometries(m_worldBounds, brushVertices, [](const Model::Brush* brush, const Vec3::List& positions) {
+                return brush->computeAddedVertices(positions);
+            });
             
             invalidateSelectionBounds();
         }
@@ -797,11 +842,9 @@ namespace TrenchBroom {
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
             Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
             
-            for (const auto& entry : vertices) {
-                Model::Brush* brush = entry.first;
-                const Vec3::List& positions = entry.second;
-                brush->removeVertices(m_worldBounds, positions);
-            }
+            setNewGeometries(m_worldBounds, vertices, [](const Model::Brush* brush, const Vec3::List& positions) {
+                return brush->computeRemovedVertices(positions);
+            });
             
             invalidateSelectionBounds();
         }
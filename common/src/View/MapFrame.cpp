@@ -34,6 +34,7 @@
 #include "Model/NodeCollection.h"
 #include "Model/PointFile.h"
 #include "Model/World.h"
+#include "Renderer/RenderProfiler.h"
 #include "View/ActionManager.h"
 #include "View/Autosaver.h"
 #include "View/BorderLine.h"
@@ -77,6 +78,7 @@
 #include <wx/statusbr.h>
 
 #include <cassert>
+#include <fstream>
 
 namespace TrenchBroom {
     namespace View {
@@ -743,6 +745,8 @@ namespace TrenchBroom {
             Bind(wxEVT_MENU, &MapFrame::OnViewToggleMaximizeCurrentView, this, CommandIds::Menu::ViewToggleMaximizeCurrentView);
             Bind(wxEVT_MENU, &MapFrame::OnViewToggleInfoPanel, this, CommandIds::Menu::ViewToggleInfoPanel);
             Bind(wxEVT_MENU, &MapFrame::OnViewToggleInspector, this, CommandIds::Menu::ViewToggleInspector);
+            Bind(wxEVT_MENU, &MapFrame::OnViewToggleRenderProfiler, this, CommandIds::Menu::ViewToggleRenderProfiler);
+            Bind(wxEVT_MENU, &MapFrame::OnViewSaveRenderProfile, this, CommandIds::Menu::ViewSaveRenderProfile);
 
             Bind(wxEVT_MENU, &MapFrame::OnRunCompile, this, CommandIds::Menu::RunCompile);
             Bind(wxEVT_MENU, &MapFrame::OnRunLaunch, this, CommandIds::Menu::RunLaunch);
@@ -1283,6 +1287,32 @@ namespace TrenchBroom {
                 m_hSplitter->maximize(m_vSplitter);
         }
 
+        void MapFrame::OnViewToggleRenderProfiler(wxCommandEvent& event) {
+            if (IsBeingDeleted()) return;
+
+            Renderer::RenderProfiler& profiler = Renderer::RenderProfiler::instance();
+            profiler.setEnabled(!profiler.enabled());
+            m_mapView->Refresh();
+        }
+
+        void MapFrame::OnViewSaveRenderProfile(wxCommandEvent& event) {
+            if (IsBeingDeleted()) return;
+
+            wxFileDialog saveDialog(this, "Save Render Profile", wxEmptyString, "render-profile.csv", "CSV files (*.csv)|*.csv", wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+            if (saveDialog.ShowModal() == wxID_CANCEL)
+                return;
+
+            const IO::Path path(saveDialog.GetPath().ToStdString());
+            std::ofstream stream(path.asString().c_str());
+            if (!stream.is_open()) {
+                logger()->error("Could not open " + path.asString() + " for writing");
+                return;
+            }
+
+            Renderer::RenderProfiler::instance().writeCSV(stream);
+            logger()->info("Saved render profile to " + path.asString());
+        }
+
         void MapFrame::OnRunCompile(wxCommandEvent& event) {
             if (IsBeingDeleted()) return;
             
@@ -1644,6 +1674,13 @@ namespace TrenchBroom {
                     event.Enable(true);
                     event.Check(!m_hSplitter->isMaximized(m_vSplitter));
                     break;
+                case CommandIds::Menu::ViewToggleRenderProfiler:
+                    event.Enable(true);
+                    event.Check(Renderer::RenderProfiler::instance().enabled());
+                    break;
+                case CommandIds::Menu::ViewSaveRenderProfile:
+                    event.Enable(true);
+                    break;
                 case CommandIds::Menu::RunCompile:
                     event.Enable(canCompile());
                     break;
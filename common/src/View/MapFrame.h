@@ -216,6 +216,8 @@ namespace TrenchBroom {
             void OnViewToggleMaximizeCurrentView(wxCommandEvent& event);
             void OnViewToggleInfoPanel(wxCommandEvent& event);
             void OnViewToggleInspector(wxCommandEvent& event);
+            void OnViewToggleRenderProfiler(wxCommandEvent& event);
+            void OnViewSaveRenderProfile(wxCommandEvent& event);
 
             void OnRunCompile(wxCommandEvent& event);
         public:
@@ -851,6 +851,9 @@ namespace TrenchBroom {
         }
 
         void MapViewBase::doRender() {
+            Renderer::RenderProfiler& profiler = Renderer::RenderProfiler::instance();
+            profiler.beginFrame(m_gpuTimer);
+            
             const IO::Path& fontPath = pref(Preferences::RendererFontPath());
             const size_t fontSize = static_cast<size_t>(pref(Preferences::RendererFontSize));
             const Renderer::FontDescriptor fontDescriptor(fontPath, fontSize);
@@ -884,8 +887,10 @@ namespace TrenchBroom {
             renderCoordinateSystem(renderContext, renderBatch);
             renderPointFile(renderContext, renderBatch);
             renderCompass(renderBatch);
+            renderProfilerOverlay(renderContext, renderBatch);
             
             renderBatch.render(renderContext);
+            profiler.endFrame(m_gpuTimer);
         }
 
         void MapViewBase::setupGL(Renderer::RenderContext& context) {
@@ -923,6 +928,16 @@ namespace TrenchBroom {
                 m_compass->render(renderBatch);
         }
         
+        void MapViewBase::renderProfilerOverlay(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) {
+            const Renderer::RenderProfiler& profiler = Renderer::RenderProfiler::instance();
+            if (profiler.enabled()) {
+                Renderer::RenderService renderService(renderContext, renderBatch);
+                renderService.setForegroundColor(pref(Preferences::InfoOverlayTextColor));
+                renderService.setBackgroundColor(pref(Preferences::InfoOverlayBackgroundColor));
+                renderService.renderHeadsUp(profiler.summary());
+            }
+        }
+        
         static bool isEntity(const Model::Node* node) {
             class IsEntity : public Model::ConstNodeVisitor, public Model::NodeQuery<bool> {
             private:
@@ -23,6 +23,7 @@
 #include "Assets/EntityDefinition.h"
 #include "Model/ModelTypes.h"
 #include "Renderer/RenderContext.h"
+#include "Renderer/RenderProfiler.h"
 #include "View/ActionContext.h"
 #include "View/CameraLinkHelper.h"
 #include "View/GLAttribs.h"
@@ -75,6 +76,7 @@ namespace TrenchBroom {
         private:
             Renderer::MapRenderer& m_renderer;
             Renderer::Compass* m_compass;
+            Renderer::RenderProfiler::GPUTimer m_gpuTimer;
         protected:
             MapViewBase(wxWindow* parent, Logger* logger, MapDocumentWPtr document, MapViewToolBox& toolBox, Renderer::MapRenderer& renderer, GLContextManager& contextManager);
             
@@ -206,6 +208,7 @@ namespace TrenchBroom {
             void renderCoordinateSystem(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
             void renderPointFile(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
             void renderCompass(Renderer::RenderBatch& renderBatch);
+            void renderProfilerOverlay(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
         private: // implement ToolBoxConnector
             void doShowPopupMenu() override;
             wxMenu* makeEntityGroupsMenu(Assets::EntityDefinition::Type type, int id);
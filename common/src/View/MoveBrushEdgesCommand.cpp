@@ -19,6 +19,7 @@
 
 #include "MoveBrushEdgesCommand.h"
 
+#include "ParallelUtils.h"
 #include "Model/Brush.h"
 #include "Model/Snapshot.h"
 #include "View/MapDocument.h"
@@ -47,13 +48,11 @@ namespace TrenchBroom {
         
         bool MoveBrushEdgesCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const BBox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_edges) {
-                Model::Brush* brush = entry.first;
+            return ParallelUtils::allOf(std::begin(m_edges), std::end(m_edges), [&worldBounds, this](const auto& entry) {
+                const Model::Brush* brush = entry.first;
                 const Edge3::List& edges = entry.second;
-                if (!brush->canMoveEdges(worldBounds, edges, m_delta))
-                    return false;
-            }
-            return true;
+                return brush->canMoveEdges(worldBounds, edges, m_delta);
+            });
         }
         
         bool MoveBrushEdgesCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -20,6 +20,7 @@
 
 #include "MoveBrushFacesCommand.h"
 
+#include "ParallelUtils.h"
 #include "Model/Brush.h"
 #include "Model/Snapshot.h"
 #include "View/MapDocument.h"
@@ -48,13 +49,11 @@ namespace TrenchBroom {
         
         bool MoveBrushFacesCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const BBox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_faces) {
-                Model::Brush* brush = entry.first;
+            return ParallelUtils::allOf(std::begin(m_faces), std::end(m_faces), [&worldBounds, this](const auto& entry) {
+                const Model::Brush* brush = entry.first;
                 const Polygon3::List& faces = entry.second;
-                if (!brush->canMoveFaces(worldBounds, faces, m_delta))
-                    return false;
-            }
-            return true;
+                return brush->canMoveFaces(worldBounds, faces, m_delta);
+            });
         }
         
         bool MoveBrushFacesCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -19,6 +19,7 @@
 
 #include "MoveBrushVerticesCommand.h"
 
+#include "ParallelUtils.h"
 #include "Model/Snapshot.h"
 #include "View/MapDocument.h"
 #include "View/MapDocumentCommandFacade.h"
@@ -50,13 +51,11 @@ namespace TrenchBroom {
 
         bool MoveBrushVerticesCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const BBox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_vertices) {
-                Model::Brush* brush = entry.first;
+            return ParallelUtils::allOf(std::begin(m_vertices), std::end(m_vertices), [&worldBounds, this](const auto& entry) {
+                const Model::Brush* brush = entry.first;
                 const Vec3::List& vertices = entry.second;
-                if (!brush->canMoveVertices(worldBounds, vertices, m_delta))
-                    return false;
-            }
-            return true;
+                return brush->canMoveVertices(worldBounds, vertices, m_delta);
+            });
         }
 
         bool MoveBrushVerticesCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NodeClipboardCache.h"
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "Model/AssortNodesVisitor.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/NodeVisitor.h"
+
+#include <map>
+
+namespace TrenchBroom {
+    namespace View {
+        class NodeClipboardCache::CollectEntityBrushesStrategy {
+        public:
+            typedef std::map<Model::Entity*, Model::BrushList> EntityBrushesMap;
+        private:
+            EntityBrushesMap m_entityBrushes;
+            Model::BrushList m_worldBrushes;
+
+            class VisitParent : public Model::NodeVisitor {
+            private:
+                Model::Brush* m_brush;
+                EntityBrushesMap& m_entityBrushes;
+                Model::BrushList& m_worldBrushes;
+            public:
+                VisitParent(Model::Brush* brush, EntityBrushesMap& entityBrushes, Model::BrushList& worldBrushes) :
+                m_brush(brush),
+                m_entityBrushes(entityBrushes),
+                m_worldBrushes(worldBrushes) {}
+            private:
+                void doVisit(Model::World* world) override   { m_worldBrushes.push_back(m_brush);  }
+                void doVisit(Model::Layer* layer) override   { m_worldBrushes.push_back(m_brush);  }
+                void doVisit(Model::Group* group) override   { m_worldBrushes.push_back(m_brush);  }
+                void doVisit(Model::Entity* entity) override { m_entityBrushes[entity].push_back(m_brush); }
+                void doVisit(Model::Brush* brush) override   {}
+            };
+        public:
+            const EntityBrushesMap& entityBrushes() const {
+                return m_entityBrushes;
+            }
+
+            const Model::BrushList& worldBrushes() const {
+                return m_worldBrushes;
+            }
+
+            void addBrush(Model::Brush* brush) {
+                VisitParent visitParent(brush, m_entityBrushes, m_worldBrushes);
+                Model::Node* parent = brush->parent();
+                parent->accept(visitParent);
+            }
+        };
+
+        class NodeClipboardCache::ResetNode : public Model::NodeVisitor {
+        private:
+            void doVisit(Model::World* world) override   {}
+            void doVisit(Model::Layer* layer) override   {}
+            void doVisit(Model::Group* group) override   { resetState(group); }
+            void doVisit(Model::Entity* entity) override {
+                entity->setDefinition(nullptr);
+                resetState(entity);
+            }
+            void doVisit(Model::Brush* brush) override   {
+                for (Model::BrushFace* face : brush->faces())
+                    face->setTexture(nullptr);
+                resetState(brush);
+            }
+
+            void resetState(Model::Node* node) {
+                node->setVisiblityState(Model::Visibility_Inherited);
+                node->setLockState(Model::Lock_Inherited);
+            }
+        };
+
+        NodeClipboardCache::NodeClipboardCache() {}
+
+        NodeClipboardCache::~NodeClipboardCache() {
+            clear();
+        }
+
+        void NodeClipboardCache::store(const String& text, const Model::NodeList& nodes, const BBox3& worldBounds) {
+            typedef Model::AssortNodesVisitorT<Model::SkipLayersStrategy, Model::CollectGroupsStrategy, Model::CollectEntitiesStrategy, CollectEntityBrushesStrategy> CollectNodes;
+
+            clear();
+
+            CollectNodes collect;
+            Model::Node::accept(std::begin(nodes), std::end(nodes), collect);
+
+            // arrange the clones like the nodes that are read from the text: world brushes first, then the brush
+            // entities, groups, and point entities
+            Model::NodeList clones;
+            try {
+                const Model::BrushList& worldBrushes = collect.worldBrushes();
+                VectorUtils::append(clones, Model::Node::cloneRecursively(worldBounds, Model::NodeList(std::begin(worldBrushes), std::end(worldBrushes))));
+
+                for (const auto& entry : collect.entityBrushes()) {
+                    Model::Node* entity = entry.first->clone(worldBounds);
+                    clones.push_back(entity);
+
+                    const Model::BrushList& brushes = entry.second;
+                    entity->addChildren(Model::Node::cloneRecursively(worldBounds, Model::NodeList(std::begin(brushes), std::end(brushes))));
+                }
+
+                const Model::GroupList& groups = collect.groups();
+                const Model::EntityList& entities = collect.entities();
+                Model::NodeList groupsAndEntities(std::begin(groups), std::end(groups));
+                groupsAndEntities.insert(std::end(groupsAndEntities), std::begin(entities), std::end(entities));
+                VectorUtils::append(clones, Model::Node::cloneRecursively(worldBounds, groupsAndEntities));
+            } catch (const GeometryException&) {
+                VectorUtils::clearAndDelete(clones);
+                return;
+            }
+
+            ResetNode resetNode;
+            Model::Node::acceptAndRecurse(std::begin(clones), std::end(clones), resetNode);
+
+            m_text = text;
+            m_nodes = clones;
+        }
+
+        void NodeClipboardCache::clear() {
+            m_text.clear();
+            VectorUtils::clearAndDelete(m_nodes);
+        }
+
+        bool NodeClipboardCache::contains(const String& text) const {
+            return !m_nodes.empty() && m_text == text;
+        }
+
+        Model::NodeList NodeClipboardCache::cloneNodes(const BBox3& worldBounds) const {
+            return Model::Node::cloneRecursively(worldBounds, m_nodes);
+        }
+    }
+}
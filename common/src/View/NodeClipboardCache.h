@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_NodeClipboardCache
+#define TrenchBroom_NodeClipboardCache
+
+#include "StringUtils.h"
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Model/ModelTypes.h"
+
+namespace TrenchBroom {
+    namespace View {
+        /**
+         * Keeps clones of the nodes that were last copied to the clipboard together with their textual form. If the
+         * same text is pasted again, the nodes can be cloned instead of parsing the text and rebuilding the brush
+         * geometry.
+         *
+         * The cached nodes are arranged in the same way as the nodes that are read back from the textual form. They
+         * do not reference any textures or entity definitions, because these are owned by the document and may be
+         * reloaded before the nodes are pasted.
+         */
+        class NodeClipboardCache {
+        private:
+            class CollectEntityBrushesStrategy;
+            class ResetNode;
+
+            String m_text;
+            Model::NodeList m_nodes;
+        public:
+            NodeClipboardCache();
+            ~NodeClipboardCache();
+
+            /**
+             * Replaces the cached nodes with clones of the given nodes. If the nodes cannot be cloned, the cache
+             * remains empty.
+             */
+            void store(const String& text, const Model::NodeList& nodes, const BBox3& worldBounds);
+            void clear();
+
+            bool contains(const String& text) const;
+
+            /**
+             * Returns new clones of the cached nodes, which are owned by the caller.
+             *
+             * @throw GeometryException if a brush cannot be cloned within the given world bounds
+             */
+            Model::NodeList cloneNodes(const BBox3& worldBounds) const;
+        private:
+            NodeClipboardCache(const NodeClipboardCache& other);
+            NodeClipboardCache& operator=(const NodeClipboardCache& other);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_NodeClipboardCache) */
@@ -19,6 +19,7 @@
 
 #include "RemoveBrushElementsCommand.h"
 
+#include "ParallelUtils.h"
 #include "Model/Brush.h"
 #include "Model/Snapshot.h"
 #include "View/MapDocument.h"
@@ -32,13 +33,11 @@ namespace TrenchBroom {
 
         bool RemoveBrushElementsCommand::doCanDoVertexOperation(const MapDocument* document) const {
             const BBox3& worldBounds = document->worldBounds();
-            for (const auto& entry : m_vertices) {
-                Model::Brush* brush = entry.first;
+            return ParallelUtils::allOf(std::begin(m_vertices), std::end(m_vertices), [&worldBounds](const auto& entry) {
+                const Model::Brush* brush = entry.first;
                 const Vec3::List& vertices = entry.second;
-                if (!brush->canRemoveVertices(worldBounds, vertices))
-                    return false;
-            }
-            return true;
+                return brush->canRemoveVertices(worldBounds, vertices);
+            });
         }
 
         bool RemoveBrushElementsCommand::doVertexOperation(MapDocumentCommandFacade* document) {
@@ -30,15 +30,15 @@ namespace TrenchBroom {
         const Model::Hit::HitType VertexHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void VertexHandleManager::pick(const Ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const Vec3& position = entry.first;
-                const FloatType distance = camera.pickPointHandle(pickRay, position, pref(Preferences::HandleRadius));
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            findHandles(pickRay, camera, handleRadius, [&](const Vec3& position) {
+                const FloatType distance = camera.pickPointHandle(pickRay, position, handleRadius);
                 if (!Math::isnan(distance)) {
                     const Vec3 hitPoint = pickRay.pointAtDistance(distance);
                     const FloatType error = pickRay.squaredDistanceToPoint(position).distance;
                     pickResult.addHit(Model::Hit::hit(HandleHit, distance, hitPoint, position, error));
                 }
-            }
+            });
         }
         
         void VertexHandleManager::addHandles(const Model::Brush* brush) {
@@ -64,31 +64,31 @@ namespace TrenchBroom {
         const Model::Hit::HitType EdgeHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void EdgeHandleManager::pickGridHandle(const Ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const Edge3& position = entry.first;
-                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, pref(Preferences::HandleRadius));
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            findHandles(pickRay, camera, handleRadius, [&](const Edge3& position) {
+                const FloatType edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius);
                 if (!Math::isnan(edgeDist)) {
                     const Vec3 pointHandle = grid.snap(pickRay.pointAtDistance(edgeDist), position);
-                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!Math::isnan(pointDist)) {
                         const Vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::pickCenterHandle(const Ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const Edge3& position = entry.first;
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            findHandles(pickRay, camera, handleRadius, [&](const Edge3& position) {
                 const Vec3 pointHandle = position.center();
 
-                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!Math::isnan(pointDist)) {
                     const Vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
         void EdgeHandleManager::addHandles(const Model::Brush* brush) {
@@ -114,37 +114,36 @@ namespace TrenchBroom {
         const Model::Hit::HitType FaceHandleManager::HandleHit = Model::Hit::freeHitType();
 
         void FaceHandleManager::pickGridHandle(const Ray3& pickRay, const Renderer::Camera& camera, const Grid& grid, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const Polygon3& position = entry.first;
-                
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            findHandles(pickRay, camera, handleRadius, [&](const Polygon3& position) {
                 Plane3 plane;
                 if (!getPlane(std::begin(position), std::end(position), plane))
-                    continue;
+                    return;
                 
                 const FloatType distance = intersectPolygonWithRay(pickRay, plane, std::begin(position), std::end(position));
                 if (!Math::isnan(distance)) {
                     const Vec3 pointHandle = grid.snap(pickRay.pointAtDistance(distance), plane);
                     
-                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                    const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                     if (!Math::isnan(pointDist)) {
                         const Vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                         pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, HitType(position, pointHandle)));
                     }
                 }
-            }
+            });
         }
 
         void FaceHandleManager::pickCenterHandle(const Ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
-            for (const HandleEntry& entry : m_handles) {
-                const Polygon3& position = entry.first;
+            const FloatType handleRadius = pref(Preferences::HandleRadius);
+            findHandles(pickRay, camera, handleRadius, [&](const Polygon3& position) {
                 const Vec3 pointHandle = position.center();
 
-                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, pref(Preferences::HandleRadius));
+                const FloatType pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius);
                 if (!Math::isnan(pointDist)) {
                     const Vec3 hitPoint = pickRay.pointAtDistance(pointDist);
                     pickResult.addHit(Model::Hit::hit(HandleHit, pointDist, hitPoint, position));
                 }
-            }
+            });
         }
 
         void FaceHandleManager::addHandles(const Model::Brush* brush) {
@@ -27,11 +27,12 @@
 #include "Model/Hit.h"
 #include "Model/PickResult.h"
 #include "Renderer/Camera.h"
+#include "View/HandleIndex.h"
+#include "View/HandleMap.h"
 #include "View/ViewTypes.h"
 
 #include <algorithm>
 #include <iterator>
-#include <map>
 
 namespace TrenchBroom {
     namespace Model {
@@ -65,24 +66,6 @@ namespace TrenchBroom {
             virtual void removeHandles(const Model::Brush* brush) = 0;
         };
 
-        template <typename H>
-        class HCmp {
-        public:
-            bool operator()(const H& lhs, const H& rhs) const {
-                return lhs.compare(rhs, 0.1) < 0;
-            }
-        };
-
-        /*
-        template <>
-        class HCmp<Polygon3> {
-        public:
-            bool operator()(const Polygon3& lhs, const Polygon3& rhs) const {
-                return lhs.compareUnoriented(rhs, 0.1) < 0;
-            }
-        };
-        */
-
         template <typename H>
         class VertexHandleManagerBaseT : public VertexHandleManagerBase {
         public:
@@ -124,10 +107,11 @@ namespace TrenchBroom {
                 }
             };
             
-            typedef std::map<H, HandleInfo, HCmp<H>> HandleMap;
-            typedef typename HandleMap::value_type HandleEntry;
+            typedef HandleMap<H, HandleInfo> HandleInfoMap;
+            typedef typename HandleInfoMap::Entry HandleEntry;
 
-            HandleMap m_handles;
+            HandleInfoMap m_handles;
+            HandleIndex<H> m_index;
             size_t m_selectedHandleCount;
         public:
             VertexHandleManagerBaseT() :
@@ -173,23 +157,30 @@ namespace TrenchBroom {
         private:
             template <typename T, typename O>
             void collectHandles(const T& test, O out) const {
-                for (const HandleEntry& entry : m_handles) {
-                    const Handle& handle = entry.first;
-                    const HandleInfo& info = entry.second;
-                    if (test(info))
-                        out = handle;
-                }
+                m_handles.forEach([&test, &out](const HandleEntry& entry) {
+                    if (test(entry.value))
+                        out = entry.handle;
+                });
             }
         public:
+            /**
+             * Returns every handle whose bounds intersect the given bounds.
+             */
+            HandleList findHandles(const BBox3& bounds) const {
+                HandleList result;
+                m_index.findHandles(bounds, std::back_inserter(result));
+                return result;
+            }
+
             bool contains(const Handle& handle) const {
-                return m_handles.count(handle) > 0;
+                return m_handles.find(handle) != nullptr;
             }
 
             bool selected(const Handle& handle) const {
-                const auto it = m_handles.find(handle);
-                if (it == std::end(m_handles))
+                const HandleEntry* entry = m_handles.find(handle);
+                if (entry == nullptr)
                     return false;
-                return it->second.selected;
+                return entry->value.selected;
             }
             
             bool anySelected() const {
@@ -201,24 +192,29 @@ namespace TrenchBroom {
             }
         public:
             void add(const Handle& handle) {
-                MapUtils::findOrInsert(m_handles, handle, HandleInfo())->second.inc();
+                HandleEntry& entry = m_handles.findOrInsert(handle, HandleInfo());
+                if (entry.value.count == 0)
+                    m_index.insert(entry.handle);
+                entry.value.inc();
             }
             
             void remove(const Handle& handle) {
-                const auto it = m_handles.find(handle);
-                if (it != std::end(m_handles)) {
-                    HandleInfo& info = it->second;
+                HandleEntry* entry = m_handles.find(handle);
+                if (entry != nullptr) {
+                    HandleInfo& info = entry->value;
                     info.dec();
                     
                     if (info.count == 0) {
                         deselect(info);
-                        m_handles.erase(it);
+                        m_index.remove(entry->handle);
+                        m_handles.erase(entry->handle);
                     }
                 }
             }
 
             void clear() {
                 m_handles.clear();
+                m_index.clear();
                 m_selectedHandleCount = 0;
             }
 
@@ -228,9 +224,9 @@ namespace TrenchBroom {
             }
             
             void select(const Handle& handle) {
-                const auto it = m_handles.find(handle);
-                if (it != std::end(m_handles)) {
-                    select(it->second);
+                HandleEntry* entry = m_handles.find(handle);
+                if (entry != nullptr) {
+                    select(entry->value);
                 }
             }
             
@@ -240,15 +236,15 @@ namespace TrenchBroom {
             }
             
             void deselect(const Handle& handle) {
-                const auto it = m_handles.find(handle);
-                if (it != std::end(m_handles)) {
-                    deselect(it->second);
+                HandleEntry* entry = m_handles.find(handle);
+                if (entry != nullptr) {
+                    deselect(entry->value);
                 }
             }
             
             void deselectAll() {
-                std::for_each(std::begin(m_handles), std::end(m_handles), [this](HandleEntry& entry) {
-                    deselect(entry.second);
+                m_handles.forEach([this](HandleEntry& entry) {
+                    deselect(entry.value);
                 });
             }
             
@@ -258,9 +254,9 @@ namespace TrenchBroom {
             }
             
             void toggle(const Handle& handle) {
-                const auto it = m_handles.find(handle);
-                if (it != std::end(m_handles)) {
-                    toggle(it->second);
+                HandleEntry* entry = m_handles.find(handle);
+                if (entry != nullptr) {
+                    toggle(entry->value);
                 }
             }
         private:
@@ -290,12 +286,29 @@ namespace TrenchBroom {
         public:
             template <typename P>
             void pick(const P& test, Model::PickResult& pickResult) const {
-                std::for_each(std::begin(m_handles), std::end(m_handles), [&test, &pickResult](const HandleEntry& entry) {
-                    const Model::Hit hit = test(entry.first);
+                m_handles.forEach([&test, &pickResult](const HandleEntry& entry) {
+                    const Model::Hit hit = test(entry.handle);
                     if (hit.isMatch())
                         pickResult.addHit(hit);
                 });
             }
+        protected:
+            /**
+             * Calls the given function for every handle that could be hit by a point handle pick with the given ray
+             * and handle radius. Since the pick radius grows with the distance to a perspective camera, the radius
+             * used for a cell is the largest pick radius at any of the corners of its bounds.
+             */
+            template <typename F>
+            void findHandles(const Ray3& pickRay, const Renderer::Camera& camera, const FloatType handleRadius, F func) const {
+                m_index.findHandles(pickRay, [&camera, handleRadius](const BBox3& bounds) {
+                    FloatType scaling = 0.0;
+                    auto maxScaling = [&camera, &scaling](const Vec3& corner) {
+                        scaling = std::max(scaling, std::abs(static_cast<FloatType>(camera.perspectiveScalingFactor(Vec3f(corner)))));
+                    };
+                    eachBBoxVertex(bounds, maxScaling);
+                    return 2.0 * handleRadius * scaling;
+                }, func);
+            }
         public:
             template <typename I>
             Model::BrushSet findIncidentBrushes(const Handle& handle, I begin, I end) const {
@@ -157,10 +157,12 @@ namespace TrenchBroom {
             void select(const Lasso& lasso, const bool modifySelection) {
                 typedef std::vector<H> HandleList;
                 
-                const HandleList allHandles = handleManager().allHandles();
+                // Only the handles within the bounds of the volume selected by the lasso need to be tested.
+                MapDocumentSPtr document = lock(m_document);
+                const HandleList candidates = handleManager().findHandles(lasso.bounds(document->worldBounds()));
                 HandleList selectedHandles;
                 
-                lasso.selected(std::begin(allHandles), std::end(allHandles), std::back_inserter(selectedHandles));
+                lasso.selected(std::begin(candidates), std::end(candidates), std::back_inserter(selectedHandles));
                 if (!modifySelection)
                     handleManager().deselectAll();
                 handleManager().toggle(std::begin(selectedHandles), std::end(selectedHandles));
@@ -87,6 +87,7 @@ namespace TrenchBroom {
         
         glDrawArrays.bindMemFunc(this, &GLMock::DrawArrays);
         glMultiDrawArrays.bindMemFunc(this, &GLMock::MultiDrawArrays);
+        glDrawElements.bindMemFunc(this, &GLMock::DrawElements);
         
         glCreateShader.bindMemFunc(this, &GLMock::CreateShader);
         glDeleteShader.bindMemFunc(this, &GLMock::DeleteShader);
@@ -142,6 +143,11 @@ namespace TrenchBroom {
         
         glGetUniformLocation.bindMemFunc(this, &GLMock::GetUniformLocation);
         
+        glGenQueries.bindMemFunc(this, &GLMock::GenQueries);
+        glBeginQuery.bindMemFunc(this, &GLMock::BeginQuery);
+        glEndQuery.bindMemFunc(this, &GLMock::EndQuery);
+        glGetQueryObjectuiv.bindMemFunc(this, &GLMock::GetQueryObjectuiv);
+        
 #ifdef __APPLE__
         glFinishObjectAPPLE.bindMemFunc(this, &GLMock::FinishObjectAPPLE);
 #endif
@@ -94,6 +94,7 @@ namespace TrenchBroom {
         
         MOCK_METHOD3(DrawArrays, void(GLenum, GLint, GLsizei));
         MOCK_METHOD4(MultiDrawArrays, void(GLenum, const GLint*, const GLsizei*, GLsizei));
+        MOCK_METHOD4(DrawElements, void(GLenum, GLsizei, GLenum, const GLvoid*));
         
         MOCK_METHOD1(CreateShader, GLuint(GLenum));
         MOCK_METHOD1(DeleteShader, void(GLuint));
@@ -149,6 +150,11 @@ namespace TrenchBroom {
         
         MOCK_METHOD2(GetUniformLocation, GLint(GLuint, const GLchar*));
         
+        MOCK_METHOD2(GenQueries, void(GLsizei, GLuint*));
+        MOCK_METHOD2(BeginQuery, void(GLenum, GLuint));
+        MOCK_METHOD1(EndQuery, void(GLenum));
+        MOCK_METHOD3(GetQueryObjectuiv, void(GLuint, GLenum, GLuint*));
+        
 #ifdef __APPLE__
         void FinishObjectAPPLE(GLenum, GLint) {}
 #endif
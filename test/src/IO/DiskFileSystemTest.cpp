@@ -145,6 +145,28 @@ namespace TrenchBroom {
             ASSERT_TRUE(std::find(std::begin(contents), std::end(contents), Path("test2.map")) != std::end(contents));
         }
         
+        TEST(DiskTest, getDirectoryContentsAfterChanges) {
+            TestEnvironment env;
+            
+            ASSERT_EQ(5u, Disk::getDirectoryContents(env.dir()).size());
+            
+            Disk::createFile(env.dir() + Path("created.txt"), "some content");
+            ASSERT_EQ(6u, Disk::getDirectoryContents(env.dir()).size());
+            ASSERT_TRUE(Disk::fileExists(env.dir() + Path("CREATED.TXT")));
+            
+            Disk::deleteFile(env.dir() + Path("created.txt"));
+            ASSERT_EQ(5u, Disk::getDirectoryContents(env.dir()).size());
+            ASSERT_FALSE(Disk::fileExists(env.dir() + Path("CREATED.TXT")));
+            
+            wxFile file;
+            ASSERT_TRUE(file.Create((env.dir() + Path("external.txt")).asString()));
+            file.Close();
+            
+            Disk::refreshDirectoryCache();
+            ASSERT_EQ(6u, Disk::getDirectoryContents(env.dir()).size());
+            ASSERT_TRUE(Disk::fileExists(env.dir() + Path("EXTERNAL.txt")));
+        }
+        
         TEST(DiskTest, openFile) {
             TestEnvironment env;
             
@@ -22,10 +22,13 @@
 #include "IO/DiskFileSystem.h"
 #include "IO/FileMatcher.h"
 #include "IO/DkPakFileSystem.h"
+#include "IO/IdPakFileSystem.h"
 #include "IO/MappedFile.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -148,6 +151,124 @@ namespace TrenchBroom {
             ASSERT_THROW(fs.openFile(Path("/textures")), FileSystemException);
             
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != nullptr);
+            
+            const Path idPakPath = Disk::getCurrentWorkingDir() + Path("data/IO/Pak/pak1.pak");
+            const MappedFile::Ptr idPakFile = Disk::openFile(idPakPath);
+            assert(idPakFile != nullptr);
+            
+            const IdPakFileSystem idFs(idPakPath, idPakFile);
+            const MappedFile::Ptr expected = idFs.openFile(Path("amnet.cfg"));
+            const MappedFile::Ptr actual = fs.openFile(Path("amnet.cfg"));
+            ASSERT_EQ(expected->size(), actual->size());
+            ASSERT_TRUE(std::equal(expected->begin(), expected->end(), actual->begin()));
+        }
+        
+        static String decompress(const std::vector<unsigned char>& data, const size_t size) {
+            String result(size, 'x');
+            DkPakFileSystem::decompress(reinterpret_cast<const char*>(data.data()), reinterpret_cast<const char*>(data.data() + data.size()), &result[0], size);
+            return result;
+        }
+        
+        TEST(DkPakFileSystemTest, decompress) {
+            // literal "abc", two zeros, "x" repeated twice, two bytes copied from 7 bytes back
+            ASSERT_EQ(String("abc\0\0xxab", 9), decompress({ 0x02, 'a', 'b', 'c', 0x40, 0x80, 'x', 0xC0, 0x05, 0xFF }, 9));
+            
+            // overlapping back reference repeats the copied bytes
+            ASSERT_EQ(String("ababa"), decompress({ 0x01, 'a', 'b', 0xC1, 0x00, 0xFF }, 5));
+            
+            // the remainder is filled with zeros
+            ASSERT_EQ(String("ab\0\0", 4), decompress({ 0x01, 'a', 'b', 0xFF }, 4));
+            
+            ASSERT_THROW(decompress({ 0x01, 'a', 'b' }, 1), FileSystemException);
+            ASSERT_THROW(decompress({ 0x02, 'a', 'b' }, 3), FileSystemException);
+            ASSERT_THROW(decompress({ 0x01, 'a', 'b', 0xC0, 0x01 }, 4), FileSystemException);
+        }
+        
+        static void writeInt(std::vector<char>& data, const size_t value) {
+            const int32_t i = static_cast<int32_t>(value);
+            const char* bytes = reinterpret_cast<const char*>(&i);
+            data.insert(std::end(data), bytes, bytes + sizeof(i));
+        }
+        
+        struct PakEntry {
+            String name;
+            std::vector<char> data;
+            size_t uncompressedSize;
+            size_t compressedSize;
+            bool compressed;
+        };
+        
+        static MappedFile::Ptr createPak(const Path& path, const std::vector<PakEntry>& entries) {
+            std::vector<char> data = { 'P', 'A', 'C', 'K' };
+            
+            size_t directoryAddress = 12;
+            for (const PakEntry& entry : entries)
+                directoryAddress += entry.data.size();
+            writeInt(data, directoryAddress);
+            writeInt(data, 0x48 * entries.size());
+            
+            for (const PakEntry& entry : entries)
+                data.insert(std::end(data), std::begin(entry.data), std::end(entry.data));
+            
+            size_t entryAddress = 12;
+            for (const PakEntry& entry : entries) {
+                const size_t nameOffset = data.size();
+                data.resize(nameOffset + 0x38, 0);
+                std::copy(std::begin(entry.name), std::end(entry.name), std::begin(data) + static_cast<std::ptrdiff_t>(nameOffset));
+                writeInt(data, entryAddress);
+                writeInt(data, entry.uncompressedSize);
+                writeInt(data, entry.compressedSize);
+                writeInt(data, entry.compressed ? 1 : 0);
+                entryAddress += entry.data.size();
+            }
+            
+            char* buffer = new char[data.size()];
+            std::copy(std::begin(data), std::end(data), buffer);
+            return MappedFile::Ptr(new MappedFileBuffer(path, buffer, data.size()));
+        }
+        
+        static MappedFile::Ptr createCompressedPak(const Path& path) {
+            // a single compressed entry that decompresses to "hello" followed by five zeros
+            const std::vector<char> entry = { 0x04, 'h', 'e', 'l', 'l', 'o', 0x43, static_cast<char>(0xFF) };
+            return createPak(path, { PakEntry { "compressed.txt", entry, 10, entry.size(), true } });
+        }
+        
+        TEST(DkPakFileSystemTest, openCompressedFile) {
+            const Path pakPath("/compressed.pak");
+            const DkPakFileSystem fs(pakPath, createCompressedPak(pakPath));
+            
+            const MappedFile::Ptr file = fs.openFile(Path("compressed.txt"));
+            ASSERT_EQ(String("hello\0\0\0\0\0", 10), String(file->begin(), file->end()));
+            
+            // opening the entry again returns the cached decompressed file
+            ASSERT_EQ(file, fs.openFile(Path("compressed.txt")));
+        }
+        
+        TEST(DkPakFileSystemTest, decompressedFileCacheCapacity) {
+            const Path pakPath("/compressed.pak");
+            const DkPakFileSystem fs(pakPath, createCompressedPak(pakPath), 5);
+            
+            const MappedFile::Ptr file = fs.openFile(Path("compressed.txt"));
+            ASSERT_EQ(10u, file->size());
+            ASSERT_NE(file, fs.openFile(Path("compressed.txt")));
+        }
+        
+        TEST(DkPakFileSystemTest, openStoredFile) {
+            // the compressed size of a stored entry is meaningless and must not determine its size
+            const std::vector<char> stored = { 's', 't', 'o', 'r', 'e', 'd' };
+            const std::vector<char> other = { 'o', 't', 'h', 'e', 'r' };
+            
+            const Path pakPath("/stored.pak");
+            const DkPakFileSystem fs(pakPath, createPak(pakPath, {
+                PakEntry { "stored.txt", stored, stored.size(), 2, false },
+                PakEntry { "other.txt", other, other.size(), 0, false }
+            }));
+            
+            const MappedFile::Ptr storedFile = fs.openFile(Path("stored.txt"));
+            ASSERT_EQ(String("stored"), String(storedFile->begin(), storedFile->end()));
+            
+            const MappedFile::Ptr otherFile = fs.openFile(Path("other.txt"));
+            ASSERT_EQ(String("other"), String(otherFile->begin(), otherFile->end()));
         }
     }
 }
@@ -255,6 +255,7 @@ namespace TrenchBroom {
             ASSERT_EL_EQ("fdsa", "{{'fdsa', 'asdf'}}");
             ASSERT_EL_EQ("asdf", "{{false -> 'fdsa', 'asdf'}}");
             ASSERT_EL_EQ(EL::Value::Undefined, "{{false -> false}}");
+            ASSERT_EL_EQ("asdf", "{{ {{false -> 'fdsa'}}, {{'asdf'}} }}");
         }
         
         TEST(ELParserTest, testComparisonOperators) {
@@ -0,0 +1,315 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "Assets/AttributeDefinition.h"
+#include "Assets/EntityDefinition.h"
+#include "Assets/ModelDefinition.h"
+#include "EL/Expression.h"
+#include "IO/DiskIO.h"
+#include "IO/EntityDefinitionCache.h"
+#include "IO/FgdParser.h"
+#include "IO/MappedFile.h"
+#include "IO/Path.h"
+#include "IO/TestParserStatus.h"
+
+#include <algorithm>
+
+#include <wx/filefn.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        static MappedFile::Ptr createFile(const String& contents, const Path& path = Path("test.bin")) {
+            char* buffer = new char[contents.size()];
+            std::copy(std::begin(contents), std::end(contents), buffer);
+            return MappedFile::Ptr(new MappedFileBuffer(path, buffer, contents.size()));
+        }
+
+        class CacheDirectory {
+        private:
+            Path m_path;
+        public:
+            CacheDirectory() :
+            m_path(Disk::getCurrentWorkingDir() + Path("entitydefinitioncachetest")) {
+                remove();
+            }
+
+            ~CacheDirectory() {
+                remove();
+            }
+
+            const Path& path() const {
+                return m_path;
+            }
+
+            Path::List files() const {
+                if (!Disk::directoryExists(m_path))
+                    return Path::List();
+                return Disk::findItems(m_path);
+            }
+        private:
+            void remove() {
+                if (Disk::directoryExists(m_path)) {
+                    Disk::deleteFiles(m_path, [](const Path& path, const bool directory) { return !directory; });
+                    ::wxRmdir(m_path.asString());
+                }
+            }
+        };
+
+        static Assets::EntityDefinitionList parse(const MappedFile::Ptr& file, const Color& defaultColor) {
+            FgdParser parser(file, defaultColor);
+            TestParserStatus status;
+            return parser.parseDefinitions(status);
+        }
+
+        static Assets::EntityDefinitionList roundTrip(const Assets::EntityDefinitionList& definitions) {
+            const String serialized = EntityDefinitionCache::serialize(1u, Path("test.fgd"), Color(), definitions);
+            return EntityDefinitionCache::deserialize(1u, createFile(serialized));
+        }
+
+        static void assertEqualDefinitions(const Assets::EntityDefinitionList& expected, const Assets::EntityDefinitionList& actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                const Assets::EntityDefinition* expectedDefinition = expected[i];
+                const Assets::EntityDefinition* actualDefinition = actual[i];
+
+                ASSERT_EQ(expectedDefinition->type(), actualDefinition->type());
+                ASSERT_EQ(expectedDefinition->name(), actualDefinition->name());
+                ASSERT_EQ(expectedDefinition->color(), actualDefinition->color());
+                ASSERT_EQ(expectedDefinition->description(), actualDefinition->description());
+
+                if (expectedDefinition->type() == Assets::EntityDefinition::Type_PointEntity) {
+                    const Assets::PointEntityDefinition* expectedPointDefinition = static_cast<const Assets::PointEntityDefinition*>(expectedDefinition);
+                    const Assets::PointEntityDefinition* actualPointDefinition = static_cast<const Assets::PointEntityDefinition*>(actualDefinition);
+                    ASSERT_EQ(expectedPointDefinition->bounds(), actualPointDefinition->bounds());
+                    ASSERT_EQ(expectedPointDefinition->modelDefinition().expression().asString(), actualPointDefinition->modelDefinition().expression().asString());
+                }
+
+                const Assets::AttributeDefinitionList& expectedAttributes = expectedDefinition->attributeDefinitions();
+                const Assets::AttributeDefinitionList& actualAttributes = actualDefinition->attributeDefinitions();
+                ASSERT_EQ(expectedAttributes.size(), actualAttributes.size());
+                for (size_t j = 0; j < expectedAttributes.size(); ++j) {
+                    ASSERT_TRUE(expectedAttributes[j]->equals(actualAttributes[j].get()));
+                    ASSERT_EQ(expectedAttributes[j]->shortDescription(), actualAttributes[j]->shortDescription());
+                    ASSERT_EQ(expectedAttributes[j]->longDescription(), actualAttributes[j]->longDescription());
+                    ASSERT_EQ(Assets::AttributeDefinition::defaultValue(*expectedAttributes[j]), Assets::AttributeDefinition::defaultValue(*actualAttributes[j]));
+                }
+            }
+        }
+
+        TEST(EntityDefinitionCacheTest, serializeIncludedFgdFiles) {
+            const Path basePath = Disk::getCurrentWorkingDir() + Path("data/GameConfig");
+            const Path::List fgdFiles = Disk::findItems(basePath, [] (const Path& path, bool directory) {
+                return !directory && StringUtils::caseInsensitiveEqual(path.extension(), "fgd");
+            });
+            ASSERT_FALSE(fgdFiles.empty());
+
+            for (const Path& path : fgdFiles) {
+                MappedFile::Ptr file = Disk::openFile(path);
+                const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+                FgdParser parser(file, defaultColor);
+
+                TestParserStatus status;
+                Assets::EntityDefinitionList definitions = parser.parseDefinitions(status);
+                Assets::EntityDefinitionList cached = roundTrip(definitions);
+
+                assertEqualDefinitions(definitions, cached);
+
+                VectorUtils::clearAndDelete(definitions);
+                VectorUtils::clearAndDelete(cached);
+            }
+        }
+
+        TEST(EntityDefinitionCacheTest, serializeAttributes) {
+            const String file =
+            "@PointClass size(-16 -16 -24, 16 16 32) color(0 255 0) model({ \"path\": \"progs/player.mdl\", \"skin\": 1 }) = info_player_start : \"Player start\"\n"
+            "[\n"
+            "    targetname(target_source) : \"Name\"\n"
+            "    target(target_destination) : \"Target\"\n"
+            "    message(string) : \"Message\" : \"Hello\" : \"Long description\"\n"
+            "    count(integer) : \"Count\" : 3\n"
+            "    delay(float) : \"Delay\" : \"0.5\"\n"
+            "    style(choices) : \"Style\" : 1 =\n"
+            "    [\n"
+            "        0 : \"Normal\"\n"
+            "        1 : \"Flicker\"\n"
+            "    ]\n"
+            "    spawnflags(flags) =\n"
+            "    [\n"
+            "        1 : \"Suspended\" : 1\n"
+            "        4 : \"Silent\" : 0\n"
+            "    ]\n"
+            "    other(something) : \"Other\"\n"
+            "]\n"
+            "@SolidClass = func_wall : \"Wall\" []\n";
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+
+            TestParserStatus status;
+            Assets::EntityDefinitionList definitions = parser.parseDefinitions(status);
+            ASSERT_EQ(2u, definitions.size());
+
+            Assets::EntityDefinitionList cached = roundTrip(definitions);
+            assertEqualDefinitions(definitions, cached);
+
+            const Assets::EntityDefinition* definition = cached[0];
+            ASSERT_EQ(8u, definition->attributeDefinitions().size());
+
+            const Assets::FlagsAttributeDefinition* spawnflags = definition->spawnflags();
+            ASSERT_TRUE(spawnflags != nullptr);
+            ASSERT_EQ(1, spawnflags->defaultValue());
+            ASSERT_EQ(2u, spawnflags->options().size());
+            ASSERT_EQ("Silent", spawnflags->option(4)->shortDescription());
+
+            const Assets::ChoiceAttributeDefinition* style = static_cast<const Assets::ChoiceAttributeDefinition*>(definition->attributeDefinition("style"));
+            ASSERT_EQ(Assets::AttributeDefinition::Type_ChoiceAttribute, style->type());
+            ASSERT_EQ(1u, style->defaultValue());
+            ASSERT_EQ("Flicker", style->options()[1].description());
+
+            const Assets::AttributeDefinition* other = definition->attributeDefinition("other");
+            ASSERT_TRUE(dynamic_cast<const Assets::UnknownAttributeDefinition*>(other) != nullptr);
+
+            VectorUtils::clearAndDelete(definitions);
+            VectorUtils::clearAndDelete(cached);
+        }
+
+        TEST(EntityDefinitionCacheTest, deserializeInvalidFile) {
+            const String file = "@PointClass = info_notnull : \"Notnull\" [ noise(string) : \"noise\" ]\n";
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+
+            TestParserStatus status;
+            Assets::EntityDefinitionList definitions = parser.parseDefinitions(status);
+            const String serialized = EntityDefinitionCache::serialize(1u, Path("test.fgd"), defaultColor, definitions);
+            VectorUtils::clearAndDelete(definitions);
+
+            ASSERT_THROW(EntityDefinitionCache::deserialize(2u, createFile(serialized)), FileFormatException);
+            ASSERT_THROW(EntityDefinitionCache::deserialize(1u, createFile(serialized.substr(0, serialized.size() - 1))), FileFormatException);
+            ASSERT_THROW(EntityDefinitionCache::deserialize(1u, createFile("@PointClass = info_notnull []")), FileFormatException);
+            ASSERT_THROW(EntityDefinitionCache::deserialize(1u, createFile("")), FileFormatException);
+        }
+
+        TEST(EntityDefinitionCacheTest, key) {
+            const String contents = "@PointClass = info_notnull []";
+            const MappedFile::Ptr file = createFile(contents);
+            const MappedFile::Ptr sameFile = createFile(contents);
+            const MappedFile::Ptr otherFile = createFile(contents + "\n");
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            const Color otherColor(1.0f, 0.0f, 1.0f, 1.0f);
+
+            ASSERT_EQ(EntityDefinitionCache::key(*file, defaultColor), EntityDefinitionCache::key(*sameFile, defaultColor));
+            ASSERT_NE(EntityDefinitionCache::key(*file, defaultColor), EntityDefinitionCache::key(*otherFile, defaultColor));
+            ASSERT_NE(EntityDefinitionCache::key(*file, defaultColor), EntityDefinitionCache::key(*file, otherColor));
+        }
+
+        TEST(EntityDefinitionCacheTest, storeAndLoad) {
+            const CacheDirectory directory;
+            const EntityDefinitionCache cache(directory.path());
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            const MappedFile::Ptr file = createFile("@PointClass = info_notnull : \"Notnull\" [ noise(string) : \"noise\" ]\n", Path("defs/test.fgd"));
+
+            Assets::EntityDefinitionList loaded;
+            ASSERT_FALSE(cache.load(*file, defaultColor, loaded));
+
+            Assets::EntityDefinitionList definitions = parse(file, defaultColor);
+            cache.store(*file, defaultColor, definitions);
+
+            // the cache file is named after its format version, and no temporary files are left behind
+            const Path::List files = directory.files();
+            ASSERT_EQ(1u, files.size());
+            ASSERT_TRUE(StringUtils::caseSensitiveSuffix(files.front().lastComponent().asString(), "-v2.bin"));
+
+            ASSERT_TRUE(cache.load(*file, defaultColor, loaded));
+            assertEqualDefinitions(definitions, loaded);
+
+            VectorUtils::clearAndDelete(definitions);
+            VectorUtils::clearAndDelete(loaded);
+        }
+
+        TEST(EntityDefinitionCacheTest, storeKeepsLoadedDefinitionsValid) {
+            const CacheDirectory directory;
+            const EntityDefinitionCache cache(directory.path());
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            const MappedFile::Ptr file = createFile("@PointClass = info_notnull : \"Notnull\" [ noise(string) : \"noise\" message(string) : \"message\" ]\n", Path("defs/test.fgd"));
+
+            Assets::EntityDefinitionList definitions = parse(file, defaultColor);
+            cache.store(*file, defaultColor, definitions);
+
+            // the attributes of these definitions are read from a mapping of the cache file when they are requested
+            Assets::EntityDefinitionList loaded;
+            ASSERT_TRUE(cache.load(*file, defaultColor, loaded));
+
+            // storing the same file again replaces the cache file instead of truncating the mapped file
+            cache.store(*file, defaultColor, definitions);
+            ASSERT_EQ(1u, directory.files().size());
+
+            assertEqualDefinitions(definitions, loaded);
+
+            VectorUtils::clearAndDelete(definitions);
+            VectorUtils::clearAndDelete(loaded);
+        }
+
+        TEST(EntityDefinitionCacheTest, storeEvictsOrphans) {
+            const CacheDirectory directory;
+            const EntityDefinitionCache cache(directory.path());
+
+            // a cache file of the first format version, which had no version in its name
+            Disk::createFile(directory.path() + Path("0123456789abcdef.bin"), "TBED");
+
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            const Color otherColor(1.0f, 0.0f, 0.0f, 1.0f);
+            const MappedFile::Ptr oldFile = createFile("@PointClass = info_notnull : \"Notnull\" []\n", Path("defs/test.fgd"));
+            const MappedFile::Ptr newFile = createFile("@PointClass = info_notnull : \"Notnull\" [ noise(string) : \"noise\" ]\n", Path("defs/test.fgd"));
+            const MappedFile::Ptr otherFile = createFile("@PointClass = info_null : \"Null\" []\n", Path("defs/other.fgd"));
+
+            Assets::EntityDefinitionList oldDefinitions = parse(oldFile, defaultColor);
+            Assets::EntityDefinitionList newDefinitions = parse(newFile, defaultColor);
+            Assets::EntityDefinitionList otherColorDefinitions = parse(oldFile, otherColor);
+            Assets::EntityDefinitionList otherDefinitions = parse(otherFile, defaultColor);
+
+            cache.store(*oldFile, defaultColor, oldDefinitions);
+            cache.store(*oldFile, otherColor, otherColorDefinitions);
+            cache.store(*otherFile, defaultColor, otherDefinitions);
+            ASSERT_EQ(3u, directory.files().size());
+
+            // replaces the cache file of the old contents of the same file with the same default color
+            cache.store(*newFile, defaultColor, newDefinitions);
+            ASSERT_EQ(3u, directory.files().size());
+
+            Assets::EntityDefinitionList loaded;
+            ASSERT_FALSE(cache.load(*oldFile, defaultColor, loaded));
+            ASSERT_TRUE(cache.load(*newFile, defaultColor, loaded));
+            ASSERT_TRUE(cache.load(*oldFile, otherColor, loaded));
+            ASSERT_TRUE(cache.load(*otherFile, defaultColor, loaded));
+
+            VectorUtils::clearAndDelete(oldDefinitions);
+            VectorUtils::clearAndDelete(newDefinitions);
+            VectorUtils::clearAndDelete(otherColorDefinitions);
+            VectorUtils::clearAndDelete(otherDefinitions);
+            VectorUtils::clearAndDelete(loaded);
+        }
+    }
+}
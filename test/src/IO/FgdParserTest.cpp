@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
+#include "TestLogger.h"
 #include "TestUtils.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/AttributeDefinition.h"
@@ -27,6 +29,7 @@
 #include "IO/DiskIO.h"
 #include "IO/FgdParser.h"
 #include "IO/Path.h"
+#include "IO/SimpleParserStatus.h"
 #include "IO/TestParserStatus.h"
 #include "Model/ModelTypes.h"
 
@@ -233,6 +236,80 @@ namespace TrenchBroom {
             VectorUtils::clearAndDelete(definitions);
         }
         
+        TEST(FgdParserTest, parseAttributesAfterParserIsGone) {
+            Assets::EntityDefinitionList definitions;
+            {
+                const String file =
+                "@baseclass = Targetname [ targetname(target_source) : \"Name\" ]\n"
+                "@PointClass base(Targetname) = info_notnull [ noise(string) : \"noise\" ]\n"
+                "@baseclass = Targetname [ target(target_destination) : \"Target\" ]\n"
+                "@SolidClass base(Targetname) = func_wall [ ]\n";
+                
+                const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+                FgdParser parser(file, defaultColor);
+                
+                TestParserStatus status;
+                definitions = parser.parseDefinitions(status);
+            }
+            ASSERT_EQ(2u, definitions.size());
+            
+            // info_notnull inherits from the first definition of Targetname, func_wall from the second
+            const Assets::EntityDefinition* pointDefinition = definitions[0];
+            ASSERT_EQ(2u, pointDefinition->attributeDefinitions().size());
+            ASSERT_TRUE(pointDefinition->attributeDefinition("targetname") != nullptr);
+            ASSERT_TRUE(pointDefinition->attributeDefinition("noise") != nullptr);
+            
+            const Assets::EntityDefinition* brushDefinition = definitions[1];
+            ASSERT_EQ(1u, brushDefinition->attributeDefinitions().size());
+            ASSERT_TRUE(brushDefinition->attributeDefinition("target") != nullptr);
+            
+            VectorUtils::clearAndDelete(definitions);
+        }
+        
+        TEST(FgdParserTest, parseSpawnflagsOfSharedBaseClass) {
+            const String file =
+            "@baseclass = Appearflags [ spawnflags(flags) = [ 256 : \"Not in Easy\" : 0 ] ]\n"
+            "@baseclass = Lightflags [ spawnflags(flags) = [ 1 : \"Start off\" : 0 ] ]\n"
+            "@PointClass base(Lightflags, Appearflags) = light []\n"
+            "@PointClass base(Appearflags) = info_notnull []\n";
+            
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+            
+            TestParserStatus status;
+            Assets::EntityDefinitionList definitions = parser.parseDefinitions(status);
+            ASSERT_EQ(2u, definitions.size());
+            
+            // merging the flags of light must not change the flags inherited by info_notnull
+            ASSERT_EQ(2u, definitions[0]->spawnflags()->options().size());
+            ASSERT_EQ(1u, definitions[1]->spawnflags()->options().size());
+            
+            VectorUtils::clearAndDelete(definitions);
+        }
+        
+        TEST(FgdParserTest, parseMalformedAttributes) {
+            const String file =
+            "@PointClass = info_notnull [ noise(string) : \"noise\" : : ]\n"
+            "@PointClass = info_null [ noise(string) : \"noise\" ]\n";
+            
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+            
+            TestParserStatus status;
+            ASSERT_THROW(parser.parseDefinitions(status), ParserException);
+        }
+        
+        TEST(FgdParserTest, parseUnterminatedAttributes) {
+            const String file =
+            "@PointClass = info_notnull [ noise(string) : \"noise\"\n";
+            
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+            
+            TestParserStatus status;
+            ASSERT_THROW(parser.parseDefinitions(status), ParserException);
+        }
+        
         TEST(FgdParserTest, parseType_TargetSourceAttribute) {
             const String file =
             "@PointClass = info_notnull : \"Wildcard entity\" // I love you\n"
@@ -645,5 +722,80 @@ namespace TrenchBroom {
             
             VectorUtils::clearAndDelete(definitions);
         }
+
+        TEST(FgdParserTest, reportErrorInDeferredAttributesWhenParsing) {
+            const String file =
+            "@PointClass = info_test : \"Test\"\n"
+            "[\n"
+            "	use(string) : \"self.use\"\n"
+            "	think : \"self.think\"\n"
+            "]\n";
+            
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+            
+            TestParserStatus status;
+            ASSERT_THROW(parser.parseDefinitions(status), ParserException);
+        }
+        
+        TEST(FgdParserTest, reportWarningInDeferredAttributesWhenParsing) {
+            const String file =
+            "@PointClass = info_test : \"Test\"\n"
+            "[\n"
+            "	use(string) : \"self.use\"\n"
+            "	use(string) : \"self.use again\"\n"
+            "	spawnflags(flags) =\n"
+            "	[\n"
+            "		1 : \"First\" : 1 : \"The first flag\"\n"
+            "		2 : \"Second\"\n"
+            "	]\n"
+            "	style(choices) : \"Style\" : 1.5 =\n"
+            "	[\n"
+            "		0 : \"Plain\"\n"
+            "		1 : \"Fancy\"\n"
+            "	]\n"
+            "]\n";
+            
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file, defaultColor);
+            
+            TestLogger logger;
+            SimpleParserStatus status(&logger);
+            Assets::EntityDefinitionList definitions = parser.parseDefinitions(status);
+            ASSERT_EQ(1u, definitions.size());
+            // the redefined attribute and the float default value of the choices attribute
+            ASSERT_EQ(2u, logger.countMessages());
+            
+            // the attributes are parsed without reporting the problems again
+            const size_t before = logger.countMessages();
+            ASSERT_EQ(3u, definitions[0]->attributeDefinitions().size());
+            ASSERT_EQ(before, logger.countMessages());
+            
+            VectorUtils::clearAndDelete(definitions);
+        }
+        
+        TEST(FgdParserTest, loadDeferredAttributesConcurrently) {
+            StringStream file;
+            file << "@BaseClass = Base [ a(string) : \"a\" b(integer) : \"b\" ]\n";
+            for (size_t i = 0; i < 64; ++i)
+                file << "@PointClass base(Base) = point_" << i << " : \"Point\" [ c(string) : \"c\" ]\n";
+            
+            const Color defaultColor(1.0f, 1.0f, 1.0f, 1.0f);
+            FgdParser parser(file.str(), defaultColor);
+            
+            TestParserStatus status;
+            Assets::EntityDefinitionList definitions = parser.parseDefinitions(status);
+            ASSERT_EQ(64u, definitions.size());
+            
+            std::vector<size_t> counts(definitions.size() * 4);
+            ParallelUtils::forEachIndex(counts.size(), [&](const size_t i) {
+                counts[i] = definitions[i % definitions.size()]->attributeDefinitions().size();
+            });
+            
+            for (const size_t count : counts)
+                ASSERT_EQ(3u, count);
+            
+            VectorUtils::clearAndDelete(definitions);
+        }
     }
 }
@@ -0,0 +1,192 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/FileSystemHierarchy.h"
+#include "IO/IdPakFileSystem.h"
+#include "IO/MappedFile.h"
+#include "IO/Path.h"
+
+#include <wx/filefn.h>
+
+#include <cassert>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace TrenchBroom {
+    namespace IO {
+        static IdPakFileSystem* openPak(const String& name, const Path& mountPath) {
+            const Path pakPath = Disk::getCurrentWorkingDir() + Path("data/IO/Pak") + Path(name);
+            const MappedFile::Ptr pakFile = Disk::openFile(pakPath);
+            assert(pakFile != nullptr);
+            return new IdPakFileSystem(mountPath, pakFile);
+        }
+
+        // a scratch directory that is removed with all of its contents when the test ends
+        class TemporaryDirectory {
+        private:
+            Path m_path;
+        public:
+            explicit TemporaryDirectory(const String& name) :
+            m_path(Disk::getCurrentWorkingDir() + Path(name)) {
+                remove(m_path);
+                Disk::createDirectory(m_path);
+            }
+
+            ~TemporaryDirectory() {
+                remove(m_path);
+            }
+
+            const Path& path() const {
+                return m_path;
+            }
+        private:
+            static void remove(const Path& path) {
+                if (!::wxDirExists(path.asString()))
+                    return;
+                for (const Path& entry : Disk::getDirectoryContents(path)) {
+                    const Path entryPath = path + entry;
+                    if (::wxDirExists(entryPath.asString()))
+                        remove(entryPath);
+                    else
+                        ::wxRemoveFile(entryPath.asString());
+                }
+                ::wxRmdir(path.asString());
+            }
+        };
+
+        TEST(FileSystemHierarchyTest, fileAndDirectoryExists) {
+            FileSystemHierarchy fs;
+            ASSERT_FALSE(fs.directoryExists(Path("")));
+
+            fs.addFileSystem(openPak("pak1.pak", Path("/pak1.pak")));
+            fs.addFileSystem(openPak("pak3.pak", Path("/pak3.pak")));
+
+            ASSERT_TRUE(fs.directoryExists(Path("")));
+            ASSERT_TRUE(fs.directoryExists(Path("textures/e1u1")));
+            ASSERT_TRUE(fs.directoryExists(Path("GFX")));
+            ASSERT_FALSE(fs.directoryExists(Path("gfx/palette.lmp")));
+
+            ASSERT_TRUE(fs.fileExists(Path("textures/e1u1/box1_3.wal")));
+            ASSERT_TRUE(fs.fileExists(Path("Textures/E1U1/../e1u2/Basic1_7.WAL")));
+            ASSERT_TRUE(fs.fileExists(Path("gfx/palette.lmp")));
+            ASSERT_FALSE(fs.fileExists(Path("gfx")));
+            ASSERT_FALSE(fs.fileExists(Path("gfx/colormap.lmp")));
+
+            ASSERT_TRUE(fs.openFile(Path("GFX/Palette.lmp")) != nullptr);
+            ASSERT_THROW(fs.openFile(Path("gfx/colormap.lmp")), FileSystemException);
+
+            fs.clear();
+            ASSERT_FALSE(fs.fileExists(Path("gfx/palette.lmp")));
+        }
+
+        TEST(FileSystemHierarchyTest, getDirectoryContents) {
+            FileSystemHierarchy fs;
+            fs.addFileSystem(openPak("pak1.pak", Path("/pak1.pak")));
+            fs.addFileSystem(openPak("pak3.pak", Path("/pak3.pak")));
+            fs.addFileSystem(openPak("pak3.pak", Path("/pak3_copy.pak")));
+
+            const Path::List contents = fs.getDirectoryContents(Path(""));
+            ASSERT_EQ(5u, contents.size());
+            ASSERT_EQ(Path("amnet.cfg"), contents[0]);
+            ASSERT_EQ(Path("bear.cfg"), contents[1]);
+            ASSERT_EQ(Path("gfx"), contents[2]);
+            ASSERT_EQ(Path("pics"), contents[3]);
+            ASSERT_EQ(Path("textures"), contents[4]);
+
+            ASSERT_EQ(3u, fs.getDirectoryContents(Path("Textures")).size());
+            ASSERT_THROW(fs.getDirectoryContents(Path("models")), FileSystemException);
+        }
+
+        TEST(FileSystemHierarchyTest, laterFileSystemsShadowEarlierOnes) {
+            FileSystemHierarchy fs;
+            fs.addFileSystem(openPak("pak3.pak", Path("/first.pak")));
+            fs.addFileSystem(openPak("pak3.pak", Path("/second.pak")));
+
+            ASSERT_EQ(Path("/second.pak/gfx/palette.lmp"), fs.makeAbsolute(Path("gfx/palette.lmp")));
+            ASSERT_EQ(Path(""), fs.makeAbsolute(Path("gfx/colormap.lmp")));
+        }
+
+#ifndef _WIN32
+        TEST(FileSystemHierarchyTest, indexDirectoryCyclesOnce) {
+            TemporaryDirectory dir("fshierarchytest_cycle");
+            Disk::createDirectory(dir.path() + Path("maps"));
+            Disk::createFile(dir.path() + Path("maps/test.map"), "{}");
+
+            // maps/loop refers to maps, so every path maps/loop/loop/... names the same directory
+            const Path linkPath = dir.path() + Path("maps/loop");
+            ASSERT_EQ(0, ::symlink((dir.path() + Path("maps")).asString().c_str(), linkPath.asString().c_str()));
+
+            FileSystemHierarchy fs;
+            fs.addFileSystem(new DiskFileSystem(dir.path()));
+
+            ASSERT_TRUE(fs.fileExists(Path("maps/test.map")));
+            ASSERT_TRUE(fs.directoryExists(Path("maps/loop")));
+            ASSERT_FALSE(fs.fileExists(Path("maps/loop/test.map")));
+
+            // remove the link so that removing the directory does not follow it
+            fs.clear();
+            ASSERT_EQ(0, ::unlink(linkPath.asString().c_str()));
+        }
+#endif
+
+        TEST(FileSystemHierarchyTest, updateIndexAfterWrites) {
+            TemporaryDirectory dir("fshierarchytest_write");
+
+            WritableFileSystemHierarchy fs;
+            fs.addReadableFileSystem(openPak("pak3.pak", Path("/pak3.pak")));
+            fs.addWritableFileSystem(new WritableDiskFileSystem(dir.path(), false));
+
+            fs.createDirectory(Path("maps"));
+            ASSERT_TRUE(fs.directoryExists(Path("maps")));
+            ASSERT_EQ(0u, fs.getDirectoryContents(Path("maps")).size());
+
+            fs.createFile(Path("maps/test.map"), "{}");
+            ASSERT_TRUE(fs.fileExists(Path("maps/test.map")));
+            ASSERT_EQ(Path::List(1, Path("test.map")), fs.getDirectoryContents(Path("maps")));
+
+            // a file that is moved into a directory keeps its name
+            fs.createDirectory(Path("backup"));
+            fs.copyFile(Path("maps/test.map"), Path("backup"), false);
+            ASSERT_TRUE(fs.fileExists(Path("backup/test.map")));
+            fs.moveFile(Path("maps/test.map"), Path("maps/moved.map"), false);
+            ASSERT_FALSE(fs.fileExists(Path("maps/test.map")));
+            ASSERT_TRUE(fs.fileExists(Path("maps/moved.map")));
+            ASSERT_EQ(Path::List(1, Path("moved.map")), fs.getDirectoryContents(Path("maps")));
+
+            // a written file shadows the file of the same name in a readable file system until it is deleted
+            fs.createDirectory(Path("gfx"));
+            fs.createFile(Path("gfx/palette.lmp"), "palette");
+            ASSERT_EQ(dir.path() + Path("gfx/palette.lmp"), fs.makeAbsolute(Path("gfx/palette.lmp")));
+            fs.deleteFile(Path("gfx/palette.lmp"));
+            ASSERT_EQ(Path("/pak3.pak/gfx/palette.lmp"), fs.makeAbsolute(Path("gfx/palette.lmp")));
+
+            fs.deleteFile(Path("maps/moved.map"));
+            ASSERT_FALSE(fs.fileExists(Path("maps/moved.map")));
+            ASSERT_TRUE(fs.getDirectoryContents(Path("maps")).empty());
+            fs.clear();
+        }
+    }
+}
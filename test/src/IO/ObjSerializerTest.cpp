@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace TrenchBroom {
+    namespace IO {
+        static String writeObj(Model::World& world) {
+            FILE* file = std::tmpfile();
+            NodeWriter(&world, new ObjFileSerializer(file)).writeMap();
+
+            String result;
+            std::rewind(file);
+            char buffer[4096];
+            size_t read;
+            while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+                result.append(buffer, read);
+            std::fclose(file);
+            return result;
+        }
+
+        static void assertValidObj(const String& obj, const size_t expectedVertices, const size_t expectedObjects, const size_t expectedFaces) {
+            size_t vertices = 0;
+            size_t texCoords = 0;
+            size_t normals = 0;
+            size_t objects = 0;
+            size_t faces = 0;
+
+            for (const String& line : StringUtils::split(obj, '\n')) {
+                if (StringUtils::isPrefix(line, "v ")) {
+                    ++vertices;
+                } else if (StringUtils::isPrefix(line, "vt ")) {
+                    ++texCoords;
+                } else if (StringUtils::isPrefix(line, "vn ")) {
+                    ++normals;
+                } else if (StringUtils::isPrefix(line, "o ")) {
+                    ++objects;
+                } else if (StringUtils::isPrefix(line, "f ")) {
+                    ++faces;
+
+                    // every index must refer to an element that was written before
+                    const StringList indexedVertices = StringUtils::split(line.substr(2), ' ');
+                    ASSERT_FALSE(indexedVertices.empty());
+                    for (const String& indexedVertex : indexedVertices) {
+                        const StringList indices = StringUtils::split(indexedVertex, '/');
+                        ASSERT_EQ(3u, indices.size());
+
+                        const size_t vertexIndex = static_cast<size_t>(std::atol(indices[0].c_str()));
+                        const size_t texCoordsIndex = static_cast<size_t>(std::atol(indices[1].c_str()));
+                        const size_t normalIndex = static_cast<size_t>(std::atol(indices[2].c_str()));
+                        ASSERT_TRUE(vertexIndex >= 1 && vertexIndex <= vertices);
+                        ASSERT_TRUE(texCoordsIndex >= 1 && texCoordsIndex <= texCoords);
+                        ASSERT_TRUE(normalIndex >= 1 && normalIndex <= normals);
+                    }
+                }
+            }
+
+            ASSERT_EQ(expectedVertices, vertices);
+            ASSERT_EQ(6u, normals);
+            ASSERT_EQ(expectedObjects, objects);
+            ASSERT_EQ(expectedFaces, faces);
+        }
+
+        TEST(ObjSerializerTest, writeSharedVertices) {
+            const BBox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, nullptr, worldBounds);
+
+            Model::BrushBuilder builder(&world, worldBounds);
+            world.defaultLayer()->addChild(builder.createCuboid(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(64.0, 64.0, 64.0)), "none"));
+            world.defaultLayer()->addChild(builder.createCuboid(BBox3(Vec3(64.0, 0.0, 0.0), Vec3(128.0, 64.0, 64.0)), "none"));
+
+            const String obj = writeObj(world);
+            ASSERT_TRUE(StringUtils::isPrefix(obj, "o entity0_brush0\n"));
+            ASSERT_NE(String::npos, obj.find("o entity0_brush1\n"));
+
+            // the cubes share four vertices
+            assertValidObj(obj, 12u, 2u, 12u);
+        }
+
+        TEST(ObjSerializerTest, writeMoreBrushesThanBatchSize) {
+            const BBox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, nullptr, worldBounds);
+
+            const size_t count = ObjFileSerializer::BatchSize + 1;
+            Model::BrushBuilder builder(&world, worldBounds);
+            for (size_t i = 0; i < count; ++i)
+                world.defaultLayer()->addChild(builder.createCube(64.0, "none"));
+
+            const String obj = writeObj(world);
+            assertValidObj(obj, 8u, count, 6u * count);
+        }
+    }
+}
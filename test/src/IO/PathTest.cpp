@@ -298,6 +298,35 @@ namespace TrenchBroom {
             ASSERT_TRUE(Path("dir/dir") < Path("dir/dir2"));
             ASSERT_FALSE(Path("dir/dir2") < Path("dir/dir2"));
             ASSERT_FALSE(Path("dir/dir2/dir3") < Path("dir/dir2"));
+            ASSERT_TRUE(Path("dir/file") < Path("dir-2/file"));
+            ASSERT_TRUE(Path("dir/z") < Path("dir.b"));
+        }
+        
+        TEST(PathTest, caseInsensitiveLess) {
+            const Path::Less<StringUtils::CaseInsensitiveCharCompare> less;
+            ASSERT_FALSE(less(Path("Dir/File"), Path("dir/file")));
+            ASSERT_FALSE(less(Path("dir/file"), Path("DIR/FILE")));
+            ASSERT_TRUE(less(Path("dir/File"), Path("dir/file2")));
+            ASSERT_TRUE(less(Path("DIR"), Path("dir/file")));
+            ASSERT_TRUE(less(Path("Dir/z"), Path("dir-2")));
+        }
+        
+        TEST(PathTest, components) {
+            ASSERT_EQ(0u, Path("").length());
+            ASSERT_EQ(0u, Path("/").length());
+            ASSERT_EQ(3u, Path("/this/is/a").length());
+            ASSERT_EQ(3u, Path("this\\is/a/").length());
+            ASSERT_EQ(String("this/is/a"), Path("this\\is\\a").asString('/'));
+            ASSERT_EQ(String("::this::is::a"), Path("/this/is/a").asString("::"));
+            ASSERT_EQ(Path("is/a"), Path("/this/is/a").suffix(2));
+            ASSERT_EQ(Path("/this/is"), Path("/this/is/a").prefix(2));
+            ASSERT_EQ(Path("is"), Path("/this/is/a").subPath(1, 1));
+        }
+        
+        TEST(PathTest, makeCanonicalKeepsDottedNames) {
+            ASSERT_EQ(Path("/.hidden/file..name/..."), Path("/.hidden/file..name/...").makeCanonical());
+            ASSERT_EQ(Path("/.hidden"), Path("/.hidden/./dir/..").makeCanonical());
+            ASSERT_EQ(Path("a/b"), Path("./a/b").makeCanonical());
         }
 #endif
     }
@@ -879,6 +879,66 @@ namespace TrenchBroom {
             delete brush;
         }
         
+        TEST(BrushTest, cloneCopiesGeometry) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom");
+            
+            const Vec3 p8(+32.0, +32.0, +32.0);
+            const Vec3 p9(+16.0, +16.0, +32.0);
+            brush->moveVertices(worldBounds, Vec3::List(1, p8), p9 - p8);
+            
+            Brush* clone = brush->clone(worldBounds);
+            ASSERT_EQ(brush->bounds(), clone->bounds());
+            ASSERT_EQ(brush->vertexCount(), clone->vertexCount());
+            for (const Vec3& position : brush->vertexPositions())
+                ASSERT_TRUE(clone->hasVertex(position));
+            
+            const BrushFaceList& originalFaces = brush->faces();
+            const BrushFaceList& clonedFaces = clone->faces();
+            ASSERT_EQ(originalFaces.size(), clonedFaces.size());
+            for (size_t i = 0; i < originalFaces.size(); ++i) {
+                const BrushFace* originalFace = originalFaces[i];
+                const BrushFace* clonedFace = clonedFaces[i];
+                ASSERT_EQ(clone, clonedFace->brush());
+                ASSERT_TRUE(clonedFace->geometry() != nullptr);
+                ASSERT_NE(originalFace->geometry(), clonedFace->geometry());
+                ASSERT_EQ(originalFace->textureName(), clonedFace->textureName());
+                ASSERT_EQ(originalFace->polygon(), clonedFace->polygon());
+            }
+            
+            // the geometries must not be shared
+            clone->moveVertices(worldBounds, Vec3::List(1, p9), p8 - p9);
+            ASSERT_TRUE(brush->hasVertex(p9));
+            ASSERT_FALSE(brush->hasVertex(p8));
+            ASSERT_TRUE(clone->hasVertex(p8));
+            
+            delete clone;
+            delete brush;
+        }
+        
+        TEST(BrushTest, copyGeometryOutsideOfWorldBounds) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCube(64.0, "texture");
+            
+            BrushGeometry* geometry = brush->copyGeometry(worldBounds);
+            ASSERT_TRUE(geometry != nullptr);
+            
+            Brush* clone = brush->clone(worldBounds, geometry);
+            ASSERT_EQ(brush->bounds(), clone->bounds());
+            ASSERT_EQ(brush->vertexPositions(), clone->vertexPositions());
+            
+            ASSERT_TRUE(brush->copyGeometry(BBox3(16.0)) == nullptr);
+            
+            delete clone;
+            delete brush;
+        }
+        
         TEST(BrushTest, moveTetrahedronVertexToOpposideSide) {
             const BBox3 worldBounds(4096.0);
             World world(MapFormat::Standard, nullptr, worldBounds);
@@ -2737,6 +2797,91 @@ namespace TrenchBroom {
             VectorUtils::deleteAll(result);
         }
 
+        TEST(BrushTest, subtractMultipleCuboidsFromCuboid) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            
+            BrushBuilder builder(&world, worldBounds);
+            Brush* minuend     = builder.createCuboid(BBox3(Vec3(-32.0, -32.0, -32.0), Vec3(32.0, 32.0, 32.0)), "minuend");
+            Brush* subtrahend1 = builder.createCuboid(BBox3(Vec3(-64.0, -64.0,   0.0), Vec3(64.0, 64.0, 64.0)), "subtrahend");
+            Brush* subtrahend2 = builder.createCuboid(BBox3(Vec3(  0.0, -64.0, -64.0), Vec3(64.0, 64.0, 64.0)), "subtrahend");
+            Brush* disjoint    = builder.createCuboid(BBox3(Vec3(128.0, 128.0, 128.0), Vec3(192.0, 192.0, 192.0)), "subtrahend");
+            
+            const BrushList subtrahends = BrushList({ subtrahend1, disjoint, subtrahend2 });
+            const BrushList result = minuend->subtract(world, worldBounds, "default", subtrahends);
+            ASSERT_FALSE(result.empty());
+            
+            // only the lower left octants remain
+            BBox3 resultBounds = result.front()->bounds();
+            for (const Brush* brush : result)
+                resultBounds.mergeWith(brush->bounds());
+            ASSERT_VEC_EQ(Vec3(-32.0, -32.0, -32.0), resultBounds.min);
+            ASSERT_VEC_EQ(Vec3(  0.0,  32.0,   0.0), resultBounds.max);
+            
+            ASSERT_TRUE(minuend->subtract(world, worldBounds, "default", disjoint).empty());
+            
+            delete minuend;
+            delete subtrahend1;
+            delete subtrahend2;
+            delete disjoint;
+            VectorUtils::deleteAll(result);
+        }
+        
+        TEST(BrushTest, computeMovedVerticesDoesNotModifyBrush) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCube(64.0, "left", "right", "front", "back", "top", "bottom");
+            Brush* expected = brush->clone(worldBounds);
+
+            const Vec3 vertex(32.0, 32.0, 32.0);
+            const Vec3 delta(16.0, 16.0, 16.0);
+            ASSERT_TRUE(brush->canMoveVertices(worldBounds, Vec3::List(1, vertex), delta));
+            expected->moveVertices(worldBounds, Vec3::List(1, vertex), delta);
+
+            Brush::NewGeometry newGeometry = brush->computeMovedVertices(Vec3::List(1, vertex), delta);
+            ASSERT_TRUE(brush->hasVertex(vertex));
+            ASSERT_FALSE(brush->hasVertex(vertex + delta));
+            ASSERT_EQ(vertex + delta, newGeometry.vertexMapping[vertex]);
+
+            brush->setNewGeometry(worldBounds, newGeometry);
+            ASSERT_EQ(expected->vertexCount(), brush->vertexCount());
+            ASSERT_EQ(expected->faceCount(), brush->faceCount());
+            ASSERT_TRUE(brush->hasVertex(vertex + delta));
+
+            for (const BrushFace* face : brush->faces()) {
+                const BrushFace* expectedFace = expected->findFace(face->boundary());
+                ASSERT_TRUE(expectedFace != nullptr);
+                ASSERT_EQ(expectedFace->textureName(), face->textureName());
+            }
+
+            delete brush;
+            delete expected;
+        }
+
+        TEST(BrushTest, computeSnappedVerticesMatchesSnapVertices) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* brush = builder.createCuboid(BBox3(Vec3(-31.0, -33.0, -30.0), Vec3(33.0, 31.0, 34.0)), "texture");
+            Brush* expected = brush->clone(worldBounds);
+
+            ASSERT_TRUE(expected->canSnapVertices(worldBounds, 16));
+            expected->snapVertices(worldBounds, 16);
+
+            Brush::NewGeometry newGeometry = brush->computeSnappedVertices(16);
+            ASSERT_TRUE(newGeometry.geometry.polyhedron());
+            brush->setNewGeometry(worldBounds, newGeometry);
+
+            ASSERT_EQ(expected->bounds(), brush->bounds());
+            ASSERT_EQ(BBox3(Vec3(-32.0, -32.0, -32.0), Vec3(32.0, 32.0, 32.0)), brush->bounds());
+
+            delete brush;
+            delete expected;
+        }
+
         TEST(BrushTest, testAlmostDegenerateBrush) {
             // https://github.com/kduske/TrenchBroom/issues/1194
             const String data("{\n"
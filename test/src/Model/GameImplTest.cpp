@@ -0,0 +1,233 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "TestLogger.h"
+#include "Assets/EntityDefinition.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/FileMatcher.h"
+#include "IO/Path.h"
+#include "IO/SimpleParserStatus.h"
+#include "Model/GameConfig.h"
+#include "Model/GameImpl.h"
+
+#include <wx/filefn.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        class TestDirectory {
+        private:
+            IO::Path m_path;
+        public:
+            explicit TestDirectory(const String& name) :
+            m_path(IO::Disk::getCurrentWorkingDir() + IO::Path(name)) {
+                remove(m_path);
+                IO::Disk::ensureDirectoryExists(m_path);
+            }
+            
+            ~TestDirectory() {
+                remove(m_path);
+            }
+            
+            const IO::Path& path() const {
+                return m_path;
+            }
+        private:
+            static void remove(const IO::Path& path) {
+                if (!IO::Disk::directoryExists(path))
+                    return;
+                for (const IO::Path& itemPath : IO::Disk::findItems(path)) {
+                    if (IO::Disk::directoryExists(itemPath))
+                        remove(itemPath);
+                    else
+                        IO::Disk::deleteFile(itemPath);
+                }
+                ::wxRmdir(path.asString());
+            }
+        };
+        
+        TEST(GameImplTest, loadEntityDefinitionsFromCache) {
+            const TestDirectory directory("gameimpltest");
+            const IO::Path fgdPath = directory.path() + IO::Path("test.fgd");
+            const IO::Path cachePath = directory.path() + IO::Path("cache");
+            IO::Disk::createFile(fgdPath,
+                                 "@PointClass = info_test : \"Test\" [ message(string) : \"Message\" message(string) : \"Again\" ]\n"
+                                 "@SolidClass = func_test : \"Test\" [ message(string) : \"Message\" ]\n");
+            
+            GameConfig config;
+            TestLogger logger;
+            IO::SimpleParserStatus status(&logger);
+            
+            {
+                const GameImpl game(config, IO::Path(), cachePath, &logger);
+                Assets::EntityDefinitionList definitions = game.loadEntityDefinitions(status, fgdPath);
+                ASSERT_EQ(3u, definitions.size());
+                
+                // the redefined attribute of the first class is reported when the file is parsed
+                ASSERT_EQ(1u, logger.countMessages());
+                ASSERT_EQ(1u, definitions[0]->attributeDefinitions().size());
+                ASSERT_EQ(1u, definitions[1]->attributeDefinitions().size());
+                ASSERT_EQ(1u, logger.countMessages());
+                
+                VectorUtils::clearAndDelete(definitions);
+            } // waits until the cache is written
+            
+            ASSERT_EQ(1u, IO::Disk::findItems(cachePath).size());
+            
+            {
+                const GameImpl game(config, IO::Path(), cachePath, &logger);
+                Assets::EntityDefinitionList definitions = game.loadEntityDefinitions(status, fgdPath);
+                ASSERT_EQ(3u, definitions.size());
+                ASSERT_EQ("info_test", definitions[0]->name());
+                ASSERT_EQ("func_test", definitions[1]->name());
+                
+                // the definitions were loaded from the cache, so the file was not parsed again
+                ASSERT_EQ(1u, definitions[0]->attributeDefinitions().size());
+                ASSERT_EQ(1u, definitions[1]->attributeDefinitions().size());
+                ASSERT_EQ(1u, logger.countMessages());
+                
+                VectorUtils::clearAndDelete(definitions);
+            }
+        }
+        
+        TEST(GameImplTest, loadEntityDefinitionsWithoutCache) {
+            const TestDirectory directory("gameimpltest");
+            const IO::Path fgdPath = directory.path() + IO::Path("test.fgd");
+            IO::Disk::createFile(fgdPath, "@PointClass = info_test : \"Test\" [ message(string) : \"Message\" message(string) : \"Again\" ]\n");
+            
+            GameConfig config;
+            TestLogger logger;
+            IO::SimpleParserStatus status(&logger);
+            
+            // without a cache directory, the file is parsed every time and its problems are reported every time
+            const GameImpl game(config, IO::Path(), &logger);
+            for (size_t i = 0; i < 2; ++i) {
+                Assets::EntityDefinitionList definitions = game.loadEntityDefinitions(status, fgdPath);
+                ASSERT_EQ(2u, definitions.size());
+                ASSERT_EQ(i + 1u, logger.countMessages());
+                VectorUtils::clearAndDelete(definitions);
+            }
+            
+            ASSERT_EQ(1u, IO::Disk::findItems(directory.path()).size());
+        }
+        
+        static void appendInt32(String& str, const size_t value) {
+            const uint32_t i = static_cast<uint32_t>(value);
+            for (size_t j = 0; j < 4; ++j)
+                str.push_back(static_cast<char>((i >> (8 * j)) & 0xFF));
+        }
+        
+        typedef std::map<String, String> PakContents;
+        
+        // Creates an id pak file containing the given files.
+        static void createPak(const IO::Path& path, const PakContents& files) {
+            static const size_t HeaderLength = 12;
+            static const size_t EntryLength = 64;
+            static const size_t EntryNameLength = 56;
+            
+            String data;
+            String directory;
+            for (const auto& entry : files) {
+                String name = entry.first;
+                name.resize(EntryNameLength, '\0');
+                directory.append(name);
+                appendInt32(directory, HeaderLength + data.size());
+                appendInt32(directory, entry.second.size());
+                data.append(entry.second);
+            }
+            
+            String contents = "PACK";
+            appendInt32(contents, HeaderLength + data.size());
+            appendInt32(contents, files.size() * EntryLength);
+            contents.append(data);
+            contents.append(directory);
+            IO::Disk::createFile(path, contents);
+        }
+        
+        static String readFile(const IO::FileSystem& fs, const IO::Path& path) {
+            const IO::MappedFile::Ptr file = fs.openFile(path);
+            return String(file->begin(), file->end());
+        }
+        
+        static GameConfig createPakGameConfig() {
+            const GameConfig::FileSystemConfig fileSystemConfig(IO::Path("id1"), GameConfig::PackageFormatConfig("pak", "idpak"));
+            return GameConfig("Test", IO::Path(), IO::Path(), StringList(), fileSystemConfig, GameConfig::TextureConfig(), GameConfig::EntityConfig(), GameConfig::FaceAttribsConfig(), BrushContentType::List());
+        }
+        
+        TEST(GameImplTest, mountPackagesConcurrently) {
+            const TestDirectory directory("gameimpltest");
+            const IO::Path searchPath = directory.path() + IO::Path("id1");
+            
+            static const size_t PackageCount = 32;
+            for (size_t i = 0; i < PackageCount; ++i) {
+                const String index = std::to_string(i);
+                PakContents files;
+                files["pak" + index + ".txt"] = index;
+                files["shared.txt"] = index;
+                createPak(searchPath + IO::Path("pak" + index + ".pak"), files);
+            }
+            
+            // packages found later override the files of packages found earlier, regardless of which is read first
+            const IO::Path::List packagePaths = IO::DiskFileSystem(searchPath).findItems(IO::Path(""), IO::FileExtensionMatcher("pak"));
+            ASSERT_EQ(PackageCount, packagePaths.size());
+            const String expectedShared = packagePaths.back().deleteExtension().asString().substr(3);
+            
+            GameConfig config = createPakGameConfig();
+            TestLogger logger;
+            for (size_t run = 0; run < 4; ++run) {
+                const GameImpl game(config, directory.path(), directory.path() + IO::Path("cache"), &logger);
+                const IO::FileSystem& fs = game.gameFileSystem();
+                
+                for (size_t i = 0; i < PackageCount; ++i) {
+                    const String index = std::to_string(i);
+                    ASSERT_EQ(index, readFile(fs, IO::Path("pak" + index + ".txt")));
+                }
+                ASSERT_EQ(expectedShared, readFile(fs, IO::Path("shared.txt")));
+            }
+            ASSERT_EQ(0u, logger.countMessages(Logger::LogLevel_Error));
+        }
+        
+        TEST(GameImplTest, skipUnreadablePackages) {
+            const TestDirectory directory("gameimpltest");
+            const IO::Path searchPath = directory.path() + IO::Path("id1");
+            
+            PakContents files;
+            files["file.txt"] = "contents";
+            createPak(searchPath + IO::Path("pak0.pak"), files);
+            
+            // an empty file cannot be mapped into memory
+            IO::Disk::createFile(searchPath + IO::Path("pak1.pak"), "");
+            
+            GameConfig config = createPakGameConfig();
+            TestLogger logger;
+            const GameImpl game(config, directory.path(), directory.path() + IO::Path("cache"), &logger);
+            
+            ASSERT_EQ("contents", readFile(game.gameFileSystem(), IO::Path("file.txt")));
+            ASSERT_EQ(1u, logger.countMessages(Logger::LogLevel_Error));
+        }
+    }
+}
@@ -21,9 +21,17 @@
 #include <gmock/gmock.h>
 
 #include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
 #include "Model/Node.h"
 #include "Model/NodeVisitor.h"
 #include "Model/PickResult.h"
+#include "Model/World.h"
 
 namespace TrenchBroom {
     namespace Model {
@@ -415,5 +423,66 @@ namespace TrenchBroom {
             ASSERT_TRUE(grandChild1_1->isDescendantOf(NodeList{ &root, child1, child2, grandChild1_1, grandChild1_2 }));
             ASSERT_TRUE(grandChild1_1->isDescendantOf(NodeList{ &root, child1, child2, grandChild1_1, grandChild1_2 }));
         }
+
+        static void assertClone(const Node* original, const Node* clone) {
+            ASSERT_NE(original, clone);
+            ASSERT_EQ(original->name(), clone->name());
+            ASSERT_EQ(original->bounds(), clone->bounds());
+
+            const Brush* originalBrush = dynamic_cast<const Brush*>(original);
+            if (originalBrush != nullptr) {
+                const Brush* clonedBrush = dynamic_cast<const Brush*>(clone);
+                ASSERT_TRUE(clonedBrush != nullptr);
+                ASSERT_EQ(originalBrush->vertexPositions(), clonedBrush->vertexPositions());
+                for (const BrushFace* face : clonedBrush->faces()) {
+                    ASSERT_EQ(clonedBrush, face->brush());
+                    ASSERT_TRUE(face->geometry() != nullptr);
+                }
+            }
+
+            const NodeList& originalChildren = original->children();
+            const NodeList& clonedChildren = clone->children();
+            ASSERT_EQ(originalChildren.size(), clonedChildren.size());
+            for (size_t i = 0; i < originalChildren.size(); ++i) {
+                ASSERT_EQ(clone, clonedChildren[i]->parent());
+                assertClone(originalChildren[i], clonedChildren[i]);
+            }
+        }
+
+        TEST(NodeTest, cloneRecursively) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Layer* layer = world.createLayer("layer", worldBounds);
+            world.addChild(layer);
+
+            Group* group = world.createGroup("group");
+            layer->addChild(group);
+
+            Entity* entity = world.createEntity();
+            group->addChild(entity);
+
+            for (size_t i = 0; i < 100; ++i) {
+                world.defaultLayer()->addChild(builder.createCube(static_cast<FloatType>(i + 1), "texture"));
+                group->addChild(builder.createCube(16.0, "texture"));
+                entity->addChild(builder.createCube(32.0, "texture"));
+            }
+
+            const NodeList& originals = world.defaultLayer()->children();
+            const NodeList clones = Node::cloneRecursively(worldBounds, originals);
+            ASSERT_EQ(originals.size(), clones.size());
+            for (size_t i = 0; i < originals.size(); ++i)
+                assertClone(originals[i], clones[i]);
+            VectorUtils::deleteAll(clones);
+
+            Node* groupClone = group->cloneRecursively(worldBounds);
+            assertClone(group, groupClone);
+            delete groupClone;
+
+            Node* worldClone = world.cloneRecursively(worldBounds);
+            assertClone(&world, worldClone);
+            delete worldClone;
+        }
     }
 }
@@ -73,5 +73,24 @@ namespace TrenchBroom {
             octree.addObject(aBounds, a);
             ASSERT_THROW(octree.removeObject(b), OctreeException);
         }
+        
+        TEST(OctreeTest, findObjectsInBounds) {
+            const BBox3f bounds(-128.0f, +128.0f);
+            const float minSize = 32.0f;
+            Octree<float,int> octree(bounds, minSize);
+            
+            const int a = 1;
+            const int b = 2;
+            const BBox3f aBounds(Vec3f(-120.0f, -120.0f, -120.0f), Vec3f(-110.0f, -110.0f, -110.0f));
+            const BBox3f bBounds(Vec3f( 110.0f,  110.0f,  110.0f), Vec3f( 120.0f,  120.0f,  120.0f));
+            octree.addObject(aBounds, a);
+            octree.addObject(bBounds, b);
+            
+            const Octree<float,int>::List result = octree.findObjects(BBox3f(Vec3f(-128.0f, -128.0f, -128.0f), Vec3f(-100.0f, -100.0f, -100.0f)));
+            ASSERT_EQ(1u, result.size());
+            ASSERT_EQ(a, result.front());
+            
+            ASSERT_EQ(2u, octree.findObjects(bounds).size());
+        }
     }
 }
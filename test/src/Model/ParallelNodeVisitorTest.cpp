@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectMatchingNodesVisitor.h"
+#include "Model/CollectNodesVisitor.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/ParallelNodeVisitor.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        class CountBrushesVisitor : public ConstNodeVisitor {
+        private:
+            size_t m_count;
+        public:
+            CountBrushesVisitor() : m_count(0) {}
+            size_t count() const { return m_count; }
+        private:
+            void doVisit(const World* world) override   {}
+            void doVisit(const Layer* layer) override   {}
+            void doVisit(const Group* group) override   {}
+            void doVisit(const Entity* entity) override {}
+            void doVisit(const Brush* brush) override   { ++m_count; }
+        };
+
+        static void createMap(World& world, const BBox3& worldBounds) {
+            BrushBuilder builder(&world, worldBounds);
+
+            Layer* layer = world.createLayer("layer", worldBounds);
+            world.addChild(layer);
+
+            for (size_t i = 0; i < 100; ++i) {
+                world.defaultLayer()->addChild(builder.createCube(32.0, "texture"));
+
+                Entity* entity = world.createEntity();
+                entity->addChild(builder.createCube(32.0, "texture"));
+                layer->addChild(entity);
+
+                Group* group = world.createGroup("group");
+                group->addChild(builder.createCube(32.0, "texture"));
+                group->addChild(world.createEntity());
+                layer->addChild(group);
+            }
+        }
+
+        TEST(ParallelNodeVisitorTest, collectNodesInTraversalOrder) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            createMap(world, worldBounds);
+
+            CollectNodesVisitor sequential;
+            world.acceptAndRecurse(sequential);
+
+            const NodeList parallel = collectNodesParallel<CollectNodesVisitor>(&world, []() { return CollectNodesVisitor(); });
+            ASSERT_EQ(sequential.nodes(), parallel);
+        }
+
+        TEST(ParallelNodeVisitorTest, visitConstNodes) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            createMap(world, worldBounds);
+
+            const World* constWorld = &world;
+            size_t count = 0;
+            for (const CountBrushesVisitor& visitor : acceptAndRecurseParallel<CountBrushesVisitor>(constWorld, []() { return CountBrushesVisitor(); }))
+                count += visitor.count();
+            ASSERT_EQ(300u, count);
+        }
+
+        TEST(ParallelNodeVisitorTest, visitEmptyWorld) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+
+            const NodeList nodes = collectNodesParallel<CollectNodesVisitor>(&world, []() { return CollectNodesVisitor(); });
+            ASSERT_EQ(2u, nodes.size());
+            ASSERT_EQ(&world, nodes[0]);
+            ASSERT_EQ(world.defaultLayer(), nodes[1]);
+        }
+
+        class MatchIntersectingBrushes {
+        private:
+            BBox3 m_bounds;
+        public:
+            explicit MatchIntersectingBrushes(const BBox3& bounds) :
+            m_bounds(bounds) {}
+            
+            bool operator()(const Node* node) const { return false; }
+            bool operator()(const Brush* brush) const { return brush->bounds().intersects(m_bounds); }
+        };
+        
+        typedef CollectMatchingNodesVisitor<MatchIntersectingBrushes, UniqueNodeCollectionStrategy> CollectIntersectingBrushesVisitor;
+
+        TEST(ParallelNodeVisitorTest, collectNodesFromLayerChildren) {
+            const BBox3 worldBounds(4096.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            BrushBuilder builder(&world, worldBounds);
+            
+            Layer* layer = world.createLayer("layer", worldBounds);
+            world.addChild(layer);
+            
+            for (int x = -1024; x < 1024; x += 64) {
+                for (int y = -1024; y < 1024; y += 64) {
+                    const Vec3 min(x, y, 0.0);
+                    Brush* brush = builder.createCuboid(BBox3(min, min + Vec3(32.0, 32.0, 32.0)), "texture");
+                    if ((x + y) % 128 == 0) {
+                        world.defaultLayer()->addChild(brush);
+                    } else {
+                        Entity* entity = world.createEntity();
+                        entity->addChild(brush);
+                        layer->addChild(entity);
+                    }
+                }
+            }
+            
+            const BBox3 bounds(Vec3(-100.0, -100.0, -100.0), Vec3(200.0, 100.0, 100.0));
+            const NodeList candidates = world.findLayerChildren(bounds);
+            ASSERT_LT(candidates.size(), 1024u);
+            
+            CollectIntersectingBrushesVisitor sequential((MatchIntersectingBrushes(bounds)));
+            world.acceptAndRecurse(sequential);
+            ASSERT_FALSE(sequential.nodes().empty());
+            
+            const NodeList parallel = collectNodesParallel<CollectIntersectingBrushesVisitor>(candidates, [&bounds]() { return CollectIntersectingBrushesVisitor(MatchIntersectingBrushes(bounds)); });
+            ASSERT_EQ(NodeSet(std::begin(sequential.nodes()), std::end(sequential.nodes())), NodeSet(std::begin(parallel), std::end(parallel)));
+        }
+    }
+}
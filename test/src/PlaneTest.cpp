@@ -122,6 +122,30 @@ TEST(PlaneTest, pointStatus) {
     ASSERT_EQ(Math::PointStatus::PSInside, p.pointStatus(Vec3f(0.0f, 0.0f, 10.0f)));
 }
 
+TEST(PlaneTest, pointStatusIsExact) {
+    // Evaluating the distance naively yields 0 due to cancellation.
+    const Plane3d p(0.0, Vec3d(1.0, 1.0, 1.0));
+    ASSERT_EQ(Math::PointStatus::PSAbove, p.pointStatus(Vec3d(1.0e17,  1.0, -1.0e17)));
+    ASSERT_EQ(Math::PointStatus::PSBelow, p.pointStatus(Vec3d(1.0e17, -1.0, -1.0e17)));
+    ASSERT_EQ(Math::PointStatus::PSInside, p.pointStatus(Vec3d(1.0e17, 0.0, -1.0e17)));
+    
+    // Points on the boundary of the epsilon band are inside.
+    const double epsilon = 0.5;
+    const Plane3d q(10.0, Vec3d::PosZ);
+    ASSERT_EQ(Math::PointStatus::PSInside, q.pointStatus(Vec3d(0.0, 0.0, 10.5), epsilon));
+    ASSERT_EQ(Math::PointStatus::PSInside, q.pointStatus(Vec3d(0.0, 0.0,  9.5), epsilon));
+    ASSERT_EQ(Math::PointStatus::PSAbove, q.pointStatus(Vec3d(0.0, 0.0, 10.75), epsilon));
+}
+
+TEST(PlaneTest, pointStatusWithAnchorIsExact) {
+    const Vec3d normal(1.0, 1.0, 1.0);
+    const Vec3d anchor(1.0e17, 0.0, 0.0);
+    const double epsilon = Math::Constants<double>::pointStatusEpsilon();
+    ASSERT_EQ(Math::PointStatus::PSAbove, Math::Robust::pointStatus(normal, anchor, Vec3d(2.0e17,  1.0, -1.0e17), epsilon));
+    ASSERT_EQ(Math::PointStatus::PSBelow, Math::Robust::pointStatus(normal, anchor, Vec3d(2.0e17, -1.0, -1.0e17), epsilon));
+    ASSERT_EQ(Math::PointStatus::PSInside, Math::Robust::pointStatus(normal, anchor, Vec3d(2.0e17, 0.0, -1.0e17), epsilon));
+}
+
 TEST(PlaneTest, pointDistance) {
     const Vec3f a = Vec3f(-2038.034f, 0.0023f, 32.0f);
     const Vec3f n = Vec3f(9.734f, -3.393f, 2.033f).normalized();
@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "MathUtils.h"
+#include "Plane.h"
+#include "PositionArray.h"
+#include "Vec.h"
+
+TEST(PositionArrayTest, classify) {
+    const Vec3d::List points({
+        Vec3d(0.0, 0.0, 11.0),
+        Vec3d(0.0, 0.0, 12.0),
+        Vec3d(0.0, 0.0,  9.0),
+        Vec3d(0.0, 0.0, 10.0)
+    });
+    
+    const PositionArray<double> positions(std::begin(points), std::end(points));
+    ASSERT_EQ(4u, positions.size());
+    
+    const PositionArray<double>::Counts counts = positions.classify(Plane3d(10.0, Vec3d::PosZ));
+    ASSERT_EQ(2u, counts.above);
+    ASSERT_EQ(1u, counts.below);
+    ASSERT_EQ(1u, counts.inside);
+    
+    ASSERT_EQ(Math::PointStatus::PSInside, positions.status(Plane3d(10.0, Vec3d::PosZ)));
+    ASSERT_EQ(Math::PointStatus::PSAbove,  positions.status(Plane3d(5.0, Vec3d::PosZ)));
+    ASSERT_EQ(Math::PointStatus::PSBelow,  positions.status(Plane3d(15.0, Vec3d::PosZ)));
+    ASSERT_EQ(Math::PointStatus::PSBelow,  positions.status(Plane3d(0.0, Vec3d::PosX)));
+}
+
+TEST(PositionArrayTest, classifyMatchesPointStatus) {
+    // The second point cannot be classified reliably without exact arithmetic.
+    const Vec3d::List points({
+        Vec3d(1.0e17,  1.0, -1.0e17),
+        Vec3d(1.0e17, -1.0, -1.0e17),
+        Vec3d(1.0e17,  0.0, -1.0e17),
+        Vec3d(3.0, 4.0, 5.0)
+    });
+    
+    const Plane3d plane(0.0, Vec3d(1.0, 1.0, 1.0));
+    const PositionArray<double> positions(std::begin(points), std::end(points));
+    const PositionArray<double>::Counts counts = positions.classify(plane);
+    
+    size_t above = 0, below = 0, inside = 0;
+    for (const Vec3d& point : points) {
+        switch (plane.pointStatus(point)) {
+            case Math::PointStatus::PSAbove:
+                ++above;
+                break;
+            case Math::PointStatus::PSBelow:
+                ++below;
+                break;
+            default:
+                ++inside;
+                break;
+        }
+    }
+    
+    ASSERT_EQ(2u, counts.above);
+    ASSERT_EQ(above, counts.above);
+    ASSERT_EQ(below, counts.below);
+    ASSERT_EQ(inside, counts.inside);
+}
+
+static Math::PointStatus::Type expectedStatus(const Plane3d& plane, const Vec3d::List& points) {
+    size_t above = 0, below = 0;
+    for (const Vec3d& point : points) {
+        const Math::PointStatus::Type status = plane.pointStatus(point);
+        if (status == Math::PointStatus::PSAbove)
+            ++above;
+        else if (status == Math::PointStatus::PSBelow)
+            ++below;
+    }
+    if (above > 0 && below > 0)
+        return Math::PointStatus::PSInside;
+    return above > 0 ? Math::PointStatus::PSAbove : Math::PointStatus::PSBelow;
+}
+
+TEST(PositionArrayTest, statusOfManyPositions) {
+    // more positions than are stored inline, and more than one block
+    Vec3d::List points;
+    for (size_t i = 0; i < 100; ++i)
+        points.push_back(Vec3d(static_cast<double>(i), 0.0, 0.0));
+    
+    const PositionArray<double> positions(std::begin(points), std::end(points));
+    ASSERT_EQ(points.size(), positions.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        ASSERT_EQ(points[i], positions[i]);
+    
+    for (const double distance : { -1.0, 0.0, 15.5, 16.0, 63.5, 64.0, 98.5, 99.0, 100.0 }) {
+        const Plane3d plane(distance, Vec3d::PosX);
+        ASSERT_EQ(expectedStatus(plane, points), positions.status(plane));
+        ASSERT_EQ(expectedStatus(plane.flipped(), points), positions.status(plane.flipped()));
+    }
+    
+    const PositionArray<double>::Counts counts = positions.classify(Plane3d(63.5, Vec3d::PosX));
+    ASSERT_EQ(36u, counts.above);
+    ASSERT_EQ(64u, counts.below);
+    ASSERT_EQ(0u, counts.inside);
+}
+
+TEST(PositionArrayTest, statusNeedsExactArithmetic) {
+    // The uncertain point is only found in the second block.
+    Vec3d::List points;
+    for (size_t i = 0; i < 20; ++i)
+        points.push_back(Vec3d(-1.0, -1.0, -static_cast<double>(i + 1)));
+    points.push_back(Vec3d(1.0e17, 1.0, -1.0e17));
+    
+    const Plane3d plane(0.0, Vec3d(1.0, 1.0, 1.0));
+    const PositionArray<double> positions(std::begin(points), std::end(points));
+    ASSERT_EQ(Math::PointStatus::PSInside, expectedStatus(plane, points));
+    ASSERT_EQ(Math::PointStatus::PSInside, positions.status(plane));
+}
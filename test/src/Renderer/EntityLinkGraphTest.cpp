@@ -0,0 +1,238 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "GL/GLMock.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Renderer/EntityLinkGraph.h"
+#include "Renderer/Vbo.h"
+#include "Renderer/VertexArray.h"
+#include "View/Selection.h"
+
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        typedef EntityLinkGraph::Link Link;
+        typedef EntityLinkGraph::LinkList LinkList;
+        typedef std::vector<std::pair<GLint, GLsizei> > RangeList;
+
+        static const Color DefaultColor(0.0f, 1.0f, 0.0f, 1.0f);
+        static const Color SelectedColor(1.0f, 0.0f, 0.0f, 1.0f);
+        static const size_t LinkSize = 2 * sizeof(EntityLinkGraph::Vertex);
+
+        static void createGraph(EntityLinkGraph& graph, const Model::EditorContext::EntityLinkMode linkMode, const LinkList& links) {
+            graph.clear(linkMode, DefaultColor, SelectedColor);
+            graph.addLinks(links);
+        }
+
+        static View::Selection select(Model::Entity& entity) {
+            entity.select();
+            View::Selection selection;
+            selection.addSelectedNodes(Model::NodeList(1, &entity));
+            return selection;
+        }
+
+        static RangeList shownLinks(testing::NiceMock<GLMock>& glMock, const EntityLinkGraph& graph) {
+            using namespace testing;
+
+            RangeList result;
+            ON_CALL(glMock, DrawArrays(GL_LINES, _, _)).WillByDefault(Invoke([&](GLenum, GLint index, GLsizei count) {
+                result.push_back(std::make_pair(index, count));
+            }));
+            ON_CALL(glMock, MultiDrawArrays(GL_LINES, _, _, _)).WillByDefault(Invoke([&](GLenum, const GLint* indices, const GLsizei* counts, GLsizei primCount) {
+                for (GLsizei i = 0; i < primCount; ++i)
+                    result.push_back(std::make_pair(indices[i], counts[i]));
+            }));
+
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = VertexArray::ref(graph.vertices());
+            vertexArray.prepare(vbo);
+
+            ActivateVbo activate(vbo);
+            graph.shownLinks().render(vertexArray);
+            return result;
+        }
+
+        TEST(EntityLinkGraphTest, colorLinksBySelection) {
+            Model::Entity a, b, c, d;
+            a.select();
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b), Link(&c, &d) }));
+
+            const EntityLinkGraph::Vertex::List& vertices = graph.vertices();
+            ASSERT_EQ(4u, vertices.size());
+            ASSERT_EQ(SelectedColor, vertices[0].v2);
+            ASSERT_EQ(SelectedColor, vertices[1].v2);
+            ASSERT_EQ(DefaultColor, vertices[2].v2);
+            ASSERT_EQ(DefaultColor, vertices[3].v2);
+        }
+
+        TEST(EntityLinkGraphTest, writeOnlyRecoloredLinks) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c, d;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b), Link(&c, &d) }));
+
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = VertexArray::ref(graph.vertices());
+            vertexArray.prepare(vbo);
+            graph.clearChanges();
+
+            graph.selectionDidChange(select(c));
+            ASSERT_EQ(SelectedColor, graph.vertices()[2].v2);
+            ASSERT_FALSE(graph.shownLinksChanged());
+
+            EXPECT_CALL(glMock, BufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(LinkSize), static_cast<GLsizeiptr>(LinkSize), _));
+            ActivateVbo activate(vbo);
+            graph.updateVertices(vertexArray);
+        }
+
+        TEST(EntityLinkGraphTest, writeConsecutiveChangedLinksAtOnce) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c, d, e;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b), Link(&c, &a), Link(&d, &e) }));
+
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = VertexArray::ref(graph.vertices());
+            vertexArray.prepare(vbo);
+            graph.clearChanges();
+
+            graph.selectionDidChange(select(a));
+
+            EXPECT_CALL(glMock, BufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(2 * LinkSize), _));
+            ActivateVbo activate(vbo);
+            graph.updateVertices(vertexArray);
+        }
+
+        TEST(EntityLinkGraphTest, showAllLinks) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c, d;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b), Link(&c, &d) }));
+
+            ASSERT_EQ(RangeList({ std::make_pair(0, 4) }), shownLinks(glMock, graph));
+        }
+
+        TEST(EntityLinkGraphTest, showDirectLinksOfSelectedEntities) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c, d, e;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_Direct, LinkList({ Link(&a, &b), Link(&b, &c), Link(&d, &e) }));
+            ASSERT_TRUE(shownLinks(glMock, graph).empty());
+            graph.clearChanges();
+
+            graph.selectionDidChange(select(c));
+            ASSERT_TRUE(graph.shownLinksChanged());
+            ASSERT_EQ(RangeList({ std::make_pair(2, 2) }), shownLinks(glMock, graph));
+        }
+
+        TEST(EntityLinkGraphTest, showTransitiveLinksOfSelectedEntities) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c, d, e;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_Transitive, LinkList({ Link(&a, &b), Link(&d, &e), Link(&c, &b) }));
+            ASSERT_TRUE(shownLinks(glMock, graph).empty());
+
+            graph.selectionDidChange(select(a));
+            ASSERT_EQ(RangeList({ std::make_pair(0, 2), std::make_pair(4, 2) }), shownLinks(glMock, graph));
+            ASSERT_EQ(SelectedColor, graph.vertices()[0].v2);
+            ASSERT_EQ(DefaultColor, graph.vertices()[4].v2);
+        }
+
+        TEST(EntityLinkGraphTest, updateLinksReplacesRemovedLinks) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c, d;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b), Link(&a, &c) }));
+            graph.clearChanges();
+
+            graph.updateLinks(&a, LinkList({ Link(&a, &d), Link(&a, &b) }));
+            ASSERT_EQ(4u, graph.vertices().size());
+            ASSERT_EQ(Vec3f(d.linkTargetAnchor()), graph.vertices()[3].v1);
+            ASSERT_EQ(RangeList({ std::make_pair(0, 4) }), shownLinks(glMock, graph));
+
+            // the removed link is not recolored when its former target is selected
+            graph.clearChanges();
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = VertexArray::ref(graph.vertices());
+            vertexArray.prepare(vbo);
+
+            graph.selectionDidChange(select(c));
+
+            EXPECT_CALL(glMock, BufferSubData(_, _, _, _)).Times(0);
+            ActivateVbo activate(vbo);
+            graph.updateVertices(vertexArray);
+        }
+
+        TEST(EntityLinkGraphTest, updateLinksAddsLinks) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Model::Entity a, b, c;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b) }));
+
+            graph.updateLinks(&b, LinkList({ Link(&b, &c), Link(&a, &b) }));
+            ASSERT_EQ(4u, graph.vertices().size());
+            ASSERT_EQ(RangeList({ std::make_pair(0, 4) }), shownLinks(glMock, graph));
+        }
+
+        TEST(EntityLinkGraphTest, updateLinksMovesAnchors) {
+            Model::Entity a, b;
+
+            EntityLinkGraph graph;
+            createGraph(graph, Model::EditorContext::EntityLinkMode_All, LinkList({ Link(&a, &b) }));
+
+            const Vec3f oldAnchor(a.linkSourceAnchor());
+            a.addOrUpdateAttribute("origin", "64 0 0");
+            ASSERT_NE(oldAnchor, Vec3f(a.linkSourceAnchor()));
+
+            graph.updateLinks(&a, LinkList({ Link(&a, &b) }));
+            ASSERT_EQ(2u, graph.vertices().size());
+            ASSERT_EQ(Vec3f(a.linkSourceAnchor()), graph.vertices()[0].v1);
+        }
+    }
+}
@@ -0,0 +1,404 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "GL/GLMock.h"
+#include "StringUtils.h"
+#include "Assets/Texture.h"
+#include "Renderer/FaceBatch.h"
+#include "Renderer/FaceRenderer.h"
+#include "Renderer/IndexArray.h"
+#include "Renderer/TexturedIndexArrayBuilder.h"
+#include "Renderer/TexturedIndexArrayMap.h"
+#include "Renderer/Vbo.h"
+#include "Renderer/VertexArray.h"
+#include "Renderer/VertexSpec.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        typedef VertexSpecs::P3::Vertex Vertex;
+        typedef std::vector<const Assets::Texture*> TextureList;
+
+        class RecordingRenderFunc : public FaceBatch::RenderFunc {
+        public:
+            typedef std::vector<String> CallList;
+        private:
+            std::map<const void*, String> m_names;
+            CallList m_calls;
+        public:
+            void name(const void* object, const String& name) {
+                m_names[object] = name;
+            }
+
+            const CallList& calls() const {
+                return m_calls;
+            }
+
+            void before(const FaceRenderer& renderer) override {
+                m_calls.push_back("before " + m_names[&renderer]);
+            }
+
+            void bindTexture(const Assets::Texture* texture, const FaceRenderer& renderer) override {
+                if (texture != nullptr)
+                    m_calls.push_back("bind " + m_names[texture]);
+                else
+                    m_calls.push_back("color " + m_names[&renderer]);
+            }
+
+            void unbindTexture(const Assets::Texture* texture) override {
+                m_calls.push_back("unbind " + m_names[texture]);
+            }
+
+            void after(const FaceRenderer& renderer) override {
+                m_calls.push_back("after " + m_names[&renderer]);
+            }
+        };
+
+        // creates a renderer with one triangle per texture
+        static FaceRenderer createFaceRenderer(Vbo& vertexVbo, Vbo& indexVbo, const TextureList& textures) {
+            Vertex::List vertices;
+            TexturedIndexArrayMap::Size size;
+            for (const Assets::Texture* texture : textures) {
+                for (size_t i = 0; i < 3; ++i)
+                    vertices.push_back(Vertex(Vec3f(static_cast<float>(vertices.size()), 0.0f, 0.0f)));
+                size.inc(texture, GL_TRIANGLES, 3);
+            }
+
+            TexturedIndexArrayBuilder builder(size);
+            for (size_t i = 0; i < textures.size(); ++i) {
+                const GLuint baseIndex = static_cast<GLuint>(3 * i);
+                builder.addTriangle(textures[i], baseIndex, baseIndex + 1, baseIndex + 2);
+            }
+
+            VertexArray vertexArray = VertexArray::swap(vertices);
+            IndexArray indexArray = IndexArray::swap(builder.indices());
+
+            FaceRenderer renderer(vertexArray, indexArray, builder.ranges(), Color(1.0f, 1.0f, 1.0f, 1.0f));
+            renderer.prepareVertices(vertexVbo);
+            renderer.prepareIndices(indexVbo);
+            return renderer;
+        }
+
+        static RecordingRenderFunc::CallList renderBatch(FaceBatch& batch, RecordingRenderFunc& func, Vbo& vertexVbo, Vbo& indexVbo) {
+            ActivateVbo activateVertices(vertexVbo);
+            ActivateVbo activateIndices(indexVbo);
+            batch.renderFaces(func);
+            return func.calls();
+        }
+
+        TEST(FaceBatchTest, renderRenderersInOrderOfAddition) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+            Assets::Texture t2("t2", 16, 16);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t2 }));
+            FaceRenderer r3 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+
+            RecordingRenderFunc func;
+            func.name(&t1, "t1");
+            func.name(&t2, "t2");
+            func.name(&r1, "r1");
+            func.name(&r2, "r2");
+            func.name(&r3, "r3");
+
+            FaceBatch batch;
+            batch.add(&r1);
+            batch.add(&r2);
+            batch.add(&r3);
+
+            // r3 is not merged into r1 even though they share a texture
+            const RecordingRenderFunc::CallList expected({
+                "before r1", "bind t1", "after r1",
+                "before r2", "bind t2", "after r2",
+                "before r3", "bind t1", "after r3",
+                "unbind t1"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, renderTexturesOfRendererInTextureOrder) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+            Assets::Texture t2("t2", 16, 16);
+            const Assets::Texture* first = std::min<const Assets::Texture*>(&t1, &t2);
+            const Assets::Texture* second = std::max<const Assets::Texture*>(&t1, &t2);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ second, first, second }));
+
+            RecordingRenderFunc func;
+            func.name(first, "first");
+            func.name(second, "second");
+            func.name(&r1, "r1");
+
+            FaceBatch batch;
+            batch.add(&r1);
+
+            const RecordingRenderFunc::CallList expected({
+                "before r1", "bind first", "bind second", "after r1",
+                "unbind second"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, skipBindingBoundTexture) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+
+            RecordingRenderFunc func;
+            func.name(&t1, "t1");
+            func.name(&r1, "r1");
+            func.name(&r2, "r2");
+
+            FaceBatch batch;
+            batch.add(&r1);
+            batch.add(&r2);
+
+            const RecordingRenderFunc::CallList expected({
+                "before r1", "bind t1", "after r1",
+                "before r2", "after r2",
+                "unbind t1"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, renderUntexturedFacesWithRendererColor) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ nullptr }));
+            FaceRenderer r3 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ nullptr }));
+
+            RecordingRenderFunc func;
+            func.name(&t1, "t1");
+            func.name(&r1, "r1");
+            func.name(&r2, "r2");
+            func.name(&r3, "r3");
+
+            FaceBatch batch;
+            batch.add(&r1);
+            batch.add(&r2);
+            batch.add(&r3);
+
+            const RecordingRenderFunc::CallList expected({
+                "before r1", "bind t1", "after r1",
+                "before r2", "unbind t1", "color r2", "after r2",
+                "before r3", "color r3", "after r3"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, skipEmptyRenderers) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+
+            FaceRenderer r1;
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+
+            RecordingRenderFunc func;
+            func.name(&t1, "t1");
+            func.name(&r2, "r2");
+
+            FaceBatch batch;
+            batch.add(&r1);
+            batch.add(&r2);
+
+            const RecordingRenderFunc::CallList expected({
+                "before r2", "bind t1", "after r2",
+                "unbind t1"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, setupEachVertexArrayOnce) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+            Assets::Texture t2("t2", 16, 16);
+            Assets::Texture t3("t3", 16, 16);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1, &t2, &t3 }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t3, &t2, &t1 }));
+
+            FaceBatch batch;
+            batch.add(&r1);
+            batch.add(&r2);
+
+            {
+                InSequence forceInSequenceMockCalls;
+                EXPECT_CALL(glMock, VertexPointer(_, _, _, _));
+                EXPECT_CALL(glMock, DrawElements(GL_TRIANGLES, 3, _, _)).Times(3);
+                EXPECT_CALL(glMock, DisableClientState(GL_VERTEX_ARRAY));
+                EXPECT_CALL(glMock, VertexPointer(_, _, _, _));
+                EXPECT_CALL(glMock, DrawElements(GL_TRIANGLES, 3, _, _)).Times(3);
+                EXPECT_CALL(glMock, DisableClientState(GL_VERTEX_ARRAY));
+            }
+
+            RecordingRenderFunc func;
+            renderBatch(batch, func, vertexVbo, indexVbo);
+        }
+
+        TEST(FaceBatchTest, bindEachTextureOnceInTextureOrder) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+            Assets::Texture t2("t2", 16, 16);
+            const Assets::Texture* first = std::min<const Assets::Texture*>(&t1, &t2);
+            const Assets::Texture* second = std::max<const Assets::Texture*>(&t1, &t2);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ first }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ second }));
+            FaceRenderer r3 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ second, first }));
+
+            RecordingRenderFunc func;
+            func.name(first, "first");
+            func.name(second, "second");
+            func.name(&r1, "r1");
+            func.name(&r2, "r2");
+            func.name(&r3, "r3");
+
+            FaceBatch batch(FaceBatch::Order_Textures);
+            batch.add(&r1);
+            batch.add(&r2);
+            batch.add(&r3);
+
+            const RecordingRenderFunc::CallList expected({
+                "before r1", "bind first", "after r1",
+                "before r3", "after r3",
+                "unbind first",
+                "before r2", "bind second", "after r2",
+                "before r3", "after r3",
+                "unbind second"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, renderUntexturedFacesWithRendererColorInTextureOrder) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1 }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ nullptr }));
+            FaceRenderer r3 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ &t1, nullptr }));
+
+            RecordingRenderFunc func;
+            func.name(&t1, "t1");
+            func.name(&r1, "r1");
+            func.name(&r2, "r2");
+            func.name(&r3, "r3");
+
+            FaceBatch batch(FaceBatch::Order_Textures);
+            batch.add(&r1);
+            batch.add(&r2);
+            batch.add(&r3);
+
+            const RecordingRenderFunc::CallList expected({
+                "before r2", "color r2", "after r2",
+                "before r3", "color r3", "after r3",
+                "before r1", "bind t1", "after r1",
+                "before r3", "after r3",
+                "unbind t1"
+            });
+            ASSERT_EQ(expected, renderBatch(batch, func, vertexVbo, indexVbo));
+        }
+
+        TEST(FaceBatchTest, keepVertexArraySetupInTextureOrder) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+
+            Vbo vertexVbo(0xFFFF, GL_ARRAY_BUFFER);
+            Vbo indexVbo(0xFFFF, GL_ELEMENT_ARRAY_BUFFER);
+
+            Assets::Texture t1("t1", 16, 16);
+            Assets::Texture t2("t2", 16, 16);
+            const Assets::Texture* first = std::min<const Assets::Texture*>(&t1, &t2);
+            const Assets::Texture* second = std::max<const Assets::Texture*>(&t1, &t2);
+
+            FaceRenderer r1 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ first }));
+            FaceRenderer r2 = createFaceRenderer(vertexVbo, indexVbo, TextureList({ first, second }));
+
+            FaceBatch batch(FaceBatch::Order_Textures);
+            batch.add(&r1);
+            batch.add(&r2);
+
+            // r2 renders the last faces with the first texture and the faces with the second texture
+            {
+                InSequence forceInSequenceMockCalls;
+                EXPECT_CALL(glMock, VertexPointer(_, _, _, _));
+                EXPECT_CALL(glMock, DrawElements(GL_TRIANGLES, 3, _, _));
+                EXPECT_CALL(glMock, DisableClientState(GL_VERTEX_ARRAY));
+                EXPECT_CALL(glMock, VertexPointer(_, _, _, _));
+                EXPECT_CALL(glMock, DrawElements(GL_TRIANGLES, 3, _, _)).Times(2);
+                EXPECT_CALL(glMock, DisableClientState(GL_VERTEX_ARRAY));
+            }
+
+            RecordingRenderFunc func;
+            renderBatch(batch, func, vertexVbo, indexVbo);
+        }
+    }
+}
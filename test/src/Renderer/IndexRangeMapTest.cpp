@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "GL/GLMock.h"
+#include "Renderer/IndexRangeMap.h"
+#include "Renderer/Vbo.h"
+#include "Renderer/VertexArray.h"
+#include "Renderer/VertexSpec.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        typedef VertexSpecs::P3::Vertex Vertex;
+        
+        static VertexArray createVertexArray(Vbo& vbo, const size_t vertexCount) {
+            Vertex::List vertices;
+            for (size_t i = 0; i < vertexCount; ++i)
+                vertices.push_back(Vertex(Vec3f(static_cast<float>(i), 0.0f, 0.0f)));
+            
+            VertexArray vertexArray = VertexArray::swap(vertices);
+            vertexArray.prepare(vbo);
+            return vertexArray;
+        }
+        
+        TEST(IndexRangeMapTest, renderSingleRangeWithDrawArrays) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+            
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = createVertexArray(vbo, 8);
+            
+            IndexRangeMap indexRanges(GL_LINE_STRIP, 2, 4);
+            
+            EXPECT_CALL(glMock, MultiDrawArrays(_, _, _, _)).Times(0);
+            EXPECT_CALL(glMock, DrawArrays(GL_LINE_STRIP, 2, 4));
+            
+            ActivateVbo activate(vbo);
+            indexRanges.render(vertexArray);
+        }
+        
+        TEST(IndexRangeMapTest, renderMultipleRangesWithMultiDrawArrays) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+            
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = createVertexArray(vbo, 16);
+            
+            IndexRangeMap indexRanges;
+            indexRanges.add(GL_LINE_STRIP, 0, 3);
+            indexRanges.add(GL_LINE_STRIP, 3, 4);
+            indexRanges.add(GL_LINE_STRIP, 9, 2);
+            
+            std::vector<GLint> indices;
+            std::vector<GLsizei> counts;
+            EXPECT_CALL(glMock, DrawArrays(_, _, _)).Times(0);
+            EXPECT_CALL(glMock, MultiDrawArrays(GL_LINE_STRIP, _, _, 3)).WillOnce(Invoke([&](GLenum, const GLint* i, const GLsizei* c, GLsizei n) {
+                indices.assign(i, i + n);
+                counts.assign(c, c + n);
+            }));
+            
+            ActivateVbo activate(vbo);
+            indexRanges.render(vertexArray);
+            
+            ASSERT_EQ(std::vector<GLint>({ 0, 3, 9 }), indices);
+            ASSERT_EQ(std::vector<GLsizei>({ 3, 4, 2 }), counts);
+        }
+        
+        TEST(IndexRangeMapTest, mergeContiguousRangesOfListPrimitives) {
+            using namespace testing;
+            NiceMock<GLMock> glMock;
+            
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = createVertexArray(vbo, 16);
+            
+            IndexRangeMap indexRanges;
+            indexRanges.add(GL_LINES, 0, 2);
+            indexRanges.add(GL_LINES, 4, 2);
+            indexRanges.add(GL_LINES, 6, 2);
+            indexRanges.add(GL_LINES, 8, 4);
+            
+            std::vector<GLint> indices;
+            std::vector<GLsizei> counts;
+            EXPECT_CALL(glMock, MultiDrawArrays(GL_LINES, _, _, 2)).WillOnce(Invoke([&](GLenum, const GLint* i, const GLsizei* c, GLsizei n) {
+                indices.assign(i, i + n);
+                counts.assign(c, c + n);
+            }));
+            
+            ActivateVbo activate(vbo);
+            indexRanges.render(vertexArray);
+            
+            ASSERT_EQ(std::vector<GLint>({ 0, 4 }), indices);
+            ASSERT_EQ(std::vector<GLsizei>({ 2, 8 }), counts);
+        }
+        
+        TEST(IndexRangeMapTest, renderMultipleRangesWithoutMultiDrawArrays) {
+            using namespace testing;
+            InSequence forceInSequenceMockCalls;
+            NiceMock<GLMock> glMock;
+            glMultiDrawArrays.unbindFunc();
+            
+            Vbo vbo(0xFFFF, GL_ARRAY_BUFFER);
+            VertexArray vertexArray = createVertexArray(vbo, 16);
+            
+            IndexRangeMap indexRanges;
+            indexRanges.add(GL_TRIANGLE_FAN, 0, 3);
+            indexRanges.add(GL_TRIANGLE_FAN, 3, 5);
+            
+            EXPECT_CALL(glMock, DrawArrays(GL_TRIANGLE_FAN, 0, 3));
+            EXPECT_CALL(glMock, DrawArrays(GL_TRIANGLE_FAN, 3, 5));
+            
+            ActivateVbo activate(vbo);
+            indexRanges.render(vertexArray);
+        }
+    }
+}
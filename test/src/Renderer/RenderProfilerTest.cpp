@@ -0,0 +1,145 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "GL/GLMock.h"
+#include "StringUtils.h"
+#include "Renderer/RenderProfiler.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        using namespace testing;
+
+        TEST(RenderProfilerTest, disabledProfilerRecordsNothing) {
+            RenderProfiler profiler;
+            RenderProfiler::GPUTimer gpuTimer;
+
+            profiler.beginFrame(gpuTimer);
+            profiler.countDrawCall();
+            profiler.addTime(RenderProfiler::Section_RenderBatch, 1.0);
+            profiler.endFrame(gpuTimer);
+
+            ASSERT_EQ(0u, profiler.frameCount());
+        }
+
+        TEST(RenderProfilerTest, recordCounters) {
+            NiceMock<GLMock> glMock;
+            glGenQueries.unbindFunc(); // no timer query support
+
+            RenderProfiler profiler;
+            RenderProfiler::GPUTimer gpuTimer;
+            profiler.setEnabled(true);
+
+            profiler.beginFrame(gpuTimer);
+            profiler.countDrawCall();
+            profiler.countDrawCall();
+            profiler.countTextureBind();
+            profiler.countUpload(128);
+            profiler.addTime(RenderProfiler::Section_RenderText, 1.5);
+            profiler.addTime(RenderProfiler::Section_RenderText, 0.5);
+            profiler.endFrame(gpuTimer);
+
+            ASSERT_EQ(1u, profiler.frameCount());
+            const RenderProfiler::Frame& frame = profiler.frame(0);
+            ASSERT_EQ(2u, frame.drawCalls);
+            ASSERT_EQ(1u, frame.textureBinds);
+            ASSERT_EQ(128u, frame.uploadedBytes);
+            ASSERT_DOUBLE_EQ(2.0, frame.sectionMs[RenderProfiler::Section_RenderText]);
+            ASSERT_DOUBLE_EQ(0.0, frame.sectionMs[RenderProfiler::Section_RenderBatch]);
+            ASSERT_LT(frame.gpuMs, 0.0);
+        }
+
+        TEST(RenderProfilerTest, keepMostRecentFrames) {
+            NiceMock<GLMock> glMock;
+            glGenQueries.unbindFunc(); // no timer query support
+
+            RenderProfiler profiler;
+            RenderProfiler::GPUTimer gpuTimer;
+            profiler.setEnabled(true);
+
+            for (size_t i = 0; i < RenderProfiler::Capacity + 10; ++i) {
+                profiler.beginFrame(gpuTimer);
+                for (size_t j = 0; j < i; ++j)
+                    profiler.countDrawCall();
+                profiler.endFrame(gpuTimer);
+            }
+
+            ASSERT_EQ(RenderProfiler::Capacity, profiler.frameCount());
+            ASSERT_EQ(10u, profiler.frame(0).drawCalls);
+            ASSERT_EQ(RenderProfiler::Capacity + 9, profiler.frame(RenderProfiler::Capacity - 1).drawCalls);
+
+            profiler.clear();
+            ASSERT_EQ(0u, profiler.frameCount());
+        }
+
+        TEST(RenderProfilerTest, writeCSV) {
+            NiceMock<GLMock> glMock;
+            glGenQueries.unbindFunc(); // no timer query support
+
+            RenderProfiler profiler;
+            RenderProfiler::GPUTimer gpuTimer;
+            profiler.setEnabled(true);
+
+            profiler.beginFrame(gpuTimer);
+            profiler.countDrawCall();
+            profiler.endFrame(gpuTimer);
+
+            StringStream str;
+            profiler.writeCSV(str);
+
+            const StringList lines = StringUtils::splitAndTrim(str.str(), "\n");
+            ASSERT_EQ(2u, lines.size());
+            ASSERT_EQ("frame,cpu_ms,gpu_ms,render_batch_ms,commit_pending_changes_ms,validate_brushes_ms,render_entities_ms,render_text_ms,pick_ms,draw_calls,texture_binds,uploaded_bytes", lines[0]);
+
+            const StringList values = StringUtils::split(lines[1], ',');
+            ASSERT_EQ(12u, values.size());
+            ASSERT_EQ("0", values[0]);
+            ASSERT_EQ("", values[2]);
+            ASSERT_EQ("1", values[9]);
+        }
+
+        TEST(RenderProfilerTest, readGPUTimeOneFrameLater) {
+            NiceMock<GLMock> glMock;
+
+            const GLuint queryIds[] = { 1, 2 };
+            EXPECT_CALL(glMock, GenQueries(2, _)).WillOnce(SetArrayArgument<1>(queryIds, queryIds + 2));
+            EXPECT_CALL(glMock, GetQueryObjectuiv(1, GL_QUERY_RESULT_AVAILABLE, _)).WillOnce(SetArgPointee<2>(1));
+            EXPECT_CALL(glMock, GetQueryObjectuiv(1, GL_QUERY_RESULT, _)).WillOnce(SetArgPointee<2>(2000000));
+
+            RenderProfiler profiler;
+            RenderProfiler::GPUTimer gpuTimer;
+            profiler.setEnabled(true);
+
+            EXPECT_CALL(glMock, BeginQuery(GL_TIME_ELAPSED, 1));
+            profiler.beginFrame(gpuTimer);
+            profiler.endFrame(gpuTimer);
+
+            EXPECT_CALL(glMock, BeginQuery(GL_TIME_ELAPSED, 2));
+            profiler.beginFrame(gpuTimer);
+            profiler.endFrame(gpuTimer);
+
+            ASSERT_EQ(2u, profiler.frameCount());
+            ASSERT_DOUBLE_EQ(2.0, profiler.frame(0).gpuMs);
+            ASSERT_LT(profiler.frame(1).gpuMs, 0.0);
+        }
+    }
+}
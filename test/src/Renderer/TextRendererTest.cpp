@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "GL/GLMock.h"
+#include "AttrString.h"
+#include "Color.h"
+#include "IO/Path.h"
+#include "Renderer/FontDescriptor.h"
+#include "Renderer/FontFactory.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontManager.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "Renderer/RenderContext.h"
+#include "Renderer/ShaderManager.h"
+#include "Renderer/TextAnchor.h"
+#include "Renderer/TextRenderer.h"
+#include "Renderer/TextureFont.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        // creates fonts whose printable characters are all 8 pixels wide without loading a font file
+        class TestFontFactory : public FontFactory {
+        private:
+            TextureFont* doCreateFont(const FontDescriptor& fontDescriptor) override {
+                const unsigned char firstChar = fontDescriptor.minChar();
+                const unsigned char charCount = fontDescriptor.charCount();
+                const FontGlyph::List glyphs(charCount, FontGlyph(0, 0, 8, 12, 8));
+                return new TextureFont(new FontTexture(charCount, 12, 3), glyphs, 12, firstChar, charCount);
+            }
+        };
+
+        class TextRendererTest : public ::testing::Test {
+        protected:
+            testing::NiceMock<GLMock> glMock;
+            FontDescriptor fontDescriptor;
+            FontManager fontManager;
+            ShaderManager shaderManager;
+            PerspectiveCamera camera;
+        protected:
+            TextRendererTest() :
+            fontDescriptor(IO::Path("TestFont"), 12),
+            fontManager(new TestFontFactory()) {
+                // look along the X axis from the origin
+                camera.setViewport(Camera::Viewport(0, 0, 800, 600));
+                camera.moveTo(Vec3f::Null);
+                camera.setDirection(Vec3f::PosX, Vec3f::PosZ);
+            }
+
+            size_t cachedLayoutCount() {
+                return fontManager.font(fontDescriptor).cachedLayoutCount();
+            }
+
+            void renderString(TextRenderer& textRenderer, RenderContext& renderContext, const String& string, const Vec3f& position) {
+                const SimpleTextAnchor anchor(position, TextAlignment::Center);
+                textRenderer.renderString(renderContext, Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f), AttrString(string), anchor);
+            }
+        };
+
+        TEST_F(TextRendererTest, layoutVisibleLabels) {
+            RenderContext renderContext(RenderContext::RenderMode_3D, camera, fontManager, shaderManager);
+            TextRenderer textRenderer(fontDescriptor, 768.0f);
+
+            renderString(textRenderer, renderContext, "visible", Vec3f(256.0f, 0.0f, 0.0f));
+            ASSERT_EQ(1u, cachedLayoutCount());
+        }
+
+        TEST_F(TextRendererTest, cullLabelsBehindCameraBeforeLayout) {
+            RenderContext renderContext(RenderContext::RenderMode_3D, camera, fontManager, shaderManager);
+            TextRenderer textRenderer(fontDescriptor, 768.0f);
+
+            renderString(textRenderer, renderContext, "behind", Vec3f(-256.0f, 0.0f, 0.0f));
+            ASSERT_EQ(0u, cachedLayoutCount());
+        }
+
+        TEST_F(TextRendererTest, cullDistantLabelsBeforeLayout) {
+            RenderContext renderContext(RenderContext::RenderMode_3D, camera, fontManager, shaderManager);
+            TextRenderer textRenderer(fontDescriptor, 768.0f);
+
+            renderString(textRenderer, renderContext, "distant", Vec3f(1024.0f, 0.0f, 0.0f));
+            ASSERT_EQ(0u, cachedLayoutCount());
+
+            // labels on top are not culled by their distance
+            const SimpleTextAnchor anchor(Vec3f(1024.0f, 0.0f, 0.0f), TextAlignment::Center);
+            textRenderer.renderStringOnTop(renderContext, Color(1.0f, 1.0f, 1.0f), Color(0.0f, 0.0f, 0.0f), AttrString("distant"), anchor);
+            ASSERT_EQ(1u, cachedLayoutCount());
+        }
+
+        TEST_F(TextRendererTest, cullLabelsWhenZoomedOutBeforeLayout) {
+            camera.setZoom(0.25f);
+            RenderContext renderContext(RenderContext::RenderMode_2D, camera, fontManager, shaderManager);
+            TextRenderer textRenderer(fontDescriptor, 768.0f, 0.5f);
+
+            renderString(textRenderer, renderContext, "zoomed out", Vec3f(256.0f, 0.0f, 0.0f));
+            ASSERT_EQ(0u, cachedLayoutCount());
+        }
+
+        TEST_F(TextRendererTest, shareLayoutOfRepeatedLabels) {
+            RenderContext renderContext(RenderContext::RenderMode_3D, camera, fontManager, shaderManager);
+            TextRenderer textRenderer(fontDescriptor, 768.0f);
+
+            renderString(textRenderer, renderContext, "label", Vec3f(256.0f,  16.0f, 0.0f));
+            renderString(textRenderer, renderContext, "label", Vec3f(256.0f, -16.0f, 0.0f));
+            renderString(textRenderer, renderContext, "other", Vec3f(256.0f,   0.0f, 0.0f));
+            ASSERT_EQ(2u, cachedLayoutCount());
+        }
+    }
+}
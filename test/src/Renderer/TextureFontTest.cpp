@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "AttrString.h"
+#include "Renderer/FontGlyph.h"
+#include "Renderer/FontTexture.h"
+#include "Renderer/TextureFont.h"
+
+#include <memory>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        // creates a font whose printable characters are all 8 pixels wide
+        static std::unique_ptr<TextureFont> createFont() {
+            const unsigned char firstChar = ' ';
+            const unsigned char charCount = '~' - ' ' + 1;
+            const FontGlyph::List glyphs(charCount, FontGlyph(0, 0, 8, 12, 8));
+            return std::unique_ptr<TextureFont>(new TextureFont(new FontTexture(charCount, 12, 3), glyphs, 12, firstChar, charCount));
+        }
+
+        TEST(TextureFontTest, layoutString) {
+            std::unique_ptr<TextureFont> font = createFont();
+
+            const TextureFont::LayoutPtr layout = font->layout(AttrString("abc"));
+            ASSERT_EQ(font->measure(AttrString("abc")), layout->size);
+            ASSERT_EQ(font->quads(AttrString("abc"), true), layout->vertices);
+            ASSERT_EQ(3u * 4u * 2u, layout->vertices.size());
+        }
+
+        TEST(TextureFontTest, reuseCachedLayout) {
+            std::unique_ptr<TextureFont> font = createFont();
+
+            const TextureFont::LayoutPtr first = font->layout(AttrString("abc"));
+            ASSERT_EQ(first, font->layout(AttrString("abc")));
+            ASSERT_EQ(1u, font->cachedLayoutCount());
+
+            const TextureFont::LayoutPtr other = font->layout(AttrString("abcd"));
+            ASSERT_NE(first, other);
+            ASSERT_EQ(2u, font->cachedLayoutCount());
+        }
+
+        TEST(TextureFontTest, layoutDifferentlyJustifiedStringsSeparately) {
+            std::unique_ptr<TextureFont> font = createFont();
+
+            AttrString left;
+            left.appendLeftJustified("a");
+            left.appendLeftJustified("abc");
+
+            AttrString right;
+            right.appendRightJustified("a");
+            right.appendRightJustified("abc");
+
+            const TextureFont::LayoutPtr leftLayout = font->layout(left);
+            const TextureFont::LayoutPtr rightLayout = font->layout(right);
+            ASSERT_NE(leftLayout, rightLayout);
+            ASSERT_NE(leftLayout->vertices, rightLayout->vertices);
+            ASSERT_EQ(2u, font->cachedLayoutCount());
+        }
+
+        TEST(TextureFontTest, clearFullCacheAndKeepReferencedLayouts) {
+            std::unique_ptr<TextureFont> font = createFont();
+
+            const TextureFont::LayoutPtr first = font->layout(AttrString("0"));
+            const Vec2f::List firstVertices = first->vertices;
+
+            // add layouts until the cache is full and is cleared to make room for the next one
+            size_t i = 1;
+            do {
+                font->layout(AttrString(std::to_string(i++)));
+            } while (font->cachedLayoutCount() > 1);
+
+            // the layout is still valid but is not returned anymore
+            ASSERT_EQ(firstVertices, first->vertices);
+            const TextureFont::LayoutPtr second = font->layout(AttrString("0"));
+            ASSERT_NE(first, second);
+            ASSERT_EQ(first->vertices, second->vertices);
+            ASSERT_EQ(2u, font->cachedLayoutCount());
+        }
+    }
+}
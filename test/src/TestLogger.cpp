@@ -0,0 +1,46 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestLogger.h"
+
+#include "CollectionUtils.h"
+
+namespace TrenchBroom {
+    size_t TestLogger::countMessages() const {
+        size_t result = 0;
+        for (const auto& entry : m_messageCounts)
+            result += entry.second;
+        return result;
+    }
+
+    size_t TestLogger::countMessages(const LogLevel level) const {
+        const auto it = m_messageCounts.find(level);
+        if (it == std::end(m_messageCounts))
+            return 0;
+        return it->second;
+    }
+
+    void TestLogger::doLog(const LogLevel level, const String& message) {
+        MapUtils::findOrInsert(m_messageCounts, level, 0u)->second++;
+    }
+
+    void TestLogger::doLog(const LogLevel level, const wxString& message) {
+        MapUtils::findOrInsert(m_messageCounts, level, 0u)->second++;
+    }
+}
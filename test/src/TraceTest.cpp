@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "Trace.h"
+
+#include <thread>
+
+namespace TrenchBroom {
+    TEST(TraceTest, writeEmptyTrace) {
+        Tracer tracer;
+
+        StringStream str;
+        tracer.writeJSON(str);
+
+        ASSERT_EQ(0u, tracer.eventCount());
+        ASSERT_EQ("{\"traceEvents\":[\n],\"displayTimeUnit\":\"ms\"}\n", str.str());
+    }
+
+    TEST(TraceTest, writeEvents) {
+        Tracer tracer;
+        tracer.record("first", "", 10, 25);
+        tracer.record("second", "a \"quoted\"\\path\n", 30, 31);
+
+        StringStream str;
+        tracer.writeJSON(str);
+
+        const String expected =
+        "{\"traceEvents\":[\n"
+        "{\"name\":\"first\",\"cat\":\"TrenchBroom\",\"ph\":\"X\",\"ts\":10,\"dur\":15,\"pid\":1,\"tid\":1},\n"
+        "{\"name\":\"second\",\"cat\":\"TrenchBroom\",\"ph\":\"X\",\"ts\":30,\"dur\":1,\"pid\":1,\"tid\":1,\"args\":{\"detail\":\"a \\\"quoted\\\"\\\\path\\n\"}}\n"
+        "],\"displayTimeUnit\":\"ms\"}\n";
+        ASSERT_EQ(expected, str.str());
+    }
+
+    TEST(TraceTest, recordMoreEventsThanFitIntoOneChunk) {
+        Tracer tracer;
+        for (size_t i = 0; i < 5000; ++i)
+            tracer.record("event", "", static_cast<Tracer::Timestamp>(i), static_cast<Tracer::Timestamp>(i + 1));
+        ASSERT_EQ(5000u, tracer.eventCount());
+    }
+
+    TEST(TraceTest, recordOnSeveralThreads) {
+        Tracer tracer;
+        tracer.record("main", "", 0, 1);
+
+        std::thread thread([&tracer]() {
+            for (size_t i = 0; i < 10; ++i)
+                tracer.record("worker", "", 0, 1);
+        });
+        thread.join();
+
+        ASSERT_EQ(11u, tracer.eventCount());
+
+        StringStream str;
+        tracer.writeJSON(str);
+        const String json = str.str();
+        ASSERT_NE(String::npos, json.find("\"name\":\"main\",\"cat\":\"TrenchBroom\",\"ph\":\"X\",\"ts\":0,\"dur\":1,\"pid\":1,\"tid\":1}"));
+        ASSERT_NE(String::npos, json.find("\"name\":\"worker\",\"cat\":\"TrenchBroom\",\"ph\":\"X\",\"ts\":0,\"dur\":1,\"pid\":1,\"tid\":2}"));
+    }
+
+    TEST(TraceTest, spansAreOnlyRecordedWhenEnabled) {
+        Tracer& tracer = Tracer::instance();
+        const size_t eventCount = tracer.eventCount();
+
+        {
+            const TraceSpan span("disabled");
+        }
+        ASSERT_EQ(eventCount, tracer.eventCount());
+
+        tracer.setEnabled(true);
+        {
+            const TraceSpan span("enabled", "detail");
+        }
+        tracer.setEnabled(false);
+        ASSERT_EQ(eventCount + 1, tracer.eventCount());
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "TestUtils.h"
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "View/HandleIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace View {
+        template <typename H>
+        static std::vector<H> findHandles(const HandleIndex<H>& index, const Ray3& ray, const FloatType radius) {
+            std::vector<H> result;
+            index.findHandles(ray, [radius](const BBox3& bounds) { return radius; }, [&result](const H& handle) { result.push_back(handle); });
+            return result;
+        }
+
+        TEST(HandleIndexTest, insertAndRemove) {
+            HandleIndex<Vec3> index(64.0);
+            ASSERT_TRUE(index.empty());
+
+            index.insert(Vec3(0.0, 0.0, 0.0));
+            index.insert(Vec3(1.0, 0.0, 0.0));
+            index.insert(Vec3(512.0, 0.0, 0.0));
+            ASSERT_EQ(3u, index.size());
+
+            ASSERT_TRUE(index.remove(Vec3(1.0, 0.0, 0.0)));
+            ASSERT_FALSE(index.remove(Vec3(1.0, 0.0, 0.0)));
+            ASSERT_FALSE(index.remove(Vec3(2.0, 0.0, 0.0)));
+            ASSERT_EQ(2u, index.size());
+
+            index.clear();
+            ASSERT_TRUE(index.empty());
+        }
+
+        TEST(HandleIndexTest, findHandlesInBounds) {
+            HandleIndex<Vec3> index(64.0);
+            for (int x = -512; x <= 512; x += 16)
+                index.insert(Vec3(x, 0.0, 0.0));
+            index.remove(Vec3(16.0, 0.0, 0.0));
+
+            std::vector<Vec3> result;
+            index.findHandles(BBox3(Vec3(-8.0, -8.0, -8.0), Vec3(40.0, 8.0, 8.0)), std::back_inserter(result));
+            std::sort(std::begin(result), std::end(result));
+
+            ASSERT_EQ(2u, result.size());
+            ASSERT_VEC_EQ(Vec3(0.0, 0.0, 0.0), result[0]);
+            ASSERT_VEC_EQ(Vec3(32.0, 0.0, 0.0), result[1]);
+        }
+
+        TEST(HandleIndexTest, findHandlesOnRay) {
+            HandleIndex<Vec3> index(64.0);
+            for (int x = -512; x <= 512; x += 16) {
+                for (int y = -512; y <= 512; y += 16)
+                    index.insert(Vec3(x, y, 0.0));
+            }
+
+            const Ray3 ray(Vec3(100.0, 100.0, 100.0), Vec3::NegZ);
+            const std::vector<Vec3> result = findHandles(index, ray, 4.0);
+
+            // only the handles of the cells near the ray are reported, but the handle closest to the ray is among them
+            ASSERT_LT(result.size(), index.size() / 16u);
+            ASSERT_TRUE(std::find(std::begin(result), std::end(result), Vec3(96.0, 96.0, 0.0)) != std::end(result));
+        }
+
+        TEST(HandleIndexTest, findEdgeHandlesOnRay) {
+            HandleIndex<Edge3> index(64.0);
+            const Edge3 longEdge(Vec3(-512.0, 0.0, 0.0), Vec3(512.0, 0.0, 0.0));
+            const Edge3 shortEdge(Vec3(-512.0, 256.0, 0.0), Vec3(-480.0, 256.0, 0.0));
+            index.insert(longEdge);
+            index.insert(shortEdge);
+
+            // the long edge is found even though the ray passes far from the cell containing its center
+            const Ray3 ray(Vec3(500.0, 2.0, 100.0), Vec3::NegZ);
+            const std::vector<Edge3> result = findHandles(index, ray, 4.0);
+            ASSERT_EQ(1u, result.size());
+            ASSERT_EQ(0, result.front().compare(longEdge));
+
+            ASSERT_TRUE(index.remove(longEdge));
+            ASSERT_TRUE(findHandles(index, ray, 4.0).empty());
+        }
+
+        TEST(HandleIndexTest, shrinkCellBoundsAfterRemoval) {
+            HandleIndex<Vec3> index(64.0);
+            for (int x = 0; x < 64; x += 4)
+                index.insert(Vec3(x, 0.0, 0.0));
+            for (int x = 4; x < 64; x += 4)
+                ASSERT_TRUE(index.remove(Vec3(x, 0.0, 0.0)));
+
+            std::vector<Vec3> result;
+            index.findHandles(BBox3(Vec3(32.0, -8.0, -8.0), Vec3(64.0, 8.0, 8.0)), std::back_inserter(result));
+            ASSERT_TRUE(result.empty());
+
+            // the remaining handle is not skipped by a ray that only passes close to it
+            const Ray3 ray(Vec3(2.0, 0.0, 100.0), Vec3::NegZ);
+            ASSERT_EQ(1u, findHandles(index, ray, 4.0).size());
+            ASSERT_TRUE(findHandles(index, Ray3(Vec3(48.0, 0.0, 100.0), Vec3::NegZ), 4.0).empty());
+        }
+
+        TEST(HandleIndexTest, findHandlesOnSlantedRays) {
+            HandleIndex<Vec3> index(64.0);
+            std::vector<Vec3> handles;
+            for (int x = -512; x <= 512; x += 48) {
+                for (int y = -512; y <= 512; y += 48) {
+                    for (int z = -256; z <= 256; z += 64) {
+                        handles.push_back(Vec3(x, y, z));
+                        index.insert(handles.back());
+                    }
+                }
+            }
+
+            const FloatType radius = 8.0;
+            const Ray3 rays[] = {
+                Ray3(Vec3(-1024.0, -1024.0, 512.0), Vec3(1.0, 1.0, -0.5).normalized()),
+                Ray3(Vec3(0.0, 0.0, 0.0), Vec3(-1.0, 0.25, 0.125).normalized()),
+                Ray3(Vec3(1000.0, 40.0, -300.0), Vec3(-1.0, 0.0, 0.0)),
+            };
+
+            // every handle that lies within the radius of a ray is found
+            for (const Ray3& ray : rays) {
+                const std::vector<Vec3> result = findHandles(index, ray, radius);
+                ASSERT_LT(result.size(), index.size());
+
+                for (const Vec3& handle : handles) {
+                    if (!Math::isnan(BBox3(handle, handle).expand(radius).intersectWithRay(ray))) {
+                        ASSERT_TRUE(std::find(std::begin(result), std::end(result), handle) != std::end(result));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "View/HandleMap.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST(HandleMapTest, findOrInsert) {
+            HandleMap<Vec3, size_t> map;
+            ASSERT_TRUE(map.empty());
+
+            map.findOrInsert(Vec3(0.0, 0.0, 0.0), 0).value++;
+            map.findOrInsert(Vec3(0.05, 0.0, 0.0), 0).value++;
+            map.findOrInsert(Vec3(1.0, 0.0, 0.0), 0).value++;
+
+            ASSERT_EQ(2u, map.size());
+            ASSERT_EQ(2u, map.find(Vec3(0.0, 0.0, 0.0))->value);
+            ASSERT_EQ(1u, map.find(Vec3(1.0, 0.0, 0.0))->value);
+            ASSERT_TRUE(map.find(Vec3(2.0, 0.0, 0.0)) == nullptr);
+        }
+
+        TEST(HandleMapTest, findAcrossCellBoundary) {
+            // the cell boundaries lie halfway between integers, so these handles end up in different cells
+            HandleMap<Vec3, size_t> map(0.1, 8.0);
+            map.findOrInsert(Vec3(3.46, 3.46, 0.0), 1);
+
+            ASSERT_TRUE(map.find(Vec3(3.54, 3.54, 0.0)) != nullptr);
+            ASSERT_TRUE(map.find(Vec3(3.54, 3.46, 0.0)) != nullptr);
+            ASSERT_TRUE(map.find(Vec3(3.6, 3.46, 0.0)) == nullptr);
+        }
+
+        TEST(HandleMapTest, findEdgesAndPolygons) {
+            HandleMap<Edge3, size_t> edges;
+            edges.findOrInsert(Edge3(Vec3(0.0, 0.0, 0.0), Vec3(64.0, 0.0, 0.0)), 1);
+            ASSERT_TRUE(edges.find(Edge3(Vec3(0.0, 0.05, 0.0), Vec3(64.0, 0.0, 0.05))) != nullptr);
+            ASSERT_TRUE(edges.find(Edge3(Vec3(0.0, 0.0, 0.0), Vec3(0.0, 64.0, 0.0))) == nullptr);
+
+            HandleMap<Polygon3, size_t> polygons;
+            const Polygon3 polygon { Vec3(0.0, 0.0, 0.0), Vec3(64.0, 0.0, 0.0), Vec3(64.0, 64.0, 0.0) };
+            polygons.findOrInsert(polygon, 1);
+            ASSERT_TRUE(polygons.find(polygon) != nullptr);
+            ASSERT_TRUE(polygons.find(Polygon3 { Vec3(0.0, 0.0, 0.0), Vec3(64.0, 0.0, 0.0) }) == nullptr);
+        }
+
+        TEST(HandleMapTest, erase) {
+            HandleMap<Vec3, size_t> map;
+            for (int x = 0; x < 64; ++x)
+                map.findOrInsert(Vec3(x, 0.0, 0.0), static_cast<size_t>(x));
+            ASSERT_EQ(64u, map.size());
+
+            ASSERT_TRUE(map.erase(Vec3(3.5, 0.0, 0.0)) == false);
+            ASSERT_TRUE(map.erase(Vec3(3.05, 0.0, 0.0)));
+            ASSERT_TRUE(map.find(Vec3(3.0, 0.0, 0.0)) == nullptr);
+            ASSERT_EQ(63u, map.size());
+
+            size_t sum = 0;
+            map.forEach([&sum](const HandleMap<Vec3, size_t>::Entry& entry) { sum += entry.value; });
+            ASSERT_EQ(63u * 64u / 2u - 3u, sum);
+
+            map.clear();
+            ASSERT_TRUE(map.empty());
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/HandleIndex.h"
+#include "View/Lasso.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace TrenchBroom {
+    namespace View {
+        static Vec3::List makeGrid(const FloatType z) {
+            Vec3::List points;
+            for (int x = -100; x < 100; x += 4) {
+                for (int y = -100; y < 100; y += 4)
+                    points.push_back(Vec3(x, y, z));
+            }
+            return points;
+        }
+        
+        TEST(LassoTest, selectPointsInOrthographicView) {
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::OrthographicCamera camera(1.0f, 8000.0f, viewport, Vec3f(0.0f, 0.0f, 1000.0f), Vec3f::NegZ, Vec3f::PosY);
+            
+            Lasso lasso(camera, 64.0, Vec3(-10.0, -10.0, 936.0));
+            lasso.update(Vec3(10.0, 10.0, 936.0));
+            
+            Vec3::List points = makeGrid(0.0);
+            VectorUtils::append(points, makeGrid(-500.0));
+            ASSERT_EQ(5000u, points.size());
+            
+            Vec3::List selected;
+            lasso.selected(std::begin(points), std::end(points), std::back_inserter(selected));
+            
+            Vec3::List expected;
+            for (const Vec3& point : points) {
+                if (std::abs(point.x()) < 10.0 && std::abs(point.y()) < 10.0)
+                    expected.push_back(point);
+            }
+            
+            ASSERT_EQ(50u, expected.size());
+            ASSERT_EQ(expected, selected);
+        }
+        
+        TEST(LassoTest, selectPointsInPerspectiveView) {
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, Vec3f(0.0f, 0.0f, 1000.0f), Vec3f::NegZ, Vec3f::PosY);
+            
+            Lasso lasso(camera, 64.0, Vec3(-10.0, -10.0, 936.0));
+            lasso.update(Vec3(10.0, 10.0, 936.0));
+            
+            Vec3::List points = makeGrid(0.0);
+            VectorUtils::append(points, makeGrid(500.0));
+            
+            Vec3::List selected;
+            lasso.selected(std::begin(points), std::end(points), std::back_inserter(selected));
+            
+            Vec3::List expected;
+            for (const Vec3& point : points) {
+                if (lasso.selects(point))
+                    expected.push_back(point);
+            }
+            
+            ASSERT_FALSE(expected.empty());
+            ASSERT_EQ(expected, selected);
+            
+            // points closer to the camera appear larger, so fewer of them are selected
+            ASSERT_TRUE(lasso.selects(Vec3(8.0, 8.0, 936.0)));
+            ASSERT_FALSE(lasso.selects(Vec3(8.0, 8.0, 968.0)));
+        }
+
+        static void assertBoundsContainSelection(const Lasso& lasso, const Vec3::List& points, const BBox3& extent) {
+            const BBox3 bounds = lasso.bounds(extent);
+            
+            HandleIndex<Vec3> index(64.0);
+            for (const Vec3& point : points)
+                index.insert(point);
+            
+            Vec3::List candidates;
+            index.findHandles(bounds, std::back_inserter(candidates));
+            ASSERT_LT(candidates.size(), points.size());
+            
+            Vec3::List expected;
+            for (const Vec3& point : points) {
+                if (lasso.selects(point)) {
+                    ASSERT_TRUE(bounds.contains(point));
+                    expected.push_back(point);
+                }
+            }
+            ASSERT_FALSE(expected.empty());
+            
+            Vec3::List selected;
+            lasso.selected(std::begin(candidates), std::end(candidates), std::back_inserter(selected));
+            
+            std::sort(std::begin(expected), std::end(expected));
+            std::sort(std::begin(selected), std::end(selected));
+            ASSERT_EQ(expected, selected);
+        }
+        
+        TEST(LassoTest, boundsInOrthographicView) {
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::OrthographicCamera camera(1.0f, 8000.0f, viewport, Vec3f(0.0f, 0.0f, 1000.0f), Vec3f::NegZ, Vec3f::PosY);
+            
+            Lasso lasso(camera, 64.0, Vec3(-10.0, -10.0, 936.0));
+            lasso.update(Vec3(10.0, 10.0, 936.0));
+            
+            const BBox3 extent(4096.0);
+            const BBox3 bounds = lasso.bounds(extent);
+            ASSERT_DOUBLE_EQ(-10.0, bounds.min.x());
+            ASSERT_DOUBLE_EQ( 10.0, bounds.max.x());
+            ASSERT_DOUBLE_EQ(-10.0, bounds.min.y());
+            ASSERT_DOUBLE_EQ( 10.0, bounds.max.y());
+            ASSERT_DOUBLE_EQ(extent.min.z(), bounds.min.z());
+            ASSERT_DOUBLE_EQ(extent.max.z(), bounds.max.z());
+            
+            Vec3::List points = makeGrid(0.0);
+            VectorUtils::append(points, makeGrid(-500.0));
+            assertBoundsContainSelection(lasso, points, extent);
+        }
+        
+        TEST(LassoTest, boundsInPerspectiveView) {
+            const Renderer::Camera::Viewport viewport(0, 0, 1024, 768);
+            const Renderer::PerspectiveCamera camera(90.0f, 1.0f, 8000.0f, viewport, Vec3f(0.0f, 0.0f, 1000.0f), Vec3f::NegZ, Vec3f::PosY);
+            
+            Lasso lasso(camera, 64.0, Vec3(-10.0, -10.0, 936.0));
+            lasso.update(Vec3(10.0, 10.0, 936.0));
+            
+            const BBox3 extent(4096.0);
+            const BBox3 bounds = lasso.bounds(extent);
+            
+            // everything in front of the camera
+            ASSERT_DOUBLE_EQ(1000.0, bounds.max.z());
+            
+            Vec3::List points = makeGrid(0.0);
+            VectorUtils::append(points, makeGrid(500.0));
+            VectorUtils::append(points, makeGrid(1500.0));
+            assertBoundsContainSelection(lasso, points, extent);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushGeometry.h"
+#include "Model/World.h"
+#include "View/MapDocumentTest.h"
+#include "View/MapDocument.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        class MoveBrushVerticesTest : public MapDocumentTest {};
+
+        // enough brushes to hand work to every worker thread when the new geometries are computed concurrently
+        static const size_t BrushCount = 64;
+
+        static Model::BrushList createBrushes(MapDocumentSPtr document, const Vec3& offset) {
+            Model::BrushBuilder builder(document->world(), document->worldBounds());
+
+            Model::BrushList brushes;
+            for (size_t i = 0; i < BrushCount; ++i) {
+                const Vec3 min = offset + Vec3(static_cast<FloatType>(i % 8) * 128.0, static_cast<FloatType>(i / 8) * 128.0, 0.0);
+                const Vec3 max = min + Vec3(64.0, 64.0, 64.0 + static_cast<FloatType>(i % 7));
+                Model::Brush* brush = builder.createCuboid(BBox3(min, max), "texture");
+                document->addNode(brush, document->currentParent());
+                brushes.push_back(brush);
+            }
+
+            document->select(Model::NodeList(std::begin(brushes), std::end(brushes)));
+            return brushes;
+        }
+
+        static Model::BrushList cloneBrushes(const Model::BrushList& brushes, const BBox3& worldBounds) {
+            Model::BrushList clones;
+            for (const Model::Brush* brush : brushes)
+                clones.push_back(brush->clone(worldBounds));
+            return clones;
+        }
+
+        static Vec3::List sorted(Vec3::List positions) {
+            std::sort(std::begin(positions), std::end(positions));
+            return positions;
+        }
+
+        /*
+         The expected geometries are built one brush at a time like the vertex operations of Model::Brush did before
+         they were split into a concurrent compute step and a serial apply step.
+         */
+        static Model::BrushGeometry moveVerticesSerially(const Model::Brush* brush, const Vec3& vertexPosition, const Vec3& delta) {
+            Model::BrushGeometry newGeometry;
+            for (const Model::BrushVertex* vertex : brush->vertices()) {
+                const Vec3& position = vertex->position();
+                if (position == vertexPosition)
+                    newGeometry.addPoint(position + delta);
+                else
+                    newGeometry.addPoint(position);
+            }
+            return newGeometry;
+        }
+
+        static Model::BrushGeometry snapVerticesSerially(const Model::Brush* brush, const size_t snapTo) {
+            const FloatType snapToF = static_cast<FloatType>(snapTo);
+            Model::BrushGeometry newGeometry;
+            for (const Model::BrushVertex* vertex : brush->vertices()) {
+                const Vec3& origin = vertex->position();
+                newGeometry.addPoint(snapToF * (origin / snapToF).rounded());
+            }
+            return newGeometry;
+        }
+
+        static void assertSameGeometries(const std::vector<Model::BrushGeometry>& expected, const Model::BrushList& actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(sorted(expected[i].vertexPositions()), sorted(actual[i]->vertexPositions()));
+                ASSERT_EQ(expected[i].bounds(), actual[i]->bounds());
+            }
+        }
+
+        static void assertSameGeometries(const Model::BrushList& expected, const Model::BrushList& actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(sorted(expected[i]->vertexPositions()), sorted(actual[i]->vertexPositions()));
+                ASSERT_EQ(expected[i]->bounds(), actual[i]->bounds());
+            }
+        }
+
+        TEST_F(MoveBrushVerticesTest, moveVerticesOfManyBrushes) {
+            const Model::BrushList brushes = createBrushes(document, Vec3(-1024.0, -1024.0, 0.0));
+            Model::BrushList original = cloneBrushes(brushes, document->worldBounds());
+            const Vec3 delta(0.0, 0.0, 16.0);
+
+            Model::VertexToBrushesMap vertices;
+            std::vector<Model::BrushGeometry> expected;
+            for (Model::Brush* brush : brushes) {
+                vertices[brush->bounds().max].insert(brush);
+                expected.push_back(moveVerticesSerially(brush, brush->bounds().max, delta));
+            }
+            ASSERT_EQ(BrushCount, vertices.size());
+
+            ASSERT_TRUE(document->moveVertices(vertices, delta).success);
+            assertSameGeometries(expected, brushes);
+
+            document->undoLastCommand();
+            assertSameGeometries(original, brushes);
+
+            VectorUtils::clearAndDelete(original);
+        }
+
+        TEST_F(MoveBrushVerticesTest, snapVerticesOfManyBrushes) {
+            const Model::BrushList brushes = createBrushes(document, Vec3(-1021.0, -1021.0, 3.0));
+            Model::BrushList original = cloneBrushes(brushes, document->worldBounds());
+
+            std::vector<Model::BrushGeometry> expected;
+            for (const Model::Brush* brush : brushes)
+                expected.push_back(snapVerticesSerially(brush, 16));
+
+            ASSERT_TRUE(document->snapVertices(16));
+            assertSameGeometries(expected, brushes);
+
+            document->undoLastCommand();
+            assertSameGeometries(original, brushes);
+
+            VectorUtils::clearAndDelete(original);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "View/NodeClipboardCache.h"
+
+namespace TrenchBroom {
+    namespace View {
+        TEST(NodeClipboardCacheTest, storeArrangesNodes) {
+            const BBox3 worldBounds(4096.0);
+            Assets::Texture texture("texture", 64, 64);
+            Model::World world(Model::MapFormat::Standard, nullptr, worldBounds);
+
+            const Model::BrushBuilder builder(&world, worldBounds);
+            Model::Brush* worldBrush = builder.createCube(64.0, "texture");
+            world.defaultLayer()->addChild(worldBrush);
+
+            Model::Entity* brushEntity = world.createEntity();
+            brushEntity->addOrUpdateAttribute("classname", "func_door");
+            world.defaultLayer()->addChild(brushEntity);
+
+            Model::Brush* entityBrush1 = builder.createCube(32.0, "texture");
+            Model::Brush* entityBrush2 = builder.createCube(16.0, "texture");
+            brushEntity->addChild(entityBrush1);
+            brushEntity->addChild(entityBrush2);
+
+            Model::Entity* pointEntity = world.createEntity();
+            pointEntity->addOrUpdateAttribute("classname", "light");
+            world.defaultLayer()->addChild(pointEntity);
+
+            for (Model::BrushFace* face : worldBrush->faces())
+                face->setTexture(&texture);
+
+            Model::NodeList nodes;
+            nodes.push_back(pointEntity);
+            nodes.push_back(entityBrush1);
+            nodes.push_back(worldBrush);
+
+            NodeClipboardCache cache;
+            ASSERT_FALSE(cache.contains("text"));
+
+            cache.store("text", nodes, worldBounds);
+            ASSERT_TRUE(cache.contains("text"));
+            ASSERT_FALSE(cache.contains("other text"));
+
+            const Model::NodeList clones = cache.cloneNodes(worldBounds);
+            ASSERT_EQ(3u, clones.size());
+
+            Model::Brush* worldBrushClone = dynamic_cast<Model::Brush*>(clones[0]);
+            ASSERT_TRUE(worldBrushClone != nullptr);
+            ASSERT_EQ(worldBrush->bounds(), worldBrushClone->bounds());
+            for (const Model::BrushFace* face : worldBrushClone->faces()) {
+                ASSERT_EQ("texture", face->textureName());
+                ASSERT_TRUE(face->texture() == nullptr);
+            }
+
+            Model::Entity* brushEntityClone = dynamic_cast<Model::Entity*>(clones[1]);
+            ASSERT_TRUE(brushEntityClone != nullptr);
+            ASSERT_EQ("func_door", brushEntityClone->classname());
+            ASSERT_EQ(1u, brushEntityClone->childCount());
+            ASSERT_EQ(entityBrush1->bounds(), brushEntityClone->children().front()->bounds());
+
+            Model::Entity* pointEntityClone = dynamic_cast<Model::Entity*>(clones[2]);
+            ASSERT_TRUE(pointEntityClone != nullptr);
+            ASSERT_EQ("light", pointEntityClone->classname());
+            ASSERT_FALSE(pointEntityClone->hasChildren());
+
+            const Model::NodeList otherClones = cache.cloneNodes(worldBounds);
+            ASSERT_EQ(clones.size(), otherClones.size());
+            for (size_t i = 0; i < clones.size(); ++i)
+                ASSERT_NE(clones[i], otherClones[i]);
+
+            VectorUtils::deleteAll(clones);
+            VectorUtils::deleteAll(otherClones);
+        }
+
+        TEST(NodeClipboardCacheTest, clear) {
+            const BBox3 worldBounds(4096.0);
+            Model::World world(Model::MapFormat::Standard, nullptr, worldBounds);
+
+            const Model::BrushBuilder builder(&world, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "texture");
+            world.defaultLayer()->addChild(brush);
+
+            NodeClipboardCache cache;
+            cache.store("text", Model::NodeList(1, brush), worldBounds);
+            ASSERT_TRUE(cache.contains("text"));
+
+            cache.clear();
+            ASSERT_FALSE(cache.contains("text"));
+            ASSERT_TRUE(cache.cloneNodes(worldBounds).empty());
+        }
+    }
+}